@@ -0,0 +1,189 @@
+#include <stdlib.h>
+
+#include "heap.h"
+
+// the initial capacity of a heap
+#define HEAP_CAPACITY 16
+
+struct heap {
+  // an array of items in heap order
+  void **items;
+  // the number of items
+  int size;
+  // the allocated number of items
+  int capacity;
+  // how to compare items
+  Comparator compare;
+};
+
+Heap *new_heap(Comparator compare) {
+  Heap *h = (Heap *) malloc(sizeof(Heap));
+
+  if (h == NULL) {
+    abort();
+  }
+
+  h->items = malloc(HEAP_CAPACITY * sizeof(void *));
+
+  if (h->items == NULL) {
+    abort();
+  }
+
+  h->size = 0;
+  h->capacity = HEAP_CAPACITY;
+  h->compare = compare;
+  return h;
+}
+
+void delete_heap(Heap *h) {
+  if (h == NULL) {
+    return;
+  }
+  free(h->items);
+  free(h);
+}
+
+// moves an item up until its parent is less
+static void __heap_sift_up(Heap *h, int index) {
+  void *item = h->items[index];
+
+  while (index > 0) {
+    int parent = (index - 1) / 2;
+
+    if (h->compare(h->items[parent], item) <= 0) {
+      break;
+    }
+
+    h->items[index] = h->items[parent];
+    index = parent;
+  }
+
+  h->items[index] = item;
+}
+
+// moves an item down until its children are greater
+static void __heap_sift_down(Heap *h, int index) {
+  void *item = h->items[index];
+
+  for (;;) {
+    int child = index * 2 + 1;
+
+    if (child >= h->size) {
+      break;
+    }
+
+    if (child + 1 < h->size && h->compare(h->items[child + 1], h->items[child]) < 0) {
+      child++;
+    }
+
+    if (h->compare(item, h->items[child]) <= 0) {
+      break;
+    }
+
+    h->items[index] = h->items[child];
+    index = child;
+  }
+
+  h->items[index] = item;
+}
+
+// grows the items to hold at least a size
+static void __heap_reserve(Heap *h, int size) {
+  if (size <= h->capacity) {
+    return;
+  }
+
+  int capacity = h->capacity;
+
+  while (capacity < size) {
+    capacity *= 2;
+  }
+
+  void **items = realloc(h->items, capacity * sizeof(void *));
+
+  if (items == NULL) {
+    abort();
+  }
+
+  h->items = items;
+  h->capacity = capacity;
+}
+
+int heap_push(Heap *h, void *item) {
+  if (h == NULL || item == NULL) {
+    return -1;
+  }
+
+  __heap_reserve(h, h->size + 1);
+
+  h->items[h->size] = item;
+
+  __heap_sift_up(h, h->size++);
+
+  return 0;
+}
+
+int heap_push_all(Heap *h, void **items, int count) {
+  if (h == NULL || items == NULL || count < 0) {
+    return -1;
+  }
+
+  for (int i = 0; i < count; i++) {
+    if (items[i] == NULL) {
+      return -1;
+    }
+  }
+
+  __heap_reserve(h, h->size + count);
+
+  // a few items are cheaper to sift up one at a time
+  if (count < h->size) {
+    for (int i = 0; i < count; i++) {
+      h->items[h->size] = items[i];
+      __heap_sift_up(h, h->size++);
+    }
+    return 0;
+  }
+
+  for (int i = 0; i < count; i++) {
+    h->items[h->size++] = items[i];
+  }
+
+  // otherwise sift down every parent, last first
+  for (int i = h->size / 2 - 1; i >= 0; i--) {
+    __heap_sift_down(h, i);
+  }
+
+  return 0;
+}
+
+void *heap_pop(Heap *h) {
+  if (h == NULL || h->size == 0) {
+    return NULL;
+  }
+
+  void *item = h->items[0];
+
+  if (--h->size > 0) {
+    h->items[0] = h->items[h->size];
+    __heap_sift_down(h, 0);
+  }
+
+  return item;
+}
+
+void *heap_peek(Heap *h) {
+  if (h == NULL || h->size == 0) {
+    return NULL;
+  }
+
+  return h->items[0];
+}
+
+int heap_is_empty(Heap *h) {
+  return h == NULL || h->size == 0;
+}
+
+int heap_size(Heap *h) {
+  return h == NULL ? 0 : h->size;
+}
@@ -0,0 +1,70 @@
+#ifndef RYJEN_OS_HEAP_H
+#define RYJEN_OS_HEAP_H
+
+#include "queue.h"
+
+typedef struct heap Heap;
+
+/**
+ * Allocates a new binary min heap
+ * @param Comparator how to compare contents (least is the top)
+ * @return the heap instance
+ */
+Heap *new_heap(Comparator);
+
+/**
+ * Destroys a heap instance
+ * @param Heap the heap instance
+ */
+void delete_heap(Heap *);
+
+/**
+ * Pushes a void onto the heap
+ * NOTE: O(log n)
+ * @param Heap the heap instance
+ * @param void the void instance
+ * @return 0 on success, -1 on error
+ */
+int heap_push(Heap *, void *);
+
+/**
+ * Pushes several voids onto the heap, rebuilding it bottom up when that
+ * is cheaper than pushing each
+ * NOTE: O(n + k) or O(k log n) for k voids
+ * @param Heap the heap instance
+ * @param void the array of void instances
+ * @param int the number of void instances
+ * @return 0 on success, -1 on error
+ */
+int heap_push_all(Heap *, void **, int);
+
+/**
+ * Pops the least void from the heap
+ * NOTE: O(log n)
+ * @param Heap the heap instance
+ * @return the void instance or NULL if empty
+ */
+void *heap_pop(Heap *);
+
+/**
+ * Peeks at the least void in the heap
+ * @param Heap the heap instance
+ * @return the void instance or NULL if empty
+ */
+void *heap_peek(Heap *);
+
+/**
+ * Tests if a heap is empty
+ * @param Heap the heap instance
+ * @return positive if true, 0 if false
+ */
+int heap_is_empty(Heap *);
+
+/**
+ * Gets the size of a heap
+ * @param Heap the heap instance
+ * @return the number of items in the heap
+ */
+int heap_size(Heap *);
+
+#endif
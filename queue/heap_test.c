@@ -0,0 +1,135 @@
+#include <stdlib.h>
+#include <stdio.h>
+
+#include "heap.h"
+
+static int __heap_test_compare(void *a, void *b) {
+  return *(int *) a - *(int *) b;
+}
+
+static int __heap_test_push_pop() {
+
+  Heap *h = new_heap(__heap_test_compare);
+
+  int values[] = { 5, 3, 9, 1, 7, 3, 8, 2, 6, 4 };
+  const int count = sizeof(values) / sizeof(values[0]);
+
+  for (int i = 0; i < count; i++) {
+    if (heap_push(h, &values[i])) {
+      delete_heap(h);
+      return 1;
+    }
+  }
+
+  if (heap_size(h) != count || *(int *) heap_peek(h) != 1) {
+    delete_heap(h);
+    return 1;
+  }
+
+  for (int i = 0, last = 0; i < count; i++) {
+    int *value = heap_pop(h);
+
+    if (value == NULL || *value < last) {
+      printf("expected at least %d got %d\n", last, value ? *value : -1);
+      delete_heap(h);
+      return 1;
+    }
+    last = *value;
+  }
+
+  if (!heap_is_empty(h) || heap_pop(h) != NULL) {
+    delete_heap(h);
+    return 1;
+  }
+
+  delete_heap(h);
+  return 0;
+}
+
+static int __heap_test_grow() {
+
+  Heap *h = new_heap(__heap_test_compare);
+
+  const int count = 1000;
+
+  int *values = malloc(count * sizeof(int));
+
+  // push in descending order to sift every item to the top
+  for (int i = 0; i < count; i++) {
+    values[i] = count - i;
+
+    if (heap_push(h, &values[i])) {
+      free(values);
+      delete_heap(h);
+      return 1;
+    }
+  }
+
+  for (int i = 1; i <= count; i++) {
+    int *value = heap_pop(h);
+
+    if (value == NULL || *value != i) {
+      printf("expected %d got %d\n", i, value ? *value : -1);
+      free(values);
+      delete_heap(h);
+      return 1;
+    }
+  }
+
+  free(values);
+  delete_heap(h);
+  return 0;
+}
+
+static int __heap_test_push_all() {
+
+  Heap *h = new_heap(__heap_test_compare);
+
+  int values[] = { 5, 3, 9, 1, 7, 3, 8, 2, 6, 4 };
+  const int count = sizeof(values) / sizeof(values[0]);
+
+  void *items[sizeof(values) / sizeof(values[0])];
+
+  for (int i = 0; i < count; i++) {
+    items[i] = &values[i];
+  }
+
+  // rebuilt when empty, then sifted up onto the larger heap
+  if (heap_push_all(h, items, count) || heap_push_all(h, items, 3) || heap_size(h) != count + 3) {
+    delete_heap(h);
+    return 1;
+  }
+
+  for (int i = 0, last = 0; i < count + 3; i++) {
+    int *value = heap_pop(h);
+
+    if (value == NULL || *value < last) {
+      printf("expected at least %d got %d\n", last, value ? *value : -1);
+      delete_heap(h);
+      return 1;
+    }
+    last = *value;
+  }
+
+  if (!heap_is_empty(h) || heap_push_all(h, items, 0)) {
+    delete_heap(h);
+    return 1;
+  }
+
+  delete_heap(h);
+  return 0;
+}
+
+int heap_test() {
+
+  int fail = __heap_test_push_pop();
+  printf("%-30s : %s\n", "heap_push_pop", fail ? "FAIL" : "PASS");
+
+  fail |= __heap_test_grow();
+  printf("%-30s : %s\n", "heap_grow", fail ? "FAIL" : "PASS");
+
+  fail |= __heap_test_push_all();
+  printf("%-30s : %s\n", "heap_push_all", fail ? "FAIL" : "PASS");
+
+  return fail;
+}
@@ -0,0 +1,404 @@
+#define _GNU_SOURCE
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#endif
+
+#include "queue.h"
+
+// the default largest queue
+#define BENCH_MAX_SIZE 10000000
+
+// the items a measurement works on, spread over many queues when they are small
+#define BENCH_WORK 1000000
+
+// the seed of the random inputs
+#define BENCH_SEED 1
+
+// the counters of one measurement
+typedef struct bench_counter {
+  // the file of the cache miss counter, -1 if unavailable
+  int fd;
+  // wall time in seconds
+  double seconds;
+  // cache misses, -1 if unavailable
+  long long misses;
+} BenchCounter;
+
+// the queues of one measurement, rounds of size items each
+typedef struct bench_queues {
+  Queue **queues;
+  int rounds;
+  int size;
+} BenchQueues;
+
+// the values pushed on the queues, never NULL
+#define BENCH_VALUE(i) ((void *) (intptr_t) ((i) + 1))
+
+static double __bench_now() {
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+
+  return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+// opens a cache miss counter of this thread, -1 where perf_event_open is unavailable
+static int __bench_open_counter() {
+#ifdef __linux__
+  struct perf_event_attr attr;
+
+  memset(&attr, 0, sizeof(attr));
+
+  attr.type = PERF_TYPE_HARDWARE;
+  attr.size = sizeof(attr);
+  attr.config = PERF_COUNT_HW_CACHE_MISSES;
+  attr.disabled = 1;
+  attr.exclude_kernel = 1;
+  attr.exclude_hv = 1;
+
+  return (int) syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+#else
+  return -1;
+#endif
+}
+
+static void __bench_start(BenchCounter *c) {
+#ifdef __linux__
+  if (c->fd != -1) {
+    ioctl(c->fd, PERF_EVENT_IOC_RESET, 0);
+    ioctl(c->fd, PERF_EVENT_IOC_ENABLE, 0);
+  }
+#endif
+  c->seconds = __bench_now();
+}
+
+static void __bench_stop(BenchCounter *c) {
+  c->seconds = __bench_now() - c->seconds;
+  c->misses = -1;
+
+#ifdef __linux__
+  long long misses;
+
+  if (c->fd != -1) {
+    ioctl(c->fd, PERF_EVENT_IOC_DISABLE, 0);
+
+    if (read(c->fd, &misses, sizeof(misses)) == sizeof(misses)) {
+      c->misses = misses;
+    }
+  }
+#endif
+}
+
+// creates empty queues for a size, enough of them to make the work measurable
+static void __bench_queues(BenchQueues *q, int size) {
+  q->size = size;
+  q->rounds = size < BENCH_WORK ? BENCH_WORK / size : 1;
+  q->queues = malloc((size_t) q->rounds * sizeof(Queue *));
+
+  if (q->queues == NULL) {
+    abort();
+  }
+
+  for (int i = 0; i < q->rounds; i++) {
+    q->queues[i] = new_queue();
+  }
+}
+
+// fills the queues with values by an order
+static void __bench_fill(BenchQueues *q, const char *order) {
+  int random = strcmp(order, "random") == 0;
+  int reverse = strcmp(order, "reverse") == 0;
+
+  for (int i = 0; i < q->rounds; i++) {
+    for (int j = 0; j < q->size; j++) {
+      int value = random ? rand() : reverse ? q->size - j : j;
+
+      if (queue_push_back(q->queues[i], BENCH_VALUE(value))) {
+        abort();
+      }
+    }
+  }
+}
+
+static void __bench_delete_queues(BenchQueues *q) {
+  for (int i = 0; i < q->rounds; i++) {
+    delete_queue_list(q->queues[i]);
+  }
+
+  free(q->queues);
+}
+
+// random indexes, one for each queue
+static int *__bench_indexes(BenchQueues *q) {
+  int *indexes = malloc((size_t) q->rounds * sizeof(int));
+
+  if (indexes == NULL) {
+    abort();
+  }
+
+  for (int i = 0; i < q->rounds; i++) {
+    indexes[i] = rand() % q->size;
+  }
+
+  return indexes;
+}
+
+static int __bench_compare(void *a, void *b) {
+  intptr_t x = (intptr_t) a;
+  intptr_t y = (intptr_t) b;
+
+  return (x > y) - (x < y);
+}
+
+static int __bench_visit(Queue *queue, int index, void *value, void *arg) {
+  (void) queue;
+  (void) index;
+
+  *(intptr_t *) arg += (intptr_t) value;
+
+  return QUEUE_ITERATE_NEXT;
+}
+
+// a benchmark measures one operation, returning the calls it made
+typedef long long (*OnBench)(BenchQueues *, BenchCounter *);
+
+static long long __bench_push_back(BenchQueues *q, BenchCounter *c) {
+  __bench_start(c);
+
+  for (int i = 0; i < q->rounds; i++) {
+    for (int j = 0; j < q->size; j++) {
+      queue_push_back(q->queues[i], BENCH_VALUE(j));
+    }
+  }
+
+  __bench_stop(c);
+
+  return (long long) q->rounds * q->size;
+}
+
+static long long __bench_push_front(BenchQueues *q, BenchCounter *c) {
+  __bench_start(c);
+
+  for (int i = 0; i < q->rounds; i++) {
+    for (int j = 0; j < q->size; j++) {
+      queue_push_front(q->queues[i], BENCH_VALUE(j));
+    }
+  }
+
+  __bench_stop(c);
+
+  return (long long) q->rounds * q->size;
+}
+
+static long long __bench_pop_front(BenchQueues *q, BenchCounter *c) {
+  __bench_fill(q, "sorted");
+  __bench_start(c);
+
+  for (int i = 0; i < q->rounds; i++) {
+    for (int j = 0; j < q->size; j++) {
+      queue_pop_front(q->queues[i]);
+    }
+  }
+
+  __bench_stop(c);
+
+  return (long long) q->rounds * q->size;
+}
+
+static long long __bench_pop_back(BenchQueues *q, BenchCounter *c) {
+  __bench_fill(q, "sorted");
+  __bench_start(c);
+
+  for (int i = 0; i < q->rounds; i++) {
+    for (int j = 0; j < q->size; j++) {
+      queue_pop_back(q->queues[i]);
+    }
+  }
+
+  __bench_stop(c);
+
+  return (long long) q->rounds * q->size;
+}
+
+static long long __bench_sort(BenchQueues *q, BenchCounter *c, const char *order) {
+  __bench_fill(q, order);
+  __bench_start(c);
+
+  for (int i = 0; i < q->rounds; i++) {
+    queue_sort(q->queues[i], __bench_compare);
+  }
+
+  __bench_stop(c);
+
+  return q->rounds;
+}
+
+static long long __bench_sort_random(BenchQueues *q, BenchCounter *c) {
+  return __bench_sort(q, c, "random");
+}
+
+static long long __bench_sort_sorted(BenchQueues *q, BenchCounter *c) {
+  return __bench_sort(q, c, "sorted");
+}
+
+static long long __bench_sort_reverse(BenchQueues *q, BenchCounter *c) {
+  return __bench_sort(q, c, "reverse");
+}
+
+static long long __bench_peek_at(BenchQueues *q, BenchCounter *c) {
+  __bench_fill(q, "sorted");
+
+  int *indexes = __bench_indexes(q);
+  intptr_t sum = 0;
+
+  __bench_start(c);
+
+  for (int i = 0; i < q->rounds; i++) {
+    sum += (intptr_t) queue_peek_at(q->queues[i], indexes[i]);
+  }
+
+  __bench_stop(c);
+
+  free(indexes);
+
+  // every index was in the queue
+  return sum >= q->rounds ? q->rounds : -1;
+}
+
+static long long __bench_remove_at(BenchQueues *q, BenchCounter *c) {
+  __bench_fill(q, "sorted");
+
+  int *indexes = __bench_indexes(q);
+  int removed = 0;
+
+  __bench_start(c);
+
+  for (int i = 0; i < q->rounds; i++) {
+    removed += queue_remove_at(q->queues[i], indexes[i]) != NULL;
+  }
+
+  __bench_stop(c);
+
+  free(indexes);
+
+  return removed == q->rounds ? q->rounds : -1;
+}
+
+static long long __bench_size(BenchQueues *q, BenchCounter *c) {
+  __bench_fill(q, "sorted");
+
+  long long total = 0;
+
+  __bench_start(c);
+
+  for (int i = 0; i < q->rounds; i++) {
+    total += queue_size(q->queues[i]);
+  }
+
+  __bench_stop(c);
+
+  return total == (long long) q->rounds * q->size ? q->rounds : -1;
+}
+
+static long long __bench_iterate(BenchQueues *q, BenchCounter *c) {
+  __bench_fill(q, "sorted");
+
+  intptr_t sum = 0;
+
+  __bench_start(c);
+
+  for (int i = 0; i < q->rounds; i++) {
+    queue_iterate(q->queues[i], __bench_visit, &sum);
+  }
+
+  __bench_stop(c);
+
+  return sum > 0 ? q->rounds : -1;
+}
+
+// the operations of queue.h
+static const struct {
+  const char *name;
+  OnBench run;
+} __bench_operations[] = {
+  { "push_back", __bench_push_back },
+  { "push_front", __bench_push_front },
+  { "pop_front", __bench_pop_front },
+  { "pop_back", __bench_pop_back },
+  { "sort_random", __bench_sort_random },
+  { "sort_sorted", __bench_sort_sorted },
+  { "sort_reverse", __bench_sort_reverse },
+  { "peek_at", __bench_peek_at },
+  { "remove_at", __bench_remove_at },
+  { "size", __bench_size },
+  { "iterate", __bench_iterate },
+};
+
+int main(int argc, char *argv[]) {
+
+  int max = BENCH_MAX_SIZE;
+
+  if (argc > 1) {
+    max = atoi(argv[1]);
+
+    if (max < 10) {
+      puts("invalid argument");
+      return 1;
+    }
+  }
+
+  BenchCounter counter;
+
+  counter.fd = __bench_open_counter();
+
+  if (counter.fd == -1) {
+    puts("perf_event_open is unavailable, cache misses are not counted");
+  }
+
+  printf("%-13s %10s %10s %14s %10s %14s\n", "Operation", "Size", "Calls", "ns/op", "ns/item", "misses/op");
+
+  srand(BENCH_SEED);
+
+  for (size_t i = 0; i < sizeof(__bench_operations) / sizeof(__bench_operations[0]); i++) {
+    for (long long size = 10; size <= max; size *= 10) {
+      BenchQueues queues;
+
+      __bench_queues(&queues, (int) size);
+
+      long long calls = __bench_operations[i].run(&queues, &counter);
+
+      __bench_delete_queues(&queues);
+
+      if (calls <= 0) {
+        printf("%s : wrong result at %lld\n", __bench_operations[i].name, size);
+        return 1;
+      }
+
+      double items = (double) queues.rounds * queues.size;
+
+      printf("%-13s %10lld %10lld %14.2f %10.2f", __bench_operations[i].name, size, calls,
+          counter.seconds * 1e9 / calls, counter.seconds * 1e9 / items);
+
+      if (counter.misses != -1) {
+        printf(" %14.2f\n", (double) counter.misses / calls);
+      } else {
+        printf(" %14s\n", "-");
+      }
+    }
+  }
+
+  if (counter.fd != -1) {
+    close(counter.fd);
+  }
+
+  return 0;
+}
@@ -179,6 +179,28 @@ int queue_push_back(Queue *list, void *p) {
   return 0;
 }
 
+int queue_concat(Queue *list, Queue *other) {
+  if (list == NULL || other == NULL || list == other) {
+    return -1;
+  }
+
+  if (other->first == NULL) {
+    return 0;
+  }
+
+  if (list->last != NULL) {
+    list->last->next = other->first;
+    other->first->prev = list->last;
+  } else {
+    list->first = other->first;
+  }
+
+  list->last = other->last;
+  other->first = NULL;
+  other->last = NULL;
+  return 0;
+}
+
 static int __queue_merge(Queue *result, Queue *left, Queue *right, Comparator compare) {
   if (left == NULL || right == NULL) {
     return -1;
@@ -217,12 +239,14 @@ static int __queue_merge_sort(Queue *list, Comparator comparator) {
 
   Queue *left = new_queue();
   Queue *right = new_queue();
+  int half = queue_size(list) / 2;
   int pos = 0;
 
+  // split in halves, keeping the order so equal items stay in place
   for (QueueItem *it = list->first, *next = NULL; it; it = next, pos++) {
     next = it->next;
     __queue_unlink(list, it);
-    if (pos % 2 == 0) {
+    if (pos < half) {
       __queue_append(left, it);
     } else {
       __queue_append(right, it); 
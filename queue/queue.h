@@ -49,6 +49,15 @@ int queue_push_back(Queue *, void *);
  */
 int queue_push_front(Queue *, void *);
 
+/**
+ * Moves all items of a queue onto the back of another queue
+ * NOTE: relinks the items in constant time
+ * @param Queue the destination queue instance
+ * @param Queue the source queue instance (left empty)
+ * @return 0 on success, -1 on error
+ */
+int queue_concat(Queue *, Queue *);
+
 /**
  * Pops a void from the front of a queue
  * @param Queue the queue instance
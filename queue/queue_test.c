@@ -257,6 +257,46 @@ static int __queue_test_sort() {
   return 0;
 }
 
+static int __queue_test_sort_stable() {
+
+  Queue *q = new_queue();
+
+  // equal items should keep their order
+  TestData *items[] = {
+    new_test_data("P2"), new_test_data("P1"), new_test_data("P2"),
+    new_test_data("P1"), new_test_data("P2"), new_test_data("P1")
+  };
+
+  TestData *expected[] = { items[1], items[3], items[5], items[0], items[2], items[4] };
+
+  for (int i = 0; i < 6; i++) {
+    if (queue_push_back(q, items[i]) == -1) {
+      return 1;
+    }
+  }
+
+  if (queue_sort(q, test_data_compare) == -1) {
+    return 1;
+  }
+
+  for (int i = 0; i < 6; i++) {
+    TestData *p = queue_pop_front(q);
+
+    if (p != expected[i]) {
+      printf("expected %s at %d got %s", test_data_id(expected[i]), i, test_data_id(p));
+      return 1;
+    }
+  }
+
+  for (int i = 0; i < 6; i++) {
+    free(items[i]);
+  }
+
+  delete_queue(q);
+
+  return 0;
+}
+
 int __queue_test_remove() {
 
   Queue *queue = new_queue();
@@ -292,6 +332,51 @@ int __queue_test_remove() {
   return 0;
 }
 
+static int __queue_test_concat() {
+
+  Queue *q1 = new_queue();
+  Queue *q2 = new_queue();
+
+  TestData *p1 = new_test_data("P1");
+  TestData *p2 = new_test_data("P2");
+  TestData *p3 = new_test_data("P3");
+
+  if (queue_push_back(q1, p1) || queue_push_back(q2, p2) || queue_push_back(q2, p3)) {
+    return 1;
+  }
+
+  if (queue_concat(q1, q2)) {
+    return 1;
+  }
+
+  if (queue_size(q1) != 3 || !queue_is_empty(q2)) {
+    printf("expected sizes 3 and 0 got %d and %d\n", queue_size(q1), queue_size(q2));
+    return 1;
+  }
+
+  if (queue_peek_front(q1) != p1 || queue_peek_back(q1) != p3) {
+    printf("expected %s to %s\n", test_data_id(p1), test_data_id(p3));
+    return 1;
+  }
+
+  // concat onto an empty queue
+  if (queue_concat(q2, q1) || queue_size(q2) != 3 || !queue_is_empty(q1)) {
+    return 1;
+  }
+
+  TestData *p = queue_pop_back(q2);
+
+  if (p != p3 || queue_peek_back(q2) != p2) {
+    printf("expected %s got %s\n", test_data_id(p3), test_data_id(p));
+    return 1;
+  }
+
+  delete_queue_list(q1);
+  delete_queue_list(q2);
+
+  return 0;
+}
+
 int queue_test() {
 
   int fail = __queue_test_push_back();
@@ -309,8 +394,14 @@ int queue_test() {
   fail |= __queue_test_sort();
   printf("%-30s : %s\n", "queue_sort", fail ? "FAIL" : "PASS");
 
+  fail |= __queue_test_sort_stable();
+  printf("%-30s : %s\n", "queue_sort_stable", fail ? "FAIL" : "PASS");
+
   fail |= __queue_test_remove();
   printf("%-30s : %s\n", "queue_remove", fail ? "FAIL" : "PASS");
 
+  fail |= __queue_test_concat();
+  printf("%-30s : %s\n", "queue_concat", fail ? "FAIL" : "PASS");
+
   return fail;
 }
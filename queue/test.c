@@ -2,9 +2,13 @@
 
 extern int queue_test();
 
+extern int heap_test();
+
 int main() {
 
   int failed = queue_test();
 
+  failed |= heap_test();
+
   return failed;
 }
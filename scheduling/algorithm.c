@@ -6,9 +6,13 @@
 
 struct algorithm {
   OnProcessArrive on_arrive;
+  OnProcessArriveBatch on_arrive_batch;
   OnProcessReady on_ready;
   OnProcessGet on_get;
   OnProcessPut on_put;
+  OnAlgorithmDelete on_delete;
+  OnProcessSlice on_slice;
+  OnSchedulerLoop loop;
   void *arg;
 };
 
@@ -20,9 +24,13 @@ Algorithm *new_algorithm(OnProcessArrive arrive, OnProcessReady ready, OnProcess
   }
 
   a->on_arrive = arrive;
+  a->on_arrive_batch = NULL;
   a->on_ready = ready;
   a->on_get = get;
   a->on_put = put;
+  a->on_delete = NULL;
+  a->on_slice = NULL;
+  a->loop = NULL;
   a->arg = data;
   return a;
 }
@@ -53,9 +61,61 @@ void delete_algorithm(Algorithm *a) {
     return;
   }
 
+  if (a->on_delete != NULL) {
+    a->on_delete(a->arg);
+  }
+
   free(a);
 }
 
+int algorithm_set_on_delete(Algorithm *a, OnAlgorithmDelete on_delete) {
+  if (a == NULL) {
+    return -1;
+  }
+
+  a->on_delete = on_delete;
+  return 0;
+}
+
+int algorithm_set_on_arrive_batch(Algorithm *a, OnProcessArriveBatch on_arrive_batch) {
+  if (a == NULL) {
+    return -1;
+  }
+
+  a->on_arrive_batch = on_arrive_batch;
+  return 0;
+}
+
+int algorithm_set_on_slice(Algorithm *a, OnProcessSlice on_slice) {
+  if (a == NULL) {
+    return -1;
+  }
+
+  a->on_slice = on_slice;
+  return 0;
+}
+
+int algorithm_set_loop(Algorithm *a, OnSchedulerLoop loop) {
+  if (a == NULL) {
+    return -1;
+  }
+
+  a->loop = loop;
+  return 0;
+}
+
+int algorithm_has_loop(Algorithm *a) {
+  return a != NULL && a->loop != NULL;
+}
+
+int algorithm_run_loop(Algorithm *a, Scheduler *sched) {
+  if (a == NULL || a->loop == NULL || sched == NULL) {
+    return -1;
+  }
+
+  return a->loop(sched, a->arg);
+}
+
 Process *algorithm_process_get(Algorithm *a) {
   if (a == NULL) {
     return NULL;
@@ -72,6 +132,25 @@ int algorithm_process_arrive(Algorithm *a, Process *p) {
   return a->on_arrive(p, a->arg);
 }
 
+int algorithm_process_arrive_batch(Algorithm *a, Process **batch, int n) {
+  if (a == NULL || batch == NULL || n < 0) {
+    return -1;
+  }
+
+  if (a->on_arrive_batch != NULL) {
+    return n == 0 ? 0 : a->on_arrive_batch(batch, n, a->arg);
+  }
+
+  // fall back to one at a time
+  for (int i = 0; i < n; i++) {
+    if (algorithm_process_arrive(a, batch[i])) {
+      return -1;
+    }
+  }
+
+  return 0;
+}
+
 int algorithm_process_put(Algorithm *a, Process *p) {
   if (a == NULL || p == NULL) {
     return -1;
@@ -88,3 +167,17 @@ int algorithm_process_ready(Algorithm *a) {
   return a->on_ready(a->arg);
 }
 
+int algorithm_process_slice(Algorithm *a, Process *p) {
+  if (a == NULL || p == NULL) {
+    return -1;
+  }
+
+  // without a callback the process is put back every tick
+  if (a->on_slice == NULL) {
+    return 1;
+  }
+
+  int ticks = a->on_slice(p, a->arg);
+
+  return ticks < 1 ? 1 : ticks;
+}
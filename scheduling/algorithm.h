@@ -10,9 +10,21 @@ typedef int (*OnProcessPut) (Process *, void *);
 // A callback to handle new arrivals
 typedef int (*OnProcessArrive) (Process *, void *);
 
+// A callback to handle several arrivals at once, in arrival order
+typedef int (*OnProcessArriveBatch) (Process **, int, void *);
+
 // A callback to determine if there is a process ready
 typedef int (*OnProcessReady) (void *);
 
+// A callback to destroy the data argument with the algorithm
+typedef void (*OnAlgorithmDelete) (void *);
+
+// A callback to get the ticks a process can run before it is put back
+typedef int (*OnProcessSlice) (Process *, void *);
+
+// A scheduler loop specialized for the algorithm (see scheduler_loop.h)
+typedef int (*OnSchedulerLoop) (Scheduler *, void *);
+
 /**
  * Allocates a new algorithm
  * @param OnProcessArrive callback for when a process arrives
@@ -38,6 +50,58 @@ Algorithm *new_queue_algorithm(Queue *queue, OnProcessGet, OnProcessPut);
  */
 void delete_algorithm(Algorithm *);
 
+/**
+ * Sets an optional callback to destroy the data argument when the algorithm is destroyed
+ * @param Algorithm the algorithm instance
+ * @param OnAlgorithmDelete callback to destroy the data argument
+ * @return 0 on success, -1 on error
+ */
+int algorithm_set_on_delete(Algorithm *, OnAlgorithmDelete);
+
+/**
+ * Sets an optional callback to handle the arrivals of a tick at once, so
+ * the algorithm can amortize its work.  It must leave the algorithm the
+ * same as the arrive callback for each process in order.
+ * @param Algorithm the algorithm instance
+ * @param OnProcessArriveBatch callback for several arrivals
+ * @return 0 on success, -1 on error
+ */
+int algorithm_set_on_arrive_batch(Algorithm *, OnProcessArriveBatch);
+
+/**
+ * Sets an optional callback for the ticks a process can run before it is
+ * put back.  The process must be put back the same way after that many
+ * ticks as after the same ticks one at a time, with no arrivals between.
+ * @param Algorithm the algorithm instance
+ * @param OnProcessSlice callback to get the ticks of a time slice
+ * @return 0 on success, -1 on error
+ */
+int algorithm_set_on_slice(Algorithm *, OnProcessSlice);
+
+/**
+ * Sets an optional scheduler loop with the algorithm callbacks inlined,
+ * used by scheduler_run_serial instead of calling through the algorithm
+ * @param Algorithm the algorithm instance
+ * @param OnSchedulerLoop the loop, defined with SCHEDULER_LOOP
+ * @return 0 on success, -1 on error
+ */
+int algorithm_set_loop(Algorithm *, OnSchedulerLoop);
+
+/**
+ * Tests if the algorithm has a specialized scheduler loop
+ * @param Algorithm the algorithm instance
+ * @return 1 if it has, 0 otherwise
+ */
+int algorithm_has_loop(Algorithm *);
+
+/**
+ * Runs the specialized scheduler loop of the algorithm
+ * @param Algorithm the algorithm instance
+ * @param Scheduler the scheduler to run
+ * @return 0 on success, -1 on error
+ */
+int algorithm_run_loop(Algorithm *, Scheduler *);
+
 /**
  * Gets a process from the algorithm for a time slice
  * @param Algorithm the algorithm instance
@@ -53,6 +117,16 @@ Process *algorithm_process_get(Algorithm *);
  */
 int algorithm_process_arrive(Algorithm *, Process *);
 
+/**
+ * determines what to do with several new arrivals, one at a time without
+ * a batch callback
+ * @param Algorithm the algorithm instance
+ * @param Process the process arrivals in arrival order
+ * @param int the number of arrivals
+ * @return 0 on success, -1 on error
+ */
+int algorithm_process_arrive_batch(Algorithm *, Process **, int);
+
 /**
  * puts a process back into queue after a time slice, handling premption if necessary
  * @param Algorithm the algorithm instance
@@ -68,5 +142,13 @@ int algorithm_process_put(Algorithm *, Process *);
  */
 int algorithm_process_ready(Algorithm*);
 
+/**
+ * gets the ticks a process just taken can run before it is put back
+ * @param Algorithm the algorithm instance
+ * @param Process the process taken
+ * @return the ticks, at least 1, or -1 on error
+ */
+int algorithm_process_slice(Algorithm *, Process *);
+
 #endif
 
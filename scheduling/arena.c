@@ -0,0 +1,110 @@
+#include <stdlib.h>
+#include <string.h>
+#include <stdalign.h>
+
+#include "arena.h"
+
+// a block of arena memory type
+typedef struct arena_block ArenaBlock;
+
+struct arena_block {
+  // the previous block, freed with this one
+  ArenaBlock *prev;
+  // the bytes of the block
+  size_t size;
+  // the bytes used
+  size_t used;
+  // the memory of the block
+  alignas(max_align_t) unsigned char data[];
+};
+
+struct arena {
+  // the block being allocated from
+  ArenaBlock *block;
+  // the size of the next block
+  size_t next;
+};
+
+// adds a block to the arena big enough for a size
+static ArenaBlock *__arena_grow(Arena *a, size_t size) {
+  while (a->next < size) {
+    a->next *= 2;
+  }
+
+  ArenaBlock *block = malloc(sizeof(ArenaBlock) + a->next);
+
+  if (block == NULL) {
+    abort();
+  }
+
+  block->prev = a->block;
+  block->size = a->next;
+  block->used = 0;
+
+  a->block = block;
+  a->next *= 2;
+  return block;
+}
+
+Arena *new_arena(size_t size) {
+  Arena *a = (Arena *) malloc(sizeof(Arena));
+
+  if (a == NULL) {
+    abort();
+  }
+
+  a->block = NULL;
+  a->next = size < sizeof(max_align_t) ? sizeof(max_align_t) : size;
+  return a;
+}
+
+void delete_arena(Arena *a) {
+  if (a == NULL) {
+    return;
+  }
+
+  while (a->block != NULL) {
+    ArenaBlock *prev = a->block->prev;
+    free(a->block);
+    a->block = prev;
+  }
+
+  free(a);
+}
+
+// takes memory from the current block, or a new one
+static void *__arena_take(Arena *a, size_t size, size_t align) {
+  ArenaBlock *block = a->block;
+
+  size_t offset = block == NULL ? 0 : (block->used + align - 1) & ~(align - 1);
+
+  if (block == NULL || offset > block->size || block->size - offset < size) {
+    block = __arena_grow(a, size);
+    offset = 0;
+  }
+
+  block->used = offset + size;
+  return block->data + offset;
+}
+
+void *arena_alloc(Arena *a, size_t size) {
+  if (a == NULL) {
+    return NULL;
+  }
+
+  return __arena_take(a, size, alignof(max_align_t));
+}
+
+char *arena_strdup(Arena *a, const char *s) {
+  if (a == NULL || s == NULL) {
+    return NULL;
+  }
+
+  size_t size = strlen(s) + 1;
+
+  // strings need no alignment
+  char *copy = __arena_take(a, size, 1);
+
+  memcpy(copy, s, size);
+  return copy;
+}
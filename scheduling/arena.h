@@ -0,0 +1,39 @@
+#ifndef RYJEN_OS_ARENA_H
+#define RYJEN_OS_ARENA_H
+
+#include <stddef.h>
+
+// An arena type
+typedef struct arena Arena;
+
+/**
+ * Allocates a new arena, memory that is only freed all at once
+ * @param size_t the size of the first block in bytes, later blocks double
+ * @return the arena instance
+ */
+Arena *new_arena(size_t);
+
+/**
+ * Destroys an arena instance and everything allocated from it
+ * @param Arena the arena instance
+ */
+void delete_arena(Arena *);
+
+/**
+ * Allocates memory from the arena, aligned for any type
+ * NOTE: O(1), the memory is not initialized
+ * @param Arena the arena instance
+ * @param size_t the size in bytes
+ * @return the memory, NULL on error
+ */
+void *arena_alloc(Arena *, size_t);
+
+/**
+ * Copies a string into the arena
+ * @param Arena the arena instance
+ * @param char* the string
+ * @return the copy, NULL on error
+ */
+char *arena_strdup(Arena *, const char *);
+
+#endif
@@ -0,0 +1,139 @@
+#include <stdlib.h>
+
+#include "bitmap.h"
+
+// bits per word
+#define BITMAP_WORD_BITS 64
+
+typedef unsigned long long BitmapWord;
+
+struct bitmap {
+  // a bit for each non-empty word
+  BitmapWord summary;
+  // the bit words
+  BitmapWord *words;
+  // the number of bits
+  int size;
+};
+
+// index of the lowest set bit in a non-zero word
+static int __bitmap_lowest(BitmapWord word) {
+#if defined(__GNUC__)
+  return __builtin_ctzll(word);
+#else
+  int index = 0;
+
+  while ((word & 1) == 0) {
+    word >>= 1;
+    index++;
+  }
+  return index;
+#endif
+}
+
+Bitmap *new_bitmap(int size) {
+  if (size <= 0 || size > BITMAP_MAX) {
+    return NULL;
+  }
+
+  Bitmap *b = (Bitmap *) malloc(sizeof(Bitmap));
+
+  if (b == NULL) {
+    abort();
+  }
+
+  b->words = calloc((size + BITMAP_WORD_BITS - 1) / BITMAP_WORD_BITS, sizeof(BitmapWord));
+
+  if (b->words == NULL) {
+    abort();
+  }
+
+  b->summary = 0;
+  b->size = size;
+  return b;
+}
+
+void delete_bitmap(Bitmap *b) {
+  if (b == NULL) {
+    return;
+  }
+
+  free(b->words);
+  free(b);
+}
+
+int bitmap_set(Bitmap *b, int index) {
+  if (b == NULL || index < 0 || index >= b->size) {
+    return -1;
+  }
+
+  int word = index / BITMAP_WORD_BITS;
+
+  b->words[word] |= 1ULL << (index % BITMAP_WORD_BITS);
+  b->summary |= 1ULL << word;
+  return 0;
+}
+
+int bitmap_clear(Bitmap *b, int index) {
+  if (b == NULL || index < 0 || index >= b->size) {
+    return -1;
+  }
+
+  int word = index / BITMAP_WORD_BITS;
+
+  b->words[word] &= ~(1ULL << (index % BITMAP_WORD_BITS));
+
+  // the word is empty, so clear its summary bit
+  if (b->words[word] == 0) {
+    b->summary &= ~(1ULL << word);
+  }
+  return 0;
+}
+
+int bitmap_test(Bitmap *b, int index) {
+  if (b == NULL || index < 0 || index >= b->size) {
+    return -1;
+  }
+
+  return (b->words[index / BITMAP_WORD_BITS] >> (index % BITMAP_WORD_BITS)) & 1;
+}
+
+int bitmap_first(Bitmap *b) {
+  if (b == NULL || b->summary == 0) {
+    return -1;
+  }
+
+  int word = __bitmap_lowest(b->summary);
+
+  return word * BITMAP_WORD_BITS + __bitmap_lowest(b->words[word]);
+}
+
+int bitmap_next(Bitmap *b, int index) {
+  if (b == NULL || index < 0 || index >= b->size) {
+    return -1;
+  }
+
+  int word = index / BITMAP_WORD_BITS;
+
+  // the remaining bits of the first word
+  BitmapWord bits = b->words[word] & (~0ULL << (index % BITMAP_WORD_BITS));
+
+  if (bits != 0) {
+    return word * BITMAP_WORD_BITS + __bitmap_lowest(bits);
+  }
+
+  // the following non-empty words from the summary
+  BitmapWord summary = word + 1 < BITMAP_WORD_BITS ? b->summary & (~0ULL << (word + 1)) : 0;
+
+  if (summary == 0) {
+    return -1;
+  }
+
+  word = __bitmap_lowest(summary);
+
+  return word * BITMAP_WORD_BITS + __bitmap_lowest(b->words[word]);
+}
+
+int bitmap_is_empty(Bitmap *b) {
+  return b == NULL || b->summary == 0;
+}
@@ -0,0 +1,71 @@
+
+#ifndef RYJEN_OS_BITMAP_H
+#define RYJEN_OS_BITMAP_H
+
+// A bitmap type
+typedef struct bitmap Bitmap;
+
+// the maximum number of bits in a bitmap
+#define BITMAP_MAX 4096
+
+/**
+ * Allocates a new bitmap with all bits cleared
+ * @param int the number of bits (1 to BITMAP_MAX)
+ * @return the bitmap instance or NULL if the size is invalid
+ */
+Bitmap *new_bitmap(int);
+
+/**
+ * Destroys a bitmap instance
+ * @param Bitmap the bitmap instance
+ */
+void delete_bitmap(Bitmap *);
+
+/**
+ * Sets a bit in the bitmap
+ * @param Bitmap the bitmap instance
+ * @param int the index of the bit
+ * @return 0 on success, -1 on error
+ */
+int bitmap_set(Bitmap *, int);
+
+/**
+ * Clears a bit in the bitmap
+ * @param Bitmap the bitmap instance
+ * @param int the index of the bit
+ * @return 0 on success, -1 on error
+ */
+int bitmap_clear(Bitmap *, int);
+
+/**
+ * Tests a bit in the bitmap
+ * @param Bitmap the bitmap instance
+ * @param int the index of the bit
+ * @return 1 if set, 0 if not set, -1 on error
+ */
+int bitmap_test(Bitmap *, int);
+
+/**
+ * Finds the lowest set bit in the bitmap.
+ * NOTE: constant time, uses a summary word over the bit words
+ * @param Bitmap the bitmap instance
+ * @return the index of the bit or -1 if no bits are set
+ */
+int bitmap_first(Bitmap *);
+
+/**
+ * Finds the lowest set bit at or after an index
+ * @param Bitmap the bitmap instance
+ * @param int the index to start from
+ * @return the index of the bit or -1 if no bits are set
+ */
+int bitmap_next(Bitmap *, int);
+
+/**
+ * Tests if no bits are set in the bitmap
+ * @param Bitmap the bitmap instance
+ * @return positive if true, 0 if false
+ */
+int bitmap_is_empty(Bitmap *);
+
+#endif
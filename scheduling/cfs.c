@@ -0,0 +1,614 @@
+#include <stdlib.h>
+#include <stdio.h>
+
+#include "types.h"
+#include "scheduler.h"
+#include "process.h"
+#include "algorithm.h"
+#include "policy.h"
+#include "loader.h"
+#include "scheduler_loop.h"
+
+// the weight of a nice 0 process
+#define CFS_NICE_0_LOAD 1024
+
+// virtual runtime units of a tick for a nice 0 process
+#define CFS_TICK_SCALE 1024LL
+
+// red-black tree colours
+#define CFS_RED   0
+#define CFS_BLACK 1
+
+// load weights for nice levels -20 to 19 (each level is ~10% of cpu)
+static const int __cfs_nice_to_weight[40] = {
+  88761, 71755, 56483, 46273, 36291,
+  29154, 23254, 18705, 14949, 11916,
+  9548,  7620,  6100,  4904,  3906,
+  3121,  2501,  1991,  1586,  1277,
+  1024,  820,   655,   526,   423,
+  335,   272,   215,   172,   137,
+  110,   87,    70,    56,    45,
+  36,    29,    23,    18,    15,
+};
+
+// a schedulable entity, also a node in the run queue tree
+typedef struct cfs_entity Entity;
+
+// a completely fair scheduler type
+typedef struct cfs CFS;
+
+struct cfs_entity {
+  // the process scheduled
+  Process *process;
+  // weighted time serviced
+  long long vruntime;
+  // the load weight from the nice level
+  int weight;
+  // arrival order, to break virtual runtime ties
+  unsigned long seq;
+  // tree links
+  Entity *left;
+  Entity *right;
+  Entity *parent;
+  int color;
+};
+
+struct cfs {
+  // the run queue ordered by virtual runtime
+  Entity *root;
+  // cached left most entity, the next to run
+  Entity *leftmost;
+  // the leaf sentinel
+  Entity nil;
+  // the entity given a time slice and not yet put back
+  Entity *current;
+  // the entity put back to continue its time slice
+  Entity *next;
+  // the process tick when the time slice was given
+  int mark;
+  // monotonic floor of the virtual runtimes
+  long long min_vruntime;
+  // total weight of runnable entities
+  long long load;
+  // number of runnable entities
+  int nr_running;
+  // ticks in which every runnable entity should run once
+  int latency;
+  // minimum ticks an entity runs before being prempted
+  int granularity;
+  // arrival counter
+  unsigned long seq;
+};
+
+CFS *new_cfs(int latency, int granularity) {
+  CFS *cfs = (CFS *) malloc(sizeof(CFS));
+
+  if (cfs == NULL) {
+    abort();
+  }
+
+  cfs->nil.process = NULL;
+  cfs->nil.left = cfs->nil.right = cfs->nil.parent = &cfs->nil;
+  cfs->nil.color = CFS_BLACK;
+  cfs->root = &cfs->nil;
+  cfs->leftmost = NULL;
+  cfs->current = NULL;
+  cfs->next = NULL;
+  cfs->mark = 0;
+  cfs->min_vruntime = 0;
+  cfs->load = 0;
+  cfs->nr_running = 0;
+  cfs->latency = latency;
+  cfs->granularity = granularity;
+  cfs->seq = 0;
+  return cfs;
+}
+
+static void __cfs_delete_tree(CFS *cfs, Entity *e) {
+  if (e == &cfs->nil) {
+    return;
+  }
+  __cfs_delete_tree(cfs, e->left);
+  __cfs_delete_tree(cfs, e->right);
+  free(e);
+}
+
+void delete_cfs(CFS *cfs) {
+  if (cfs == NULL) {
+    return;
+  }
+
+  __cfs_delete_tree(cfs, cfs->root);
+
+  free(cfs->current);
+  free(cfs->next);
+  free(cfs);
+}
+
+// the load weight for a process static priority
+static int __cfs_weight(Process *p) {
+  int nice = process_priority(p) - PROCESS_DEFAULT_PRIORITY;
+
+  if (nice < -20) {
+    nice = -20;
+  } else if (nice > 19) {
+    nice = 19;
+  }
+
+  return __cfs_nice_to_weight[nice + 20];
+}
+
+// orders entities by virtual runtime, then arrival
+static int __cfs_less(Entity *a, Entity *b) {
+  if (a->vruntime != b->vruntime) {
+    return a->vruntime < b->vruntime;
+  }
+  return a->seq < b->seq;
+}
+
+static void __cfs_rotate_left(CFS *cfs, Entity *x) {
+  Entity *y = x->right;
+
+  x->right = y->left;
+  if (y->left != &cfs->nil) {
+    y->left->parent = x;
+  }
+  y->parent = x->parent;
+  if (x->parent == &cfs->nil) {
+    cfs->root = y;
+  } else if (x == x->parent->left) {
+    x->parent->left = y;
+  } else {
+    x->parent->right = y;
+  }
+  y->left = x;
+  x->parent = y;
+}
+
+static void __cfs_rotate_right(CFS *cfs, Entity *x) {
+  Entity *y = x->left;
+
+  x->left = y->right;
+  if (y->right != &cfs->nil) {
+    y->right->parent = x;
+  }
+  y->parent = x->parent;
+  if (x->parent == &cfs->nil) {
+    cfs->root = y;
+  } else if (x == x->parent->right) {
+    x->parent->right = y;
+  } else {
+    x->parent->left = y;
+  }
+  y->right = x;
+  x->parent = y;
+}
+
+// inserts into the run queue, O(log n)
+static void __cfs_enqueue(CFS *cfs, Entity *z) {
+  Entity *y = &cfs->nil;
+  Entity *x = cfs->root;
+  int leftmost = 1;
+
+  while (x != &cfs->nil) {
+    y = x;
+    if (__cfs_less(z, x)) {
+      x = x->left;
+    } else {
+      x = x->right;
+      leftmost = 0;
+    }
+  }
+
+  z->parent = y;
+  z->left = z->right = &cfs->nil;
+  z->color = CFS_RED;
+
+  if (y == &cfs->nil) {
+    cfs->root = z;
+  } else if (__cfs_less(z, y)) {
+    y->left = z;
+  } else {
+    y->right = z;
+  }
+
+  // only went left, so the new entity is the left most
+  if (leftmost) {
+    cfs->leftmost = z;
+  }
+
+  // restore the red-black properties
+  while (z->parent->color == CFS_RED) {
+    Entity *gp = z->parent->parent;
+
+    if (z->parent == gp->left) {
+      Entity *uncle = gp->right;
+
+      if (uncle->color == CFS_RED) {
+        z->parent->color = CFS_BLACK;
+        uncle->color = CFS_BLACK;
+        gp->color = CFS_RED;
+        z = gp;
+        continue;
+      }
+      if (z == z->parent->right) {
+        z = z->parent;
+        __cfs_rotate_left(cfs, z);
+      }
+      z->parent->color = CFS_BLACK;
+      z->parent->parent->color = CFS_RED;
+      __cfs_rotate_right(cfs, z->parent->parent);
+    } else {
+      Entity *uncle = gp->left;
+
+      if (uncle->color == CFS_RED) {
+        z->parent->color = CFS_BLACK;
+        uncle->color = CFS_BLACK;
+        gp->color = CFS_RED;
+        z = gp;
+        continue;
+      }
+      if (z == z->parent->left) {
+        z = z->parent;
+        __cfs_rotate_right(cfs, z);
+      }
+      z->parent->color = CFS_BLACK;
+      z->parent->parent->color = CFS_RED;
+      __cfs_rotate_left(cfs, z->parent->parent);
+    }
+  }
+
+  cfs->root->color = CFS_BLACK;
+}
+
+static Entity *__cfs_minimum(CFS *cfs, Entity *x) {
+  while (x->left != &cfs->nil) {
+    x = x->left;
+  }
+  return x;
+}
+
+// replaces the subtree at u with the subtree at v
+static void __cfs_transplant(CFS *cfs, Entity *u, Entity *v) {
+  if (u->parent == &cfs->nil) {
+    cfs->root = v;
+  } else if (u == u->parent->left) {
+    u->parent->left = v;
+  } else {
+    u->parent->right = v;
+  }
+  v->parent = u->parent;
+}
+
+// removes from the run queue, O(log n)
+static void __cfs_dequeue(CFS *cfs, Entity *z) {
+
+  // keep the left most cached with the successor
+  if (cfs->leftmost == z) {
+    if (z->right != &cfs->nil) {
+      cfs->leftmost = __cfs_minimum(cfs, z->right);
+    } else {
+      cfs->leftmost = z->parent == &cfs->nil ? NULL : z->parent;
+    }
+  }
+
+  Entity *x = NULL;
+  Entity *y = z;
+  int color = y->color;
+
+  if (z->left == &cfs->nil) {
+    x = z->right;
+    __cfs_transplant(cfs, z, z->right);
+  } else if (z->right == &cfs->nil) {
+    x = z->left;
+    __cfs_transplant(cfs, z, z->left);
+  } else {
+    y = __cfs_minimum(cfs, z->right);
+    color = y->color;
+    x = y->right;
+    if (y->parent == z) {
+      x->parent = y;
+    } else {
+      __cfs_transplant(cfs, y, y->right);
+      y->right = z->right;
+      y->right->parent = y;
+    }
+    __cfs_transplant(cfs, z, y);
+    y->left = z->left;
+    y->left->parent = y;
+    y->color = z->color;
+  }
+
+  if (color == CFS_BLACK) {
+    // restore the red-black properties
+    while (x != cfs->root && x->color == CFS_BLACK) {
+      if (x == x->parent->left) {
+        Entity *w = x->parent->right;
+
+        if (w->color == CFS_RED) {
+          w->color = CFS_BLACK;
+          x->parent->color = CFS_RED;
+          __cfs_rotate_left(cfs, x->parent);
+          w = x->parent->right;
+        }
+        if (w->left->color == CFS_BLACK && w->right->color == CFS_BLACK) {
+          w->color = CFS_RED;
+          x = x->parent;
+          continue;
+        }
+        if (w->right->color == CFS_BLACK) {
+          w->left->color = CFS_BLACK;
+          w->color = CFS_RED;
+          __cfs_rotate_right(cfs, w);
+          w = x->parent->right;
+        }
+        w->color = x->parent->color;
+        x->parent->color = CFS_BLACK;
+        w->right->color = CFS_BLACK;
+        __cfs_rotate_left(cfs, x->parent);
+        x = cfs->root;
+      } else {
+        Entity *w = x->parent->left;
+
+        if (w->color == CFS_RED) {
+          w->color = CFS_BLACK;
+          x->parent->color = CFS_RED;
+          __cfs_rotate_right(cfs, x->parent);
+          w = x->parent->left;
+        }
+        if (w->right->color == CFS_BLACK && w->left->color == CFS_BLACK) {
+          w->color = CFS_RED;
+          x = x->parent;
+          continue;
+        }
+        if (w->left->color == CFS_BLACK) {
+          w->right->color = CFS_BLACK;
+          w->color = CFS_RED;
+          __cfs_rotate_left(cfs, w);
+          w = x->parent->left;
+        }
+        w->color = x->parent->color;
+        x->parent->color = CFS_BLACK;
+        w->left->color = CFS_BLACK;
+        __cfs_rotate_right(cfs, x->parent);
+        x = cfs->root;
+      }
+    }
+    x->color = CFS_BLACK;
+  }
+
+  // the sentinel parent may have been written
+  cfs->nil.parent = &cfs->nil;
+}
+
+// advances the floor of virtual runtimes, never backwards
+static void __cfs_update_min_vruntime(CFS *cfs, Entity *running) {
+  long long vruntime = cfs->min_vruntime;
+
+  if (running != NULL) {
+    vruntime = running->vruntime;
+  }
+
+  if (cfs->leftmost != NULL) {
+    if (running == NULL || cfs->leftmost->vruntime < vruntime) {
+      vruntime = cfs->leftmost->vruntime;
+    }
+  }
+
+  if (vruntime > cfs->min_vruntime) {
+    cfs->min_vruntime = vruntime;
+  }
+}
+
+// the ticks an entity may run in the scheduling period
+static int __cfs_slice(CFS *cfs, Entity *e) {
+  long long period = cfs->latency;
+
+  // stretch the period so every entity gets the minimum granularity
+  if ((long long) cfs->nr_running * cfs->granularity > period) {
+    period = (long long) cfs->nr_running * cfs->granularity;
+  }
+
+  long long slice = cfs->load > 0 ? period * e->weight / cfs->load : period;
+
+  return slice < cfs->granularity ? cfs->granularity : (int) slice;
+}
+
+// charges the time slice serviced to an entity
+static void __cfs_account(CFS *cfs, Entity *e) {
+  int ticks = process_current_tick(e->process) - cfs->mark;
+
+  e->vruntime += ticks * CFS_TICK_SCALE * CFS_NICE_0_LOAD / e->weight;
+
+  cfs->mark = process_current_tick(e->process);
+}
+
+static int __cfs_arrive(Process *p, void *arg) {
+  if (p == NULL || arg == NULL) {
+    return -1;
+  }
+
+  CFS *cfs = (CFS *) arg;
+
+  Entity *e = (Entity *) malloc(sizeof(Entity));
+
+  if (e == NULL) {
+    abort();
+  }
+
+  // start at the floor so new arrivals can't monopolize the cpu
+  e->process = p;
+  e->vruntime = cfs->min_vruntime;
+  e->weight = __cfs_weight(p);
+  e->seq = cfs->seq++;
+
+  cfs->nr_running++;
+  cfs->load += e->weight;
+
+  __cfs_enqueue(cfs, e);
+
+  return 0;
+}
+
+static int __cfs_ready(void *arg) {
+  if (arg == NULL) {
+    return -1;
+  }
+
+  CFS *cfs = (CFS *) arg;
+
+  return cfs->next != NULL || cfs->leftmost != NULL;
+}
+
+static Process *__cfs_get(void *arg) {
+  if (arg == NULL) {
+    return NULL;
+  }
+
+  CFS *cfs = (CFS *) arg;
+
+  // the last time slice was not put back, so the process completed
+  if (cfs->current != NULL) {
+    cfs->nr_running--;
+    cfs->load -= cfs->current->weight;
+    free(cfs->current);
+    cfs->current = NULL;
+  }
+
+  Entity *e = cfs->next;
+
+  cfs->next = NULL;
+
+  // a waiting entity is far enough behind to prempt the running one
+  if (e != NULL && cfs->leftmost != NULL
+      && e->vruntime - cfs->leftmost->vruntime > cfs->granularity * CFS_TICK_SCALE) {
+    if (process_prempt(e->process)) {
+      return NULL;
+    }
+    __cfs_enqueue(cfs, e);
+    e = NULL;
+  }
+
+  if (e == NULL) {
+    // the left most entity has run the least, O(1)
+    e = cfs->leftmost;
+
+    if (e == NULL) {
+      return NULL;
+    }
+
+    __cfs_dequeue(cfs, e);
+  }
+
+  cfs->current = e;
+  cfs->mark = process_current_tick(e->process);
+
+  return e->process;
+}
+
+static int __cfs_put(Process *p, void *arg) {
+  if (p == NULL || arg == NULL) {
+    return -1;
+  }
+
+  CFS *cfs = (CFS *) arg;
+
+  Entity *e = cfs->current;
+
+  if (e == NULL || e->process != p) {
+    return -1;
+  }
+
+  cfs->current = NULL;
+
+  __cfs_account(cfs, e);
+
+  __cfs_update_min_vruntime(cfs, e);
+
+  // the entity has not used its slice...
+  if (process_current_tick(p) < __cfs_slice(cfs, e)) {
+    // keep it running
+    cfs->next = e;
+    return 0;
+  }
+
+  // prempt
+  if (process_prempt(p)) {
+    return -1;
+  }
+
+  // and put back in the run queue
+  __cfs_enqueue(cfs, e);
+
+  return 0;
+}
+
+SCHEDULER_LOOP(__cfs_loop, __cfs_arrive, __cfs_ready, __cfs_get, __cfs_put, scheduler_loop_tick)
+
+// destroys the data with the algorithm
+static void __cfs_delete(void *arg) {
+  delete_cfs((CFS *) arg);
+}
+
+Algorithm *new_cfs_algorithm(int latency, int granularity) {
+  CFS *data = new_cfs(latency, granularity);
+
+  Algorithm *algo = new_algorithm(__cfs_arrive, __cfs_ready, __cfs_get, __cfs_put, data);
+
+  algorithm_set_on_delete(algo, __cfs_delete);
+
+  algorithm_set_loop(algo, __cfs_loop);
+
+  return algo;
+}
+
+#ifndef POLICY_LIBRARY
+
+int main(int argc, char *argv[]) {
+
+  // the workload file and switch cost, taken out of the arguments
+  LoaderOptions options;
+
+  if (loader_options(&argc, argv, &options)) {
+    puts("invalid argument");
+    return 1;
+  }
+
+  int latency = 6;
+  int granularity = 1;
+
+  if (argc > 1) {
+    latency = atoi(argv[1]);
+
+    if (argc > 2) {
+      granularity = atoi(argv[2]);
+    }
+  }
+
+  if (latency < 1 || granularity < 1) {
+    puts("invalid argument");
+    return 1;
+  }
+
+  // create the algorithm
+  Algorithm *algo = new_cfs_algorithm(latency, granularity);
+
+  // create the scheduler
+  Scheduler *sched = new_scheduler(algo);
+
+  // set the switch cost and read the processes
+  if (loader_setup(sched, &options)) {
+    delete_scheduler(sched);
+    return 1;
+  }
+
+  // run
+  int result = scheduler_run(sched);
+
+  // cleanup
+  delete_scheduler(sched);
+
+  return result;
+}
+
+#endif
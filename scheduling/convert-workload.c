@@ -0,0 +1,61 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "types.h"
+#include "process.h"
+#include "loader.h"
+#include "workload.h"
+
+// the bytes buffered before writing
+#define CONVERT_BUFFER (1 << 20)
+
+int main(int argc, char *argv[]) {
+
+  // write text rather than a binary workload
+  int text = 0;
+
+  int arg = 1;
+
+  if (arg < argc && strcmp(argv[arg], "-t") == 0) {
+    text = 1;
+    arg++;
+  }
+
+  if (argc - arg > 2) {
+    puts("usage: convert-workload [-t] [input] [output]");
+    return 1;
+  }
+
+  // standard input and output by default
+  const char *input = arg < argc ? argv[arg] : "-";
+  const char *output = arg + 1 < argc ? argv[arg + 1] : "-";
+
+  ProcessTable *t = new_process_table();
+
+  if (loader_read_table(t, input) == -1) {
+    delete_process_table(t);
+    return 1;
+  }
+
+  FILE *out = strcmp(output, "-") == 0 ? stdout : fopen(output, "wb");
+
+  if (out == NULL) {
+    printf("unable to open %s\n", output);
+    delete_process_table(t);
+    return 1;
+  }
+
+  setvbuf(out, NULL, _IOFBF, CONVERT_BUFFER);
+
+  int err = text ? workload_write_text(t, out) : workload_write(t, out);
+
+  if ((out == stdout ? fflush(out) : fclose(out)) != 0 || err) {
+    fprintf(stderr, "unable to write %s\n", output);
+    err = -1;
+  }
+
+  delete_process_table(t);
+
+  return err ? 1 : 0;
+}
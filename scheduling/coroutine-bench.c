@@ -0,0 +1,152 @@
+#define _POSIX_C_SOURCE 200809L
+#include <stdlib.h>
+#include <stdio.h>
+#include <time.h>
+
+#include "types.h"
+#include "process.h"
+#include "coroutine.h"
+
+// the default resumes of each measurement
+#define BENCH_SWITCHES 10000000
+
+// the coroutines created are this many times fewer than the resumes
+#define BENCH_CREATE_RATIO 10
+
+static double __bench_now() {
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+
+  return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+// yields forever, counting the resumes
+static void __bench_yield(Coroutine *co, void *arg) {
+  for (;;) {
+    (*(long long *) arg)++;
+    coroutine_yield(co);
+  }
+}
+
+// returns at once
+static void __bench_return(Coroutine *co, void *arg) {
+  (void) co;
+
+  (*(long long *) arg)++;
+}
+
+// polls forever, the timer is not ticking so it never yields
+static void __bench_poll(Coroutine *co, void *arg) {
+  long long *calls = (long long *) arg;
+
+  for (;;) {
+    if (coroutine_poll(co)) {
+      // only counts the polls that did not yield
+      return;
+    }
+
+    if (--*calls == 0) {
+      coroutine_yield(co);
+    }
+  }
+}
+
+static void __bench_print(const char *operation, long long calls, double seconds, long long expected,
+    long long actual) {
+  if (expected != actual) {
+    printf("%s : wrong result %lld for %lld\n", operation, actual, expected);
+    exit(1);
+  }
+
+  printf("%-12s %12lld %10.2f\n", operation, calls, seconds * 1e9 / calls);
+}
+
+int main(int argc, char *argv[]) {
+
+  long long switches = BENCH_SWITCHES;
+
+  if (argc > 1) {
+    switches = atoll(argv[1]);
+
+    if (switches < BENCH_CREATE_RATIO) {
+      puts("invalid argument");
+      return 1;
+    }
+  }
+
+  CoroutinePool *pool = new_coroutine_pool(0, 1);
+  long long count = 0;
+
+  printf("%-12s %12s %10s\n", "Operation", "Calls", "ns/op");
+
+  // a resume and a yield are two switches
+  Coroutine *co = new_coroutine(pool, __bench_yield, &count);
+
+  double start = __bench_now();
+
+  for (long long i = 0; i < switches; i++) {
+    coroutine_resume(co);
+  }
+
+  double seconds = __bench_now() - start;
+
+  delete_coroutine(co);
+
+  __bench_print("switch", switches * 2, seconds, switches, count);
+
+  // a stack from the warm pool, run to its return and given back
+  long long created = switches / BENCH_CREATE_RATIO;
+
+  count = 0;
+  start = __bench_now();
+
+  for (long long i = 0; i < created; i++) {
+    co = new_coroutine(pool, __bench_return, &count);
+
+    coroutine_resume(co);
+    delete_coroutine(co);
+  }
+
+  seconds = __bench_now() - start;
+
+  __bench_print("create", created, seconds, created, count);
+
+  // a poll of the timer that does not yield
+  count = switches;
+  co = new_coroutine(pool, __bench_poll, &count);
+
+  start = __bench_now();
+  coroutine_resume(co);
+  seconds = __bench_now() - start;
+
+  delete_coroutine(co);
+
+  __bench_print("poll", switches, seconds, 0, count);
+
+  // a tick of a process running a coroutine, through process_run
+  ProcessTable *table = new_process_table();
+  Process *p = process_table_new_process(table, "bench");
+
+  count = 0;
+  co = new_coroutine(pool, __bench_yield, &count);
+
+  process_set_service_time(p, 1);
+  process_set_work(p, coroutine_work, co);
+
+  start = __bench_now();
+
+  for (long long i = 0; i < switches; i++) {
+    process_run(p);
+  }
+
+  seconds = __bench_now() - start;
+
+  delete_coroutine(co);
+  delete_process_table(table);
+
+  __bench_print("tick", switches, seconds, switches, count);
+
+  delete_coroutine_pool(pool);
+  return 0;
+}
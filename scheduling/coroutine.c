@@ -0,0 +1,396 @@
+#define _GNU_SOURCE
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/mman.h>
+
+// the hand rolled switch, unless the portable one is asked for with COROUTINE_UCONTEXT
+#if defined(__GNUC__) && defined(__x86_64__) && defined(__ELF__) && !defined(COROUTINE_UCONTEXT)
+#define COROUTINE_X86
+#else
+#include <ucontext.h>
+#endif
+
+#include "types.h"
+#include "coroutine.h"
+
+struct coroutine {
+  // the pool the stack is given back to
+  CoroutinePool *pool;
+  // the body and its argument
+  CoroutineMain main;
+  void *arg;
+  // the lowest address of the stack, above its guard page
+  char *stack;
+#ifdef COROUTINE_X86
+  // the stack pointers saved by the last switch away from the coroutine and its caller
+  void *sp;
+  void *caller;
+#else
+  ucontext_t context;
+  ucontext_t caller;
+#endif
+  // the coroutine timer tick when it was last resumed
+  unsigned long epoch;
+  // whether the body returned
+  int done;
+  // whether the coroutine is running
+  int running;
+  // the next coroutine kept by the pool
+  Coroutine *next;
+};
+
+// the stacks of coroutines mapped at once
+#define COROUTINE_SLAB 64
+
+// a mapping of stacks and the coroutines running on them
+typedef struct coroutine_slab {
+  // the next slab of the pool
+  struct coroutine_slab *next;
+  // the mapping of the stacks
+  char *memory;
+  // the coroutines, each on its own stack in the mapping
+  Coroutine coroutines[COROUTINE_SLAB];
+} CoroutineSlab;
+
+struct coroutine_pool {
+  // the bytes of each stack, a multiple of the page
+  size_t stack_size;
+  // the bytes below each stack, a guard page or none
+  size_t guard;
+  // the slabs mapped
+  CoroutineSlab *slabs;
+  // the coroutines not taken, with their stacks
+  Coroutine *free;
+};
+
+// the ticks of the coroutine timer
+static atomic_ulong __coroutine_epoch;
+
+// whether the coroutine timer is ticking
+static atomic_int __coroutine_ticking;
+
+// the thread ticking the coroutine timer and its period in nanoseconds
+static pthread_t __coroutine_timer;
+static long __coroutine_period;
+
+static void __coroutine_main(Coroutine *);
+
+#ifdef COROUTINE_X86
+
+/**
+ * Switches to another stack, pushing the registers the System V ABI has
+ * the callee save on the stack left and popping them from the one
+ * switched to, about as cheap as a function call.  The signal mask and
+ * floating point control words are not switched.
+ */
+void __coroutine_switch(void **from, void *to);
+
+// the first return of a coroutine, calling the function in r13 with the coroutine in r12
+void __coroutine_start(void);
+
+__asm__(
+  ".pushsection .text\n"
+  ".p2align 4\n"
+  ".type __coroutine_switch, @function\n"
+  "__coroutine_switch:\n"
+  "  pushq %rbp\n"
+  "  pushq %rbx\n"
+  "  pushq %r12\n"
+  "  pushq %r13\n"
+  "  pushq %r14\n"
+  "  pushq %r15\n"
+  "  movq %rsp, (%rdi)\n"
+  "  movq %rsi, %rsp\n"
+  "  popq %r15\n"
+  "  popq %r14\n"
+  "  popq %r13\n"
+  "  popq %r12\n"
+  "  popq %rbx\n"
+  "  popq %rbp\n"
+  "  ret\n"
+  ".size __coroutine_switch, .-__coroutine_switch\n"
+  ".p2align 4\n"
+  ".type __coroutine_start, @function\n"
+  "__coroutine_start:\n"
+  "  movq %r12, %rdi\n"
+  "  callq *%r13\n"
+  "  ud2\n"
+  ".size __coroutine_start, .-__coroutine_start\n"
+  ".popsection\n"
+);
+
+// lays out a new stack as if the coroutine switched away just before __coroutine_start
+static void __coroutine_prepare(Coroutine *co) {
+  char *top = co->stack + co->pool->stack_size;
+
+  // the callee saved registers and the return address, so __coroutine_start calls with the stack aligned
+  uintptr_t *sp = (uintptr_t *) (top - 9 * sizeof(uintptr_t));
+
+  sp[0] = 0;
+  sp[1] = 0;
+  sp[2] = (uintptr_t) __coroutine_main;
+  sp[3] = (uintptr_t) co;
+  sp[4] = 0;
+  sp[5] = 0;
+  sp[6] = (uintptr_t) __coroutine_start;
+
+  co->sp = sp;
+}
+
+static void __coroutine_enter(Coroutine *co) {
+  __coroutine_switch(&co->caller, co->sp);
+}
+
+static void __coroutine_leave(Coroutine *co) {
+  __coroutine_switch(&co->sp, co->caller);
+}
+
+#else
+
+// the coroutine split into ints, all makecontext passes portably
+static void __coroutine_entry(unsigned int high, unsigned int low) {
+  __coroutine_main((Coroutine *) (uintptr_t) (((uint64_t) high << 32) | low));
+}
+
+static void __coroutine_prepare(Coroutine *co) {
+  uint64_t address = (uint64_t) (uintptr_t) co;
+
+  if (getcontext(&co->context)) {
+    abort();
+  }
+
+  co->context.uc_stack.ss_sp = co->stack;
+  co->context.uc_stack.ss_size = co->pool->stack_size;
+  co->context.uc_link = NULL;
+
+  makecontext(&co->context, (void (*)(void)) __coroutine_entry, 2, (unsigned int) (address >> 32),
+      (unsigned int) address);
+}
+
+static void __coroutine_enter(Coroutine *co) {
+  swapcontext(&co->caller, &co->context);
+}
+
+static void __coroutine_leave(Coroutine *co) {
+  swapcontext(&co->context, &co->caller);
+}
+
+#endif
+
+// runs the body of a coroutine, then returns to its caller for good
+static void __coroutine_main(Coroutine *co) {
+  co->main(co, co->arg);
+  co->done = 1;
+
+  __coroutine_leave(co);
+
+  // a coroutine that returned is never resumed
+  abort();
+}
+
+// maps a slab of stacks, adding its coroutines to the free ones of the pool
+static int __coroutine_pool_grow(CoroutinePool *pool) {
+  CoroutineSlab *slab = (CoroutineSlab *) malloc(sizeof(CoroutineSlab));
+
+  if (slab == NULL) {
+    abort();
+  }
+
+  size_t stride = pool->guard + pool->stack_size;
+  int flags = MAP_PRIVATE | MAP_ANONYMOUS;
+
+#ifdef MAP_STACK
+  flags |= MAP_STACK;
+#endif
+
+  slab->memory = mmap(NULL, stride * COROUTINE_SLAB, PROT_READ | PROT_WRITE, flags, -1, 0);
+
+  if (slab->memory == MAP_FAILED) {
+    free(slab);
+    return -1;
+  }
+
+  for (int i = 0; i < COROUTINE_SLAB; i++) {
+    Coroutine *co = &slab->coroutines[i];
+    char *base = slab->memory + stride * i;
+
+    // an overflow faults on the guard page rather than writing over the next stack
+    if (pool->guard > 0 && mprotect(base, pool->guard, PROT_NONE)) {
+      munmap(slab->memory, stride * COROUTINE_SLAB);
+      free(slab);
+      return -1;
+    }
+
+    co->pool = pool;
+    co->stack = base + pool->guard;
+    co->next = i + 1 < COROUTINE_SLAB ? &slab->coroutines[i + 1] : pool->free;
+  }
+
+  pool->free = &slab->coroutines[0];
+  slab->next = pool->slabs;
+  pool->slabs = slab;
+  return 0;
+}
+
+CoroutinePool *new_coroutine_pool(size_t stack_size, int guard) {
+  CoroutinePool *pool = (CoroutinePool *) malloc(sizeof(CoroutinePool));
+
+  if (pool == NULL) {
+    abort();
+  }
+
+  long page = sysconf(_SC_PAGESIZE);
+  size_t size = page > 0 ? (size_t) page : 4096;
+
+  pool->stack_size = stack_size == 0 ? COROUTINE_STACK_SIZE : stack_size;
+
+  // whole pages, so the top of each stack is aligned and its guard page on a page
+  pool->stack_size = (pool->stack_size + size - 1) / size * size;
+  pool->guard = guard ? size : 0;
+  pool->slabs = NULL;
+  pool->free = NULL;
+  return pool;
+}
+
+void delete_coroutine_pool(CoroutinePool *pool) {
+  if (pool == NULL) {
+    return;
+  }
+
+  while (pool->slabs != NULL) {
+    CoroutineSlab *slab = pool->slabs;
+
+    pool->slabs = slab->next;
+    munmap(slab->memory, (pool->guard + pool->stack_size) * COROUTINE_SLAB);
+    free(slab);
+  }
+
+  free(pool);
+}
+
+Coroutine *new_coroutine(CoroutinePool *pool, CoroutineMain main, void *arg) {
+  if (pool == NULL || main == NULL) {
+    return NULL;
+  }
+
+  if (pool->free == NULL && __coroutine_pool_grow(pool)) {
+    return NULL;
+  }
+
+  Coroutine *co = pool->free;
+
+  pool->free = co->next;
+  co->main = main;
+  co->arg = arg;
+  co->epoch = 0;
+  co->done = 0;
+  co->running = 0;
+  co->next = NULL;
+
+  __coroutine_prepare(co);
+
+  return co;
+}
+
+void delete_coroutine(Coroutine *co) {
+  if (co == NULL || co->running) {
+    return;
+  }
+
+  co->next = co->pool->free;
+  co->pool->free = co;
+}
+
+int coroutine_resume(Coroutine *co) {
+  if (co == NULL || co->done || co->running) {
+    return -1;
+  }
+
+  co->epoch = atomic_load_explicit(&__coroutine_epoch, memory_order_relaxed);
+  co->running = 1;
+
+  __coroutine_enter(co);
+
+  co->running = 0;
+
+  return !co->done;
+}
+
+void coroutine_yield(Coroutine *co) {
+  if (co == NULL || !co->running) {
+    return;
+  }
+
+  __coroutine_leave(co);
+}
+
+int coroutine_poll(Coroutine *co) {
+  if (co == NULL || atomic_load_explicit(&__coroutine_epoch, memory_order_relaxed) == co->epoch) {
+    return 0;
+  }
+
+  coroutine_yield(co);
+  return 1;
+}
+
+int coroutine_done(Coroutine *co) {
+  return co == NULL ? 1 : co->done;
+}
+
+int coroutine_work(Process *p, void *arg) {
+  (void) p;
+
+  return coroutine_resume((Coroutine *) arg);
+}
+
+// ticks the coroutine timer until it is stopped
+static void *__coroutine_tick(void *arg) {
+  (void) arg;
+
+  struct timespec ts;
+
+  ts.tv_sec = __coroutine_period / 1000000000L;
+  ts.tv_nsec = __coroutine_period % 1000000000L;
+
+  while (atomic_load(&__coroutine_ticking)) {
+    nanosleep(&ts, NULL);
+    atomic_fetch_add_explicit(&__coroutine_epoch, 1, memory_order_relaxed);
+  }
+
+  return NULL;
+}
+
+int coroutine_timer_start(long period) {
+  if (period < 1 || atomic_load(&__coroutine_ticking)) {
+    return -1;
+  }
+
+  __coroutine_period = period;
+  atomic_store(&__coroutine_ticking, 1);
+
+  int err = pthread_create(&__coroutine_timer, NULL, __coroutine_tick, NULL);
+
+  if (err) {
+    printf("%d : %s\n", err, "pthread_create");
+    atomic_store(&__coroutine_ticking, 0);
+    return -1;
+  }
+
+  return 0;
+}
+
+int coroutine_timer_stop() {
+  if (!atomic_load(&__coroutine_ticking)) {
+    return -1;
+  }
+
+  atomic_store(&__coroutine_ticking, 0);
+  pthread_join(__coroutine_timer, NULL);
+  return 0;
+}
@@ -0,0 +1,113 @@
+#ifndef RYJEN_OS_COROUTINE_H
+#define RYJEN_OS_COROUTINE_H
+
+#include <stddef.h>
+
+#include "types.h"
+
+// the default stack of a coroutine, not counting its guard page
+#define COROUTINE_STACK_SIZE (64 * 1024)
+
+/**
+ * The body of a coroutine, run on its own stack until it returns.  It
+ * suspends itself with coroutine_yield or coroutine_poll and continues
+ * where it left off when resumed.
+ * @param Coroutine the coroutine running
+ * @param void* the argument given to new_coroutine
+ */
+typedef void (*CoroutineMain)(Coroutine *, void *);
+
+/**
+ * Allocates a new pool of coroutine stacks.  Stacks are mapped in slabs
+ * and the stacks of deleted coroutines are kept for the next ones, so
+ * creating a coroutine does not map memory once the pool is warm.  A pool
+ * is used by one thread at a time, its coroutines can be resumed on any
+ * thread.
+ * @param size_t the bytes of each stack, 0 for COROUTINE_STACK_SIZE
+ * @param int 1 for a guard page below each stack, so an overflow faults,
+ *            0 for none when many coroutines live at once (each guard page
+ *            splits the mapping, see vm.max_map_count)
+ * @return the pool instance
+ */
+CoroutinePool *new_coroutine_pool(size_t, int);
+
+/**
+ * Destroys a pool instance and its stacks, with the coroutines still
+ * taken from it
+ * @param CoroutinePool the pool instance
+ */
+void delete_coroutine_pool(CoroutinePool *);
+
+/**
+ * Allocates a new coroutine with a stack from a pool.  It does not run
+ * until it is resumed.
+ * @param CoroutinePool the pool instance
+ * @param CoroutineMain the body of the coroutine
+ * @param void* the argument of the body
+ * @return the coroutine instance, NULL on error
+ */
+Coroutine *new_coroutine(CoroutinePool *, CoroutineMain, void *);
+
+/**
+ * Destroys a coroutine instance, giving its stack back to its pool.  A
+ * suspended coroutine is dropped where it yielded.
+ * @param Coroutine the coroutine instance
+ */
+void delete_coroutine(Coroutine *);
+
+/**
+ * Runs a coroutine until it yields or returns
+ * @param Coroutine the coroutine instance
+ * @return 1 if it yielded, 0 if it returned, -1 on error or if it already returned
+ */
+int coroutine_resume(Coroutine *);
+
+/**
+ * Suspends the running coroutine, returning to the caller of coroutine_resume
+ * @param Coroutine the coroutine running
+ */
+void coroutine_yield(Coroutine *);
+
+/**
+ * Suspends the running coroutine if the coroutine timer ticked since it
+ * was resumed, a cooperative interruption cheap enough to call in loops
+ * @param Coroutine the coroutine running
+ * @return 1 if it yielded, 0 otherwise
+ */
+int coroutine_poll(Coroutine *);
+
+/**
+ * Tests a coroutine returned from its body
+ * @param Coroutine the coroutine instance
+ * @return 1 if it returned, 0 otherwise
+ */
+int coroutine_done(Coroutine *);
+
+/**
+ * Runs one tick of a coroutine as the live work of a process (see
+ * process_set_work), so an algorithm taking the processor back after a
+ * tick suspends the coroutine in place and the next time slice resumes it
+ *
+ *   process_set_work(p, coroutine_work, new_coroutine(pool, body, arg));
+ *
+ * @param Process the process instance
+ * @param void* the coroutine
+ * @return 1 while the coroutine yields, 0 when it returned, -1 on error
+ */
+int coroutine_work(Process *, void *);
+
+/**
+ * Starts a thread ticking the coroutine timer at a period, so the
+ * coroutines calling coroutine_poll yield once per tick
+ * @param long the period in nanoseconds
+ * @return 0 on success, -1 on error or if the timer is running
+ */
+int coroutine_timer_start(long);
+
+/**
+ * Stops the coroutine timer
+ * @return 0 on success, -1 if the timer is not running
+ */
+int coroutine_timer_stop();
+
+#endif
@@ -0,0 +1,180 @@
+#include <stdlib.h>
+
+#include "types.h"
+#include "scheduler.h"
+#include "process.h"
+#include "heap.h"
+#include "algorithm.h"
+#include "policy.h"
+#include "loader.h"
+#include "scheduler_loop.h"
+
+// an earliest deadline first type
+typedef struct edf EDF;
+
+struct edf {
+  // waiting processes ordered by absolute deadline
+  Heap *heap;
+  // the process put back to continue
+  Process *current;
+};
+
+EDF *new_edf() {
+  EDF *edf = (EDF *) malloc(sizeof(EDF));
+
+  if (edf == NULL) {
+    abort();
+  }
+
+  edf->heap = new_heap(process_compare_deadlines);
+  edf->current = NULL;
+  return edf;
+}
+
+void delete_edf(EDF *edf) {
+  if (edf == NULL) {
+    return;
+  }
+
+  delete_heap(edf->heap);
+  free(edf);
+}
+
+static int __edf_arrive(Process *p, void *arg) {
+  if (p == NULL || arg == NULL) {
+    return -1;
+  }
+
+  EDF *edf = (EDF *) arg;
+
+  return heap_push(edf->heap, p);
+}
+
+static int __edf_arrive_batch(Process **batch, int n, void *arg) {
+  if (batch == NULL || arg == NULL) {
+    return -1;
+  }
+
+  EDF *edf = (EDF *) arg;
+
+  // heapify when the arrivals outnumber the waiting processes
+  return heap_push_all(edf->heap, (void **) batch, n);
+}
+
+static int __edf_ready(void *arg) {
+  if (arg == NULL) {
+    return -1;
+  }
+
+  EDF *edf = (EDF *) arg;
+
+  return edf->current != NULL || !heap_is_empty(edf->heap);
+}
+
+static Process *__edf_get(void *arg) {
+  if (arg == NULL) {
+    return NULL;
+  }
+
+  EDF *edf = (EDF *) arg;
+
+  Process *p = edf->current;
+
+  edf->current = NULL;
+
+  if (p == NULL) {
+    return heap_pop(edf->heap);
+  }
+
+  // an arrival has an earlier deadline...
+  if (!heap_is_empty(edf->heap) && process_compare_deadlines(heap_peek(edf->heap), p) < 0) {
+
+    // prempt
+    if (process_prempt(p) || heap_push(edf->heap, p)) {
+      return NULL;
+    }
+
+    return heap_pop(edf->heap);
+  }
+
+  // keep as current
+  return p;
+}
+
+static int __edf_put(Process *p, void *arg) {
+  if (p == NULL || arg == NULL) {
+    return -1;
+  }
+
+  EDF *edf = (EDF *) arg;
+
+  // keep as current until a earlier deadline arrives
+  edf->current = p;
+
+  return 0;
+}
+
+// only an arrival can have an earlier deadline, so run until then
+static int __edf_slice(Process *p, void *arg) {
+  (void) arg;
+
+  return process_current_service_time(p);
+}
+
+SCHEDULER_LOOP_BATCH(__edf_loop, __edf_arrive_batch, __edf_ready, __edf_get, __edf_put, __edf_slice)
+
+// destroys the data with the algorithm
+static void __edf_delete(void *arg) {
+  delete_edf((EDF *) arg);
+}
+
+Algorithm *new_edf_algorithm() {
+  EDF *data = new_edf();
+
+  Algorithm *algo = new_algorithm(__edf_arrive, __edf_ready, __edf_get, __edf_put, data);
+
+  algorithm_set_on_delete(algo, __edf_delete);
+
+  algorithm_set_on_arrive_batch(algo, __edf_arrive_batch);
+
+  algorithm_set_on_slice(algo, __edf_slice);
+
+  algorithm_set_loop(algo, __edf_loop);
+
+  return algo;
+}
+
+#ifndef POLICY_LIBRARY
+
+int main(int argc, char *argv[]) {
+
+  // the workload file and switch cost, taken out of the arguments
+  LoaderOptions options;
+
+  if (loader_options(&argc, argv, &options)) {
+    puts("invalid argument");
+    return 1;
+  }
+
+  // create the algorithm
+  Algorithm *algo = new_edf_algorithm();
+
+  // create the scheduler
+  Scheduler *sched = new_scheduler(algo);
+
+  // set the switch cost and read the processes
+  if (loader_setup(sched, &options)) {
+    delete_scheduler(sched);
+    return 1;
+  }
+
+  // run
+  int result = scheduler_run(sched);
+
+  // cleanup
+  delete_scheduler(sched);
+
+  return result;
+}
+
+#endif
@@ -0,0 +1,278 @@
+#define _POSIX_C_SOURCE 200809L
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <pthread.h>
+#include <unistd.h>
+
+#include "types.h"
+#include "process.h"
+#include "algorithm.h"
+#include "policy.h"
+#include "executor.h"
+#include "coroutine.h"
+
+// the default number of tasks
+#define BENCH_TASKS 100000
+
+// the default number of workers
+#define BENCH_WORKERS 4
+
+// the most workers
+#define BENCH_MAX_WORKERS 256
+
+// the stack of each coroutine task, only the pages touched are resident
+#define BENCH_STACK_SIZE (16 * 1024)
+
+// the default iterations of work each tick
+#define BENCH_UNITS 1000
+
+// the seed of the workload
+#define BENCH_SEED 1
+
+// one task in this many is long, the rest are short
+#define BENCH_LONG_EVERY 20
+
+// the ticks of the short and the long tasks
+#define BENCH_SHORT_TICKS 4
+#define BENCH_LONG_TICKS 200
+
+// the state of a task, a hash worked on one bounded unit each tick
+typedef struct bench_task {
+  // the ticks of work left
+  int ticks;
+  // the iterations of each tick
+  int units;
+  // the hash so far
+  uint64_t value;
+  // the coroutine running the task, NULL until it starts or with -c unset
+  Coroutine *co;
+} BenchTask;
+
+// the coroutine stacks of the worker, a pool is used by one thread
+static _Thread_local CoroutinePool *__bench_pool = NULL;
+
+// the pools of every worker, deleted after the run
+static CoroutinePool *__bench_pools[BENCH_MAX_WORKERS];
+static int __bench_pools_size = 0;
+static pthread_mutex_t __bench_pools_lock = PTHREAD_MUTEX_INITIALIZER;
+
+static Algorithm *__bench_fcfs(void *arg) {
+  (void) arg;
+  return new_fcfs_algorithm();
+}
+
+static Algorithm *__bench_rr(void *arg) {
+  (void) arg;
+  return new_rr_algorithm(3);
+}
+
+static Algorithm *__bench_mlfq(void *arg) {
+  (void) arg;
+  return new_mlfq_algorithm(3, 3, 0);
+}
+
+// the policies each worker can run, not the ones sorting their whole queue on each get
+static const struct {
+  const char *name;
+  OnExecutorAlgorithm create;
+} __bench_policies[] = {
+  { "fcfs", __bench_fcfs },
+  { "rr", __bench_rr },
+  { "mlfq", __bench_mlfq },
+};
+
+// one bounded unit of work of a task, a fixed number of xorshift rounds
+static void __bench_hash(BenchTask *task) {
+  uint64_t x = task->value;
+
+  for (int i = 0; i < task->units; i++) {
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+  }
+
+  task->value = x;
+}
+
+// one tick of a task, returning to the worker after each unit
+static int __bench_work(Process *p, void *arg) {
+  (void) p;
+
+  BenchTask *task = (BenchTask *) arg;
+
+  __bench_hash(task);
+
+  return --task->ticks > 0;
+}
+
+// a task written as one loop, suspended in place at each tick boundary
+static void __bench_body(Coroutine *co, void *arg) {
+  BenchTask *task = (BenchTask *) arg;
+
+  for (;;) {
+    __bench_hash(task);
+
+    if (--task->ticks == 0) {
+      return;
+    }
+
+    coroutine_yield(co);
+  }
+}
+
+// the pool of the calling worker, made on its first task
+static CoroutinePool *__bench_worker_pool() {
+  if (__bench_pool == NULL) {
+    // no guard pages, every task of a round robin worker can be suspended at once
+    __bench_pool = new_coroutine_pool(BENCH_STACK_SIZE, 0);
+
+    pthread_mutex_lock(&__bench_pools_lock);
+    __bench_pools[__bench_pools_size++] = __bench_pool;
+    pthread_mutex_unlock(&__bench_pools_lock);
+  }
+
+  return __bench_pool;
+}
+
+// one tick of a task running as a coroutine, started on the worker it was given to
+static int __bench_coroutine_work(Process *p, void *arg) {
+  BenchTask *task = (BenchTask *) arg;
+
+  if (task->co == NULL && (task->co = new_coroutine(__bench_worker_pool(), __bench_body, task)) == NULL) {
+    return -1;
+  }
+
+  int more = coroutine_work(p, task->co);
+
+  if (more == 0) {
+    delete_coroutine(task->co);
+    task->co = NULL;
+  }
+
+  return more;
+}
+
+static void __bench_delete_pools() {
+  for (int i = 0; i < __bench_pools_size; i++) {
+    delete_coroutine_pool(__bench_pools[i]);
+  }
+
+  __bench_pools_size = 0;
+}
+
+// runs the tasks with a policy, 0 on success
+static int __bench_run(OnExecutorAlgorithm create, int workers, ProcessWork work, BenchTask *tasks, int size,
+    int units, ExecutorStats *stats) {
+  Executor *e = new_executor(create, NULL, workers, size);
+
+  if (e == NULL) {
+    return -1;
+  }
+
+  srand(BENCH_SEED);
+
+  for (int i = 0; i < size; i++) {
+    tasks[i].ticks = rand() % BENCH_LONG_EVERY == 0 ? BENCH_LONG_TICKS : 1 + rand() % BENCH_SHORT_TICKS;
+    tasks[i].units = units;
+    tasks[i].value = (uint64_t) i + 1;
+    tasks[i].co = NULL;
+  }
+
+  if (executor_start(e)) {
+    delete_executor(e);
+    return -1;
+  }
+
+  // every task arrives at once, so the latencies include waiting behind the others
+  for (int i = 0; i < size; i++) {
+    if (executor_submit(e, NULL, work, &tasks[i], tasks[i].ticks) == NULL) {
+      delete_executor(e);
+      return -1;
+    }
+  }
+
+  int err = executor_wait(e) || executor_stop(e) || executor_stats(e, stats);
+
+  delete_executor(e);
+
+  // the workers stopped, so their pools are no longer used
+  __bench_delete_pools();
+
+  return err ? -1 : 0;
+}
+
+static void __bench_usage() {
+  puts("usage: executor-bench [-n tasks] [-w workers] [-u units] [-c] [policy...]");
+}
+
+int main(int argc, char *argv[]) {
+
+  int size = BENCH_TASKS;
+  int workers = BENCH_WORKERS;
+  int units = BENCH_UNITS;
+  ProcessWork work = __bench_work;
+  int opt;
+
+  while ((opt = getopt(argc, argv, "n:w:u:c")) != -1) {
+    switch (opt) {
+      case 'n':
+        size = atoi(optarg);
+        break;
+      case 'w':
+        workers = atoi(optarg);
+        break;
+      case 'u':
+        units = atoi(optarg);
+        break;
+      case 'c':
+        work = __bench_coroutine_work;
+        break;
+      default:
+        __bench_usage();
+        return 1;
+    }
+  }
+
+  if (size < 1 || workers < 1 || workers > BENCH_MAX_WORKERS || units < 1) {
+    puts("invalid argument");
+    return 1;
+  }
+
+  BenchTask *tasks = malloc((size_t) size * sizeof(BenchTask));
+
+  if (tasks == NULL) {
+    abort();
+  }
+
+  printf("%-8s %8s %10s %12s %12s %10s %10s %10s %10s\n", "Policy", "Workers", "Tasks", "Ticks", "Tasks/s",
+      "p50 us", "p99 us", "p99.9 us", "max us");
+
+  for (size_t i = 0; i < sizeof(__bench_policies) / sizeof(__bench_policies[0]); i++) {
+    int chosen = optind == argc;
+
+    for (int j = optind; j < argc; j++) {
+      chosen |= strcmp(argv[j], __bench_policies[i].name) == 0;
+    }
+
+    if (!chosen) {
+      continue;
+    }
+
+    ExecutorStats stats;
+
+    if (__bench_run(__bench_policies[i].create, workers, work, tasks, size, units, &stats)) {
+      printf("%s : unable to run\n", __bench_policies[i].name);
+      free(tasks);
+      return 1;
+    }
+
+    printf("%-8s %8d %10lld %12lld %12.0f %10.1f %10.1f %10.1f %10.1f\n", __bench_policies[i].name, workers,
+        stats.tasks, stats.ticks, stats.tasks_per_second, stats.p50 / 1e3, stats.p99 / 1e3, stats.p999 / 1e3,
+        stats.max / 1e3);
+  }
+
+  free(tasks);
+  return 0;
+}
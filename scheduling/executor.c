@@ -0,0 +1,506 @@
+#define _GNU_SOURCE
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <pthread.h>
+#include <unistd.h>
+
+#ifdef __linux__
+#include <sched.h>
+#endif
+
+#include "types.h"
+#include "executor.h"
+#include "process.h"
+#include "algorithm.h"
+#include "profile.h"
+
+// a thread running the tasks given to it on one core
+typedef struct executor_worker {
+  // the executor of the worker
+  Executor *executor;
+  // the index of the worker, the core it is pinned to
+  int index;
+  // decides which task of the worker runs next
+  Algorithm *algorithm;
+  // the thread of the worker
+  pthread_t thread;
+  // guards the algorithm, the tick and stopping
+  pthread_mutex_t lock;
+  // signalled when a task arrives or the worker stops
+  pthread_cond_t ready;
+  // the ticks of work the worker ran, its clock
+  int tick;
+  // whether the worker stops once it has no task left
+  int stopping;
+  // the estimated ticks of the tasks given to the worker and not completed, guarded by the executor lock
+  long long load;
+} ExecutorWorker;
+
+struct executor {
+  // the workers
+  ExecutorWorker *workers;
+  // the number of workers
+  int size;
+  // whether the worker threads were started
+  int started;
+
+  // guards the tasks, the counts and the times
+  pthread_mutex_t lock;
+  // signalled when every task submitted completed or one failed
+  pthread_cond_t done;
+  // the processes of the tasks
+  ProcessTable *tasks;
+  // the most tasks the table holds without moving its columns
+  int capacity;
+  // the worker the search for the least loaded starts from, so equal loads take turns
+  int next;
+  // whether no more tasks are taken
+  int stopped;
+  // the tasks submitted and completed
+  long long submitted;
+  long long completed;
+  // the first error of a worker, 0 for none
+  int error;
+
+  // the estimated ticks of each task
+  int *estimate;
+  // the time each task was submitted
+  long long *submit;
+  // the time from submitting each task to its completion (-1 until then)
+  long long *latency;
+  // the time the workers started and the last task completed
+  long long start;
+  long long last;
+};
+
+// records the first error of a worker, waking the threads waiting for the tasks
+static void __executor_error(Executor *e, int err, const char *message) {
+  pthread_mutex_lock(&e->lock);
+
+  if (e->error == 0) {
+    e->error = err;
+    printf("%d : %s\n", err, message);
+  }
+
+  pthread_cond_broadcast(&e->done);
+  pthread_mutex_unlock(&e->lock);
+}
+
+// counts a task of a worker completed at a time
+static void __executor_complete(ExecutorWorker *w, Process *p, long long now) {
+  Executor *e = w->executor;
+
+  pthread_mutex_lock(&e->lock);
+
+  e->latency[process_id(p)] = now - e->submit[process_id(p)];
+  e->completed++;
+  w->load -= e->estimate[process_id(p)];
+
+  if (now > e->last) {
+    e->last = now;
+  }
+
+  if (e->completed == e->submitted) {
+    pthread_cond_broadcast(&e->done);
+  }
+
+  pthread_mutex_unlock(&e->lock);
+}
+
+// pins the calling worker to its core, a hint where affinity is not allowed
+static void __executor_pin(ExecutorWorker *w) {
+#ifdef __linux__
+  long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+  cpu_set_t set;
+
+  if (cpus < 1) {
+    return;
+  }
+
+  CPU_ZERO(&set);
+  CPU_SET(w->index % cpus, &set);
+
+  pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+#else
+  (void) w;
+#endif
+}
+
+/**
+ * runs the tasks of a worker until it stops.  the algorithm is called
+ * under the lock of the worker, the work of a time slice outside it, so
+ * tasks can be submitted while the worker runs.
+ * @param arg the thread argument (should be a worker)
+ * @return NULL (check the executor for the error)
+ */
+static void *__executor_work(void *arg) {
+  ExecutorWorker *w = (ExecutorWorker *) arg;
+  Executor *e = w->executor;
+
+  __executor_pin(w);
+
+  pthread_mutex_lock(&w->lock);
+
+  for (;;) {
+    int ready;
+
+    // wait for a task, or stop once there is none left
+    while ((ready = algorithm_process_ready(w->algorithm)) == 0 && !w->stopping) {
+      pthread_cond_wait(&w->ready, &w->lock);
+    }
+
+    if (ready == -1) {
+      __executor_error(e, -1, "algorithm_process_ready");
+      break;
+    }
+
+    if (ready == 0) {
+      break;
+    }
+
+    Process *p = algorithm_process_get(w->algorithm);
+
+    if (p == NULL) {
+      continue;
+    }
+
+    int slice = algorithm_process_slice(w->algorithm, p);
+
+    if (slice < 1) {
+      slice = 1;
+    }
+
+    process_dispatch(p, w->tick);
+
+    pthread_mutex_unlock(&w->lock);
+
+    int current = 0;
+    int ran = 0;
+
+    // one bounded unit of work each tick of the time slice
+    do {
+      current = process_run(p);
+      ran++;
+    } while (--slice > 0 && current > 0);
+
+    long long now = current == PROCESS_END ? profile_now() : 0;
+
+    pthread_mutex_lock(&w->lock);
+
+    w->tick += ran;
+
+    if (current == PROCESS_END) {
+      process_set_completion_time(p, w->tick);
+      __executor_complete(w, p, now);
+    } else if (current == PROCESS_ERROR) {
+      __executor_error(e, -1, "process_run");
+      break;
+    } else {
+      process_set_ready_time(p, w->tick);
+
+      if (algorithm_process_put(w->algorithm, p)) {
+        __executor_error(e, -1, "algorithm_process_put");
+        break;
+      }
+    }
+  }
+
+  pthread_mutex_unlock(&w->lock);
+
+  return NULL;
+}
+
+Executor *new_executor(OnExecutorAlgorithm create, void *arg, int workers, int capacity) {
+  if (create == NULL || workers < 1 || capacity < 1) {
+    return NULL;
+  }
+
+  Executor *e = (Executor *) malloc(sizeof(Executor));
+
+  if (e == NULL) {
+    abort();
+  }
+
+  e->workers = calloc((size_t) workers, sizeof(ExecutorWorker));
+  e->estimate = malloc((size_t) capacity * sizeof(int));
+  e->submit = malloc((size_t) capacity * sizeof(long long));
+  e->latency = malloc((size_t) capacity * sizeof(long long));
+
+  if (e->workers == NULL || e->estimate == NULL || e->submit == NULL || e->latency == NULL) {
+    abort();
+  }
+
+  e->size = 0;
+  e->started = 0;
+  e->tasks = new_process_table();
+  e->capacity = capacity;
+  e->next = 0;
+  e->stopped = 0;
+  e->submitted = 0;
+  e->completed = 0;
+  e->error = 0;
+  e->start = 0;
+  e->last = 0;
+
+  pthread_mutex_init(&e->lock, NULL);
+  pthread_cond_init(&e->done, NULL);
+
+  // the tasks never move the columns the workers run
+  if (process_table_reserve(e->tasks, capacity)) {
+    delete_executor(e);
+    return NULL;
+  }
+
+  for (; e->size < workers; e->size++) {
+    ExecutorWorker *w = &e->workers[e->size];
+
+    w->executor = e;
+    w->index = e->size;
+    w->algorithm = create(arg);
+    w->tick = 0;
+    w->stopping = 0;
+    w->load = 0;
+
+    if (w->algorithm == NULL) {
+      delete_executor(e);
+      return NULL;
+    }
+
+    pthread_mutex_init(&w->lock, NULL);
+    pthread_cond_init(&w->ready, NULL);
+  }
+
+  return e;
+}
+
+void delete_executor(Executor *e) {
+  if (e == NULL) {
+    return;
+  }
+
+  executor_stop(e);
+
+  for (int i = 0; i < e->size; i++) {
+    delete_algorithm(e->workers[i].algorithm);
+    pthread_mutex_destroy(&e->workers[i].lock);
+    pthread_cond_destroy(&e->workers[i].ready);
+  }
+
+  pthread_mutex_destroy(&e->lock);
+  pthread_cond_destroy(&e->done);
+  delete_process_table(e->tasks);
+  free(e->workers);
+  free(e->estimate);
+  free(e->submit);
+  free(e->latency);
+  free(e);
+}
+
+int executor_start(Executor *e) {
+  if (e == NULL || e->started) {
+    return -1;
+  }
+
+  e->start = profile_now();
+
+  for (int i = 0; i < e->size; i++) {
+    int err = pthread_create(&e->workers[i].thread, NULL, __executor_work, &e->workers[i]);
+
+    if (err) {
+      printf("%d : %s\n", err, "pthread_create");
+
+      // the workers started so far are stopped and joined
+      e->size = i;
+      e->started = 1;
+      executor_stop(e);
+      return -1;
+    }
+  }
+
+  e->started = 1;
+  return 0;
+}
+
+// the worker with the least estimated ticks of work left, tasks never move once given
+static ExecutorWorker *__executor_least_loaded(Executor *e) {
+  ExecutorWorker *least = &e->workers[e->next];
+
+  for (int i = 1; i < e->size; i++) {
+    ExecutorWorker *w = &e->workers[(e->next + i) % e->size];
+
+    if (w->load < least->load) {
+      least = w;
+    }
+  }
+
+  return least;
+}
+
+Process *executor_submit(Executor *e, const char *name, ProcessWork work, void *state, int estimate) {
+  if (e == NULL || work == NULL || estimate < 1) {
+    return NULL;
+  }
+
+  pthread_mutex_lock(&e->lock);
+
+  if (e->stopped || process_table_size(e->tasks) == e->capacity) {
+    pthread_mutex_unlock(&e->lock);
+    return NULL;
+  }
+
+  Process *p = process_table_new_process(e->tasks, name);
+
+  if (p == NULL || process_set_service_time(p, estimate) || process_set_work(p, work, state)) {
+    pthread_mutex_unlock(&e->lock);
+    return NULL;
+  }
+
+  ExecutorWorker *w = __executor_least_loaded(e);
+
+  w->load += estimate;
+  e->next = (w->index + 1) % e->size;
+  e->estimate[process_id(p)] = estimate;
+  e->submit[process_id(p)] = profile_now();
+  e->latency[process_id(p)] = -1;
+  e->submitted++;
+
+  pthread_mutex_unlock(&e->lock);
+
+  // the worker lock is never taken under the executor lock
+  pthread_mutex_lock(&w->lock);
+
+  process_set_arrival_time(p, w->tick);
+
+  int err = algorithm_process_arrive(w->algorithm, p);
+
+  pthread_cond_signal(&w->ready);
+  pthread_mutex_unlock(&w->lock);
+
+  if (err) {
+    __executor_error(e, err, "algorithm_process_arrive");
+    return NULL;
+  }
+
+  return p;
+}
+
+int executor_wait(Executor *e) {
+  if (e == NULL || !e->started) {
+    return -1;
+  }
+
+  pthread_mutex_lock(&e->lock);
+
+  while (e->completed < e->submitted && e->error == 0) {
+    pthread_cond_wait(&e->done, &e->lock);
+  }
+
+  int err = e->error;
+
+  pthread_mutex_unlock(&e->lock);
+
+  return err ? -1 : 0;
+}
+
+int executor_stop(Executor *e) {
+  if (e == NULL) {
+    return -1;
+  }
+
+  pthread_mutex_lock(&e->lock);
+  e->stopped = 1;
+  pthread_mutex_unlock(&e->lock);
+
+  if (!e->started) {
+    return 0;
+  }
+
+  for (int i = 0; i < e->size; i++) {
+    ExecutorWorker *w = &e->workers[i];
+
+    pthread_mutex_lock(&w->lock);
+    w->stopping = 1;
+    pthread_cond_signal(&w->ready);
+    pthread_mutex_unlock(&w->lock);
+  }
+
+  for (int i = 0; i < e->size; i++) {
+    pthread_join(e->workers[i].thread, NULL);
+  }
+
+  e->started = 0;
+  return e->error ? -1 : 0;
+}
+
+ProcessTable *executor_processes(Executor *e) {
+  return e == NULL ? NULL : e->tasks;
+}
+
+static int __executor_compare_latencies(const void *a, const void *b) {
+  long long x = *(const long long *) a;
+  long long y = *(const long long *) b;
+
+  return (x > y) - (x < y);
+}
+
+// the latency at a percentile of sorted latencies
+static long long __executor_percentile(const long long *sorted, long long size, double percentile) {
+  long long index = (long long) (percentile / 100 * size + 0.5) - 1;
+
+  return sorted[index < 0 ? 0 : index >= size ? size - 1 : index];
+}
+
+int executor_stats(Executor *e, ExecutorStats *stats) {
+  if (e == NULL || stats == NULL) {
+    return -1;
+  }
+
+  pthread_mutex_lock(&e->lock);
+
+  int size = process_table_size(e->tasks);
+  long long completed = 0;
+  long long *sorted = malloc((size_t) (size > 0 ? size : 1) * sizeof(long long));
+
+  if (sorted == NULL) {
+    abort();
+  }
+
+  for (int i = 0; i < size; i++) {
+    if (e->latency[i] != -1) {
+      sorted[completed++] = e->latency[i];
+    }
+  }
+
+  double seconds = (e->last - e->start) / 1e9;
+
+  pthread_mutex_unlock(&e->lock);
+
+  if (completed == 0) {
+    free(sorted);
+    return -1;
+  }
+
+  qsort(sorted, (size_t) completed, sizeof(long long), __executor_compare_latencies);
+
+  stats->tasks = completed;
+  stats->ticks = 0;
+  stats->seconds = seconds;
+  stats->tasks_per_second = seconds > 0 ? completed / seconds : 0;
+  stats->p50 = __executor_percentile(sorted, completed, 50);
+  stats->p90 = __executor_percentile(sorted, completed, 90);
+  stats->p99 = __executor_percentile(sorted, completed, 99);
+  stats->p999 = __executor_percentile(sorted, completed, 99.9);
+  stats->max = sorted[completed - 1];
+
+  for (int i = 0; i < e->size; i++) {
+    ExecutorWorker *w = &e->workers[i];
+
+    pthread_mutex_lock(&w->lock);
+    stats->ticks += w->tick;
+    pthread_mutex_unlock(&w->lock);
+  }
+
+  free(sorted);
+  return 0;
+}
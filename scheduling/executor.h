@@ -0,0 +1,107 @@
+#ifndef RYJEN_OS_EXECUTOR_H
+#define RYJEN_OS_EXECUTOR_H
+
+#include "types.h"
+#include "process.h"
+
+/**
+ * Creates the algorithm of one worker of an executor
+ * @param void* the argument given to new_executor
+ * @return the algorithm instance, NULL on error
+ */
+typedef Algorithm *(*OnExecutorAlgorithm)(void *);
+
+// the measurements of the tasks an executor completed
+typedef struct executor_stats {
+  // the tasks completed
+  long long tasks;
+  // the ticks of work run by every worker
+  long long ticks;
+  // the wall time from starting the workers to the last completion
+  double seconds;
+  // the tasks completed per second of wall time
+  double tasks_per_second;
+  // the percentiles of the time from submitting a task to its completion, in nanoseconds
+  long long p50;
+  long long p90;
+  long long p99;
+  long long p999;
+  long long max;
+} ExecutorStats;
+
+/**
+ * Allocates a new executor running live tasks on a pool of worker threads,
+ * each pinned to a core.  Every worker has its own algorithm, created by
+ * a callback, deciding which of its tasks runs next, the same way the
+ * scheduler runs one processor, so the policies keep their single processor
+ * state.  A task is given to the worker with the least estimated ticks of
+ * work left when it is submitted, and runs there until it completes.
+ * NOTE: tasks are not stolen by idle workers, since an algorithm keeps
+ * state about the tasks it took (e.g. mlfq accounts the last time slice
+ * on its next get), so a worker given tasks longer than their estimates
+ * can finish well after the others.
+ * @param OnExecutorAlgorithm creates the algorithm of each worker
+ * @param void* the argument of the callback
+ * @param int the number of workers (at least 1)
+ * @param int the most tasks the executor can run, so the columns never move
+ * @return the executor instance, NULL on error
+ */
+Executor *new_executor(OnExecutorAlgorithm, void *, int, int);
+
+/**
+ * Destroys an executor instance, stopping its workers once their tasks
+ * completed
+ * @param Executor the executor instance
+ */
+void delete_executor(Executor *);
+
+/**
+ * Starts the workers of an executor
+ * @param Executor the executor instance
+ * @return 0 on success, -1 on error
+ */
+int executor_start(Executor *);
+
+/**
+ * Submits a task to an executor, a process whose work runs one bounded
+ * unit each tick (see process_set_work).  The task arrives at the least
+ * loaded worker at the tick that worker is on.
+ * @param Executor the executor instance
+ * @param char* the task name
+ * @param ProcessWork the work of the task
+ * @param void* the state of the work
+ * @param int the estimated ticks of work (at least 1), for the algorithms ordering by service time
+ * @return the process of the task, NULL on error or if the executor is full
+ */
+Process *executor_submit(Executor *, const char *, ProcessWork, void *, int);
+
+/**
+ * Waits until every task submitted to an executor completed
+ * @param Executor the executor instance
+ * @return 0 on success, -1 on error or if a task failed
+ */
+int executor_wait(Executor *);
+
+/**
+ * Stops the workers of an executor once their tasks completed
+ * @param Executor the executor instance
+ * @return 0 on success, -1 on error
+ */
+int executor_stop(Executor *);
+
+/**
+ * Gets the processes of the tasks of an executor
+ * @param Executor the executor instance
+ * @return the table, NULL on error
+ */
+ProcessTable *executor_processes(Executor *);
+
+/**
+ * Measures the tasks an executor completed
+ * @param Executor the executor instance
+ * @param ExecutorStats set to the measurements
+ * @return 0 on success, -1 on error or if no task completed
+ */
+int executor_stats(Executor *, ExecutorStats *);
+
+#endif
@@ -0,0 +1,413 @@
+#define _DEFAULT_SOURCE
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "types.h"
+#include "scheduler.h"
+#include "process.h"
+#include "heap.h"
+#include "algorithm.h"
+#include "policy.h"
+#include "loader.h"
+
+// the group of processes without one
+#define FAIRSHARE_DEFAULT_GROUP "default"
+
+// virtual time units of a tick for a weight of 1
+#define FAIRSHARE_TICK_SCALE 1048576LL
+
+// the initial number of groups
+#define FAIRSHARE_GROUPS 8
+
+// a callback to create the algorithm within a group
+typedef Algorithm *(*OnGroupAlgorithm)();
+
+// a share group type
+typedef struct fairshare_group Group;
+
+// a hierarchical fair share type
+typedef struct fairshare FairShare;
+
+struct fairshare_group {
+  // the group name
+  char *name;
+  // the share of the cpu relative to other groups
+  int weight;
+  // schedules the processes within the group
+  Algorithm *algorithm;
+  // weighted ticks serviced
+  long long vtime;
+  // activation order, to break virtual time ties
+  unsigned long seq;
+  // whether the group is in the ready heap
+  int queued;
+};
+
+struct fairshare {
+  // an array of groups ordered by name
+  Group **groups;
+  // the number of groups
+  int size;
+  // the allocated number of groups
+  int capacity;
+  // groups with a ready process ordered by virtual time
+  Heap *ready;
+  // the group given a time slice and not yet settled
+  Group *current;
+  // the process given the time slice
+  Process *running;
+  // the ticks serviced by the process when the time slice was given
+  int mark;
+  // monotonic floor of the virtual times
+  long long min_vtime;
+  // activation counter
+  unsigned long seq;
+  // creates the algorithm for a new group
+  OnGroupAlgorithm on_group;
+};
+
+// orders groups by virtual time, then activation
+static int __fairshare_compare(void *a, void *b) {
+  Group *g1 = (Group *) a;
+  Group *g2 = (Group *) b;
+
+  if (g1->vtime != g2->vtime) {
+    return g1->vtime < g2->vtime ? -1 : 1;
+  }
+  return g1->seq < g2->seq ? -1 : g1->seq > g2->seq;
+}
+
+FairShare *new_fairshare(OnGroupAlgorithm on_group) {
+  FairShare *fs = (FairShare *) malloc(sizeof(FairShare));
+
+  if (fs == NULL) {
+    abort();
+  }
+
+  fs->groups = malloc(FAIRSHARE_GROUPS * sizeof(Group *));
+
+  if (fs->groups == NULL) {
+    abort();
+  }
+
+  fs->size = 0;
+  fs->capacity = FAIRSHARE_GROUPS;
+  fs->ready = new_heap(__fairshare_compare);
+  fs->current = NULL;
+  fs->running = NULL;
+  fs->mark = 0;
+  fs->min_vtime = 0;
+  fs->seq = 0;
+  fs->on_group = on_group;
+  return fs;
+}
+
+void delete_fairshare(FairShare *fs) {
+  if (fs == NULL) {
+    return;
+  }
+
+  for (int i = 0; i < fs->size; i++) {
+    delete_algorithm(fs->groups[i]->algorithm);
+    free(fs->groups[i]->name);
+    free(fs->groups[i]);
+  }
+
+  delete_heap(fs->ready);
+  free(fs->groups);
+  free(fs);
+}
+
+// finds the group index for a name, or where to insert it, O(log g)
+static int __fairshare_search(FairShare *fs, const char *name) {
+  int low = 0;
+  int high = fs->size;
+
+  while (low < high) {
+    int mid = (low + high) / 2;
+
+    if (strcmp(fs->groups[mid]->name, name) < 0) {
+      low = mid + 1;
+    } else {
+      high = mid;
+    }
+  }
+  return low;
+}
+
+// finds a group by name, creating it with a weight of 1 if needed
+static Group *__fairshare_group(FairShare *fs, const char *name) {
+  int index = __fairshare_search(fs, name);
+
+  if (index < fs->size && strcmp(fs->groups[index]->name, name) == 0) {
+    return fs->groups[index];
+  }
+
+  if (fs->size == fs->capacity) {
+    Group **groups = realloc(fs->groups, fs->capacity * 2 * sizeof(Group *));
+
+    if (groups == NULL) {
+      abort();
+    }
+
+    fs->groups = groups;
+    fs->capacity *= 2;
+  }
+
+  Group *g = (Group *) malloc(sizeof(Group));
+
+  if (g == NULL) {
+    abort();
+  }
+
+  g->name = strdup(name);
+  g->weight = 1;
+  g->algorithm = fs->on_group();
+  g->vtime = 0;
+  g->seq = 0;
+  g->queued = 0;
+
+  if (g->name == NULL || g->algorithm == NULL) {
+    abort();
+  }
+
+  memmove(&fs->groups[index + 1], &fs->groups[index], (fs->size - index) * sizeof(Group *));
+
+  fs->groups[index] = g;
+  fs->size++;
+  return g;
+}
+
+int fairshare_set_weight(FairShare *fs, const char *name, int weight) {
+  if (fs == NULL || name == NULL || weight < 1) {
+    return -1;
+  }
+
+  __fairshare_group(fs, name)->weight = weight;
+
+  return 0;
+}
+
+// puts a group with a ready process in the heap
+static int __fairshare_enqueue(FairShare *fs, Group *g) {
+  // a group waking up does not get credit for the time it was idle
+  if (g->vtime < fs->min_vtime) {
+    g->vtime = fs->min_vtime;
+  }
+
+  g->seq = fs->seq++;
+  g->queued = 1;
+
+  return heap_push(fs->ready, g);
+}
+
+// charges the current group for its time slice
+static int __fairshare_settle(FairShare *fs) {
+  Group *g = fs->current;
+
+  if (g == NULL) {
+    return 0;
+  }
+
+  int serviced = process_service_time(fs->running) - process_current_service_time(fs->running);
+
+  g->vtime += (serviced - fs->mark) * FAIRSHARE_TICK_SCALE / g->weight;
+
+  fs->current = NULL;
+  fs->running = NULL;
+
+  if (algorithm_process_ready(g->algorithm) > 0) {
+    return __fairshare_enqueue(fs, g);
+  }
+
+  return 0;
+}
+
+static int __fairshare_arrive(Process *p, void *arg) {
+  if (p == NULL || arg == NULL) {
+    return -1;
+  }
+
+  FairShare *fs = (FairShare *) arg;
+
+  const char *name = process_group(p);
+
+  Group *g = __fairshare_group(fs, name == NULL ? FAIRSHARE_DEFAULT_GROUP : name);
+
+  if (algorithm_process_arrive(g->algorithm, p)) {
+    return -1;
+  }
+
+  // the current group is queued when settled
+  if (g->queued || g == fs->current) {
+    return 0;
+  }
+
+  return __fairshare_enqueue(fs, g);
+}
+
+static int __fairshare_ready(void *arg) {
+  if (arg == NULL) {
+    return -1;
+  }
+
+  FairShare *fs = (FairShare *) arg;
+
+  if (!heap_is_empty(fs->ready)) {
+    return 1;
+  }
+
+  return fs->current != NULL && algorithm_process_ready(fs->current->algorithm) > 0;
+}
+
+static Process *__fairshare_get(void *arg) {
+  if (arg == NULL) {
+    return NULL;
+  }
+
+  FairShare *fs = (FairShare *) arg;
+
+  if (__fairshare_settle(fs)) {
+    return NULL;
+  }
+
+  // the group with the least weighted service
+  while (!heap_is_empty(fs->ready)) {
+    Group *g = heap_pop(fs->ready);
+
+    g->queued = 0;
+
+    if (g->vtime > fs->min_vtime) {
+      fs->min_vtime = g->vtime;
+    }
+
+    // delegate to the algorithm of the group
+    Process *p = algorithm_process_get(g->algorithm);
+
+    if (p != NULL) {
+      fs->current = g;
+      fs->running = p;
+      fs->mark = process_service_time(p) - process_current_service_time(p);
+      return p;
+    }
+  }
+
+  return NULL;
+}
+
+static int __fairshare_put(Process *p, void *arg) {
+  if (p == NULL || arg == NULL) {
+    return -1;
+  }
+
+  FairShare *fs = (FairShare *) arg;
+
+  if (fs->current == NULL) {
+    return -1;
+  }
+
+  return algorithm_process_put(fs->current->algorithm, p);
+}
+
+// destroys the data with the algorithm
+static void __fairshare_delete(void *arg) {
+  delete_fairshare((FairShare *) arg);
+}
+
+// the algorithms available within a group, with default arguments
+static Algorithm *__fairshare_rr() {
+  return new_rr_algorithm(3);
+}
+
+static Algorithm *__fairshare_mlfq() {
+  return new_mlfq_algorithm(3, 3, 0);
+}
+
+static Algorithm *__fairshare_cfs() {
+  return new_cfs_algorithm(6, 1);
+}
+
+static Algorithm *__fairshare_o1() {
+  return new_o1_algorithm(3);
+}
+
+static const struct {
+  const char *name;
+  OnGroupAlgorithm on_group;
+} __fairshare_policies[] = {
+  { "fcfs", new_fcfs_algorithm },
+  { "spn", new_spn_algorithm },
+  { "str", new_str_algorithm },
+  { "rr", __fairshare_rr },
+  { "lottery", new_lottery_algorithm },
+  { "mlfq", __fairshare_mlfq },
+  { "cfs", __fairshare_cfs },
+  { "o1", __fairshare_o1 },
+  { "edf", new_edf_algorithm },
+  { "hrrn", new_hrrn_algorithm },
+};
+
+int main(int argc, char *argv[]) {
+
+  // the workload file and switch cost, taken out of the arguments
+  LoaderOptions options;
+
+  if (loader_options(&argc, argv, &options)) {
+    puts("invalid argument");
+    return 1;
+  }
+
+  OnGroupAlgorithm on_group = __fairshare_rr;
+
+  if (argc > 1) {
+    on_group = NULL;
+
+    for (size_t i = 0; i < sizeof(__fairshare_policies) / sizeof(__fairshare_policies[0]); i++) {
+      if (strcmp(argv[1], __fairshare_policies[i].name) == 0) {
+        on_group = __fairshare_policies[i].on_group;
+      }
+    }
+
+    if (on_group == NULL) {
+      puts("invalid argument");
+      return 1;
+    }
+  }
+
+  FairShare *data = new_fairshare(on_group);
+
+  // group weights as name=weight
+  for (int i = 2; i < argc; i++) {
+    char name[100] = {0};
+    int weight = 0;
+
+    if (sscanf(argv[i], "%99[^=]=%d", name, &weight) != 2 || fairshare_set_weight(data, name, weight)) {
+      puts("invalid argument");
+      delete_fairshare(data);
+      return 1;
+    }
+  }
+
+  // create the algorithm
+  Algorithm *algo = new_algorithm(__fairshare_arrive, __fairshare_ready, __fairshare_get, __fairshare_put, data);
+
+  algorithm_set_on_delete(algo, __fairshare_delete);
+
+  // create the scheduler
+  Scheduler *sched = new_scheduler(algo);
+
+  // set the switch cost and read the processes
+  if (loader_setup(sched, &options)) {
+    delete_scheduler(sched);
+    return 1;
+  }
+
+  // run
+  int result = scheduler_run(sched);
+
+  // cleanup
+  delete_scheduler(sched);
+
+  return result;
+}
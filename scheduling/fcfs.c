@@ -1,9 +1,15 @@
 #include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
 
 #include "types.h"
 #include "scheduler.h"
+#include "process.h"
 #include "queue.h"
 #include "algorithm.h"
+#include "policy.h"
+#include "loader.h"
+#include "scheduler_loop.h"
 
 // start a process in the queue
 static Process * __fcfs_get(void *arg) {
@@ -29,27 +35,76 @@ static int __fcfs_put(Process *p, void *arg) {
   return queue_push_front(queue, p);
 }
 
-int main() {
+// non-premptive so run until complete, or an arrival
+static int __fcfs_slice(Process *p, void *arg) {
+  (void) arg;
 
+  return process_current_service_time(p);
+}
+
+SCHEDULER_LOOP(__fcfs_loop, scheduler_loop_queue_arrive, scheduler_loop_queue_ready, __fcfs_get, __fcfs_put, __fcfs_slice)
+
+// destroys the queue with the algorithm
+static void __fcfs_delete(void *arg) {
+  delete_queue((Queue *) arg);
+}
+
+Algorithm *new_fcfs_algorithm() {
   Queue *queue = new_queue();
 
-  // create the algorithm
   Algorithm *algo = new_queue_algorithm(queue, __fcfs_get, __fcfs_put);
 
+  algorithm_set_on_delete(algo, __fcfs_delete);
+
+  algorithm_set_on_slice(algo, __fcfs_slice);
+
+  algorithm_set_loop(algo, __fcfs_loop);
+
+  return algo;
+}
+
+#ifndef POLICY_LIBRARY
+
+int main(int argc, char *argv[]) {
+
+  // the workload file and switch cost, taken out of the arguments
+  LoaderOptions options;
+
+  if (loader_options(&argc, argv, &options)) {
+    puts("invalid argument");
+    return 1;
+  }
+
+  // compute the schedule without simulating ticks
+  int analytic = 0;
+
+  if (argc > 1) {
+    if (strcmp(argv[1], "-a") != 0) {
+      puts("invalid argument");
+      return 1;
+    }
+    analytic = 1;
+  }
+
+  // create the algorithm
+  Algorithm *algo = new_fcfs_algorithm();
+
   // create the scheduler
   Scheduler *sched = new_scheduler(algo);
 
-  // read the processes
-  scheduler_read_processes(sched);
+  // set the switch cost and read the processes
+  if (loader_setup(sched, &options)) {
+    delete_scheduler(sched);
+    return 1;
+  }
 
   // run
-  int result = scheduler_run(sched);
+  int result = analytic ? scheduler_run_analytic(sched, NULL) : scheduler_run(sched);
 
   // cleanup
   delete_scheduler(sched);
 
-  delete_queue(queue);
-
   return result;
 }
 
+#endif
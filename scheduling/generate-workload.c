@@ -0,0 +1,443 @@
+#define _POSIX_C_SOURCE 200809L
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include <limits.h>
+#include <math.h>
+#include <unistd.h>
+
+#include "types.h"
+#include "workload.h"
+
+// the bytes of text formatted before writing
+#define GENERATE_BUFFER (1 << 20)
+
+// the longest text line: a name, two times and a group
+#define GENERATE_LINE 64
+
+// the mmpp burst rate relative to the quiet rate
+#define GENERATE_BURST_FACTOR 10.0
+// the mean ticks of a burst and of a quiet period
+#define GENERATE_BURST_TICKS 100.0
+#define GENERATE_QUIET_TICKS 900.0
+
+// the pareto shape, heavy tailed with a finite mean
+#define GENERATE_PARETO_SHAPE 1.5
+
+// the share of long jobs of the bimodal service times, and how much longer
+#define GENERATE_BIMODAL_LONG 0.1
+#define GENERATE_BIMODAL_FACTOR 10.0
+
+// the arrival processes
+typedef enum {
+  GENERATE_POISSON,
+  GENERATE_MMPP,
+  GENERATE_PERIODIC,
+} GenerateArrival;
+
+// the service time distributions
+typedef enum {
+  GENERATE_EXPONENTIAL,
+  GENERATE_PARETO,
+  GENERATE_BIMODAL,
+} GenerateService;
+
+// the parameters of a workload
+typedef struct generate_options {
+  // the number of processes
+  int count;
+  // the seed of the generator
+  uint64_t seed;
+  GenerateArrival arrival;
+  GenerateService service;
+  // the mean arrivals per tick
+  double rate;
+  // the mean service time
+  double mean;
+  // the number of share groups (0 for none)
+  int groups;
+  // write a binary workload rather than text
+  int binary;
+} GenerateOptions;
+
+// xoshiro256** state
+typedef struct generate_random {
+  uint64_t s[4];
+} GenerateRandom;
+
+static uint64_t __generate_rotl(uint64_t x, int k) {
+  return (x << k) | (x >> (64 - k));
+}
+
+// splitmix64, to spread a seed over the state
+static uint64_t __generate_splitmix(uint64_t *x) {
+  uint64_t z = (*x += 0x9e3779b97f4a7c15ull);
+
+  z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+  z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+  return z ^ (z >> 31);
+}
+
+static void __generate_seed(GenerateRandom *r, uint64_t seed) {
+  for (int i = 0; i < 4; i++) {
+    r->s[i] = __generate_splitmix(&seed);
+  }
+}
+
+static uint64_t __generate_next(GenerateRandom *r) {
+  uint64_t *s = r->s;
+  uint64_t result = __generate_rotl(s[1] * 5, 7) * 9;
+  uint64_t t = s[1] << 17;
+
+  s[2] ^= s[0];
+  s[3] ^= s[1];
+  s[1] ^= s[2];
+  s[0] ^= s[3];
+  s[2] ^= t;
+  s[3] = __generate_rotl(s[3], 45);
+
+  return result;
+}
+
+// a uniform double in (0, 1]
+static double __generate_uniform(GenerateRandom *r) {
+  return ((__generate_next(r) >> 11) + 1) * 0x1.0p-53;
+}
+
+// an exponential double of a mean
+static double __generate_exponential(GenerateRandom *r, double mean) {
+  return -mean * log(__generate_uniform(r));
+}
+
+// the state of an arrival process
+typedef struct generate_clock {
+  // the time of the last arrival
+  double time;
+  // whether the mmpp is bursting
+  int burst;
+  // the time the mmpp changes state
+  double change;
+} GenerateClock;
+
+static double __generate_arrival(const GenerateOptions *o, GenerateRandom *r, GenerateClock *c) {
+  switch (o->arrival) {
+    case GENERATE_PERIODIC:
+      c->time += 1.0 / o->rate;
+      break;
+
+    case GENERATE_MMPP: {
+      // the quiet rate so the mean over both states is the rate
+      double burst = GENERATE_BURST_TICKS / (GENERATE_BURST_TICKS + GENERATE_QUIET_TICKS);
+      double quiet = o->rate / (1 - burst + burst * GENERATE_BURST_FACTOR);
+
+      for (;;) {
+        double next = c->time + __generate_exponential(r, 1.0 / (c->burst ? quiet * GENERATE_BURST_FACTOR : quiet));
+
+        if (next < c->change) {
+          c->time = next;
+          break;
+        }
+
+        // memoryless, so draw again from the change in state
+        c->time = c->change;
+        c->burst = !c->burst;
+        c->change += __generate_exponential(r, c->burst ? GENERATE_BURST_TICKS : GENERATE_QUIET_TICKS);
+      }
+      break;
+    }
+
+    default:
+      c->time += __generate_exponential(r, 1.0 / o->rate);
+      break;
+  }
+
+  return c->time;
+}
+
+static int __generate_service(const GenerateOptions *o, GenerateRandom *r) {
+  double value;
+
+  switch (o->service) {
+    case GENERATE_PARETO: {
+      // the scale so the mean is the mean
+      double scale = o->mean * (GENERATE_PARETO_SHAPE - 1) / GENERATE_PARETO_SHAPE;
+
+      value = scale / pow(__generate_uniform(r), 1.0 / GENERATE_PARETO_SHAPE);
+      break;
+    }
+
+    case GENERATE_BIMODAL: {
+      double short_service = o->mean / (1 - GENERATE_BIMODAL_LONG + GENERATE_BIMODAL_LONG * GENERATE_BIMODAL_FACTOR);
+
+      value = __generate_uniform(r) <= GENERATE_BIMODAL_LONG ? short_service * GENERATE_BIMODAL_FACTOR : short_service;
+      break;
+    }
+
+    default:
+      value = __generate_exponential(r, o->mean);
+      break;
+  }
+
+  // whole ticks, at least one, and room to sum many
+  value = floor(value + 0.5);
+
+  return value < 1 ? 1 : value > INT_MAX / 2 ? INT_MAX / 2 : (int) value;
+}
+
+// formats a non negative integer, returns the position after it
+static char *__generate_put_int(char *s, unsigned int value) {
+  char digits[10];
+  int n = 0;
+
+  do {
+    digits[n++] = (char) ('0' + value % 10);
+    value /= 10;
+  } while (value > 0);
+
+  while (n > 0) {
+    *s++ = digits[--n];
+  }
+
+  return s;
+}
+
+// writes the processes as text lines, formatted by hand into a buffer
+static int __generate_text(const GenerateOptions *o, const int *arrival, const int *service, const int *group) {
+  char *buffer = malloc(GENERATE_BUFFER);
+
+  if (buffer == NULL) {
+    abort();
+  }
+
+  char *s = buffer;
+
+  for (int i = 0; i < o->count; i++) {
+    if (s - buffer > GENERATE_BUFFER - GENERATE_LINE) {
+      if (fwrite(buffer, 1, s - buffer, stdout) != (size_t) (s - buffer)) {
+        free(buffer);
+        return -1;
+      }
+      s = buffer;
+    }
+
+    *s++ = 'P';
+    s = __generate_put_int(s, (unsigned int) i);
+    *s++ = ' ';
+    s = __generate_put_int(s, (unsigned int) arrival[i]);
+    *s++ = ' ';
+    s = __generate_put_int(s, (unsigned int) service[i]);
+
+    if (group != NULL) {
+      memcpy(s, " - - g", 6);
+      s = __generate_put_int(s + 6, (unsigned int) group[i]);
+    }
+
+    *s++ = '\n';
+  }
+
+  int err = fwrite(buffer, 1, s - buffer, stdout) != (size_t) (s - buffer) || fflush(stdout) ? -1 : 0;
+
+  free(buffer);
+  return err;
+}
+
+// lays out the strings P0 to Pn-1, or g0 to gn-1, as the offsets and bytes of a workload
+static char *__generate_strings(char prefix, int count, uint64_t **offsets, size_t *size) {
+  // at most 11 bytes a string, with the terminator
+  char *bytes = malloc(count > 0 ? (size_t) count * 12 : 1);
+
+  *offsets = malloc((size_t) (count > 0 ? count : 1) * sizeof(uint64_t));
+
+  if (bytes == NULL || *offsets == NULL) {
+    abort();
+  }
+
+  char *s = bytes;
+
+  for (int i = 0; i < count; i++) {
+    (*offsets)[i] = (uint64_t) (s - bytes);
+    *s++ = prefix;
+    s = __generate_put_int(s, (unsigned int) i);
+    *s++ = '\0';
+  }
+
+  *size = (size_t) (s - bytes);
+  return bytes;
+}
+
+// writes the processes as a binary workload, straight from the columns
+// rather than interning the names in a table first
+static int __generate_binary(const GenerateOptions *o, const int *arrival, const int *service, const int *group) {
+  // every process has its own name, so the name ids are the process ids
+  uint32_t *names = malloc((size_t) (o->count > 0 ? o->count : 1) * sizeof(uint32_t));
+
+  if (names == NULL) {
+    abort();
+  }
+
+  for (int i = 0; i < o->count; i++) {
+    names[i] = (uint32_t) i;
+  }
+
+  uint64_t *name_offsets, *group_offsets;
+
+  Workload w;
+
+  memset(&w, 0, sizeof(w));
+
+  w.count = o->count;
+  w.arrival = arrival;
+  w.service = service;
+  w.group = group;
+  w.name = names;
+  w.names = o->count;
+  w.groups = o->groups;
+
+  char *name_bytes = __generate_strings('P', w.names, &name_offsets, &w.name_size);
+  char *group_bytes = __generate_strings('g', w.groups, &group_offsets, &w.group_size);
+
+  w.name_offsets = name_offsets;
+  w.name_bytes = name_bytes;
+  w.group_offsets = group_offsets;
+  w.group_bytes = group_bytes;
+
+  int err = workload_put(&w, stdout) || fflush(stdout) ? -1 : 0;
+
+  free(names);
+  free(name_offsets);
+  free(name_bytes);
+  free(group_offsets);
+  free(group_bytes);
+  return err;
+}
+
+static int __generate_usage() {
+  puts("usage: generate-workload [-n count] [-s seed] [-a poisson|mmpp|periodic] [-r rate]\n"
+       "                         [-d exponential|pareto|bimodal] [-m mean] [-g groups] [-b]");
+  return 1;
+}
+
+int main(int argc, char *argv[]) {
+
+  GenerateOptions o = {
+    .count = 1000,
+    .seed = 1,
+    .arrival = GENERATE_POISSON,
+    .service = GENERATE_EXPONENTIAL,
+    .rate = -1,
+    .mean = 4,
+    .groups = 0,
+    .binary = 0,
+  };
+
+  int opt;
+
+  while ((opt = getopt(argc, argv, "n:s:a:r:d:m:g:b")) != -1) {
+    switch (opt) {
+      case 'n':
+        o.count = atoi(optarg);
+        break;
+      case 's':
+        o.seed = strtoull(optarg, NULL, 10);
+        break;
+      case 'a':
+        if (strcmp(optarg, "poisson") == 0) {
+          o.arrival = GENERATE_POISSON;
+        } else if (strcmp(optarg, "mmpp") == 0) {
+          o.arrival = GENERATE_MMPP;
+        } else if (strcmp(optarg, "periodic") == 0) {
+          o.arrival = GENERATE_PERIODIC;
+        } else {
+          return __generate_usage();
+        }
+        break;
+      case 'r':
+        o.rate = atof(optarg);
+        break;
+      case 'd':
+        if (strcmp(optarg, "exponential") == 0) {
+          o.service = GENERATE_EXPONENTIAL;
+        } else if (strcmp(optarg, "pareto") == 0) {
+          o.service = GENERATE_PARETO;
+        } else if (strcmp(optarg, "bimodal") == 0) {
+          o.service = GENERATE_BIMODAL;
+        } else {
+          return __generate_usage();
+        }
+        break;
+      case 'm':
+        o.mean = atof(optarg);
+        break;
+      case 'g':
+        o.groups = atoi(optarg);
+        break;
+      case 'b':
+        o.binary = 1;
+        break;
+      default:
+        return __generate_usage();
+    }
+  }
+
+  // a 90% utilized cpu by default
+  if (o.rate < 0) {
+    o.rate = 0.9 / o.mean;
+  }
+
+  if (optind != argc || o.count < 0 || o.rate <= 0 || o.mean < 1 || o.groups < 0) {
+    return __generate_usage();
+  }
+
+  if (o.binary && isatty(STDOUT_FILENO)) {
+    puts("refusing to write a binary workload to a terminal");
+    return 1;
+  }
+
+  int *ints = malloc((size_t) (o.count > 0 ? o.count : 1) * 3 * sizeof(int));
+
+  if (ints == NULL) {
+    abort();
+  }
+
+  int *arrival = ints;
+  int *service = ints + o.count;
+  int *group = o.groups > 0 ? ints + o.count * 2 : NULL;
+
+  GenerateRandom r;
+  GenerateClock clock = { 0, 0, 0 };
+
+  __generate_seed(&r, o.seed);
+
+  // start quiet
+  if (o.arrival == GENERATE_MMPP) {
+    clock.change = __generate_exponential(&r, GENERATE_QUIET_TICKS);
+  }
+
+  for (int i = 0; i < o.count; i++) {
+    double time = __generate_arrival(&o, &r, &clock);
+
+    // saturate rather than wrap on very long workloads
+    arrival[i] = time > INT_MAX / 2 ? INT_MAX / 2 : (int) time;
+    service[i] = __generate_service(&o, &r);
+
+    if (group != NULL) {
+      group[i] = (int) (__generate_next(&r) % (uint64_t) o.groups);
+    }
+  }
+
+  static char output[GENERATE_BUFFER];
+
+  setvbuf(stdout, output, _IOFBF, sizeof(output));
+
+  int err = o.binary ? __generate_binary(&o, arrival, service, group) : __generate_text(&o, arrival, service, group);
+
+  free(ints);
+
+  if (err) {
+    fputs("unable to write the workload\n", stderr);
+    return 1;
+  }
+
+  return 0;
+}
@@ -0,0 +1,376 @@
+#include <stdlib.h>
+#include <string.h>
+
+#include "types.h"
+#include "scheduler.h"
+#include "process.h"
+#include "queue.h"
+#include "algorithm.h"
+#include "policy.h"
+#include "loader.h"
+#include "scheduler_loop.h"
+
+// the initial number of buckets
+#define HRRN_BUCKETS 16
+
+// a bucket type
+typedef struct hrrn_bucket Bucket;
+
+// a waiting process type
+typedef struct hrrn_entry Entry;
+
+// a highest response ratio next type
+typedef struct hrrn HRRN;
+
+// a waiting process, in its bucket and in the arrivals
+struct hrrn_entry {
+  // the process
+  Process *process;
+  // whether it was taken from its bucket, so it is dropped from the arrivals
+  int taken;
+  // the next entry kept for reuse
+  Entry *next;
+};
+
+// waiting processes with the same service time
+struct hrrn_bucket {
+  // the service time of the processes
+  int service;
+  // the entries in arrival order, so the first has waited longest
+  Queue *queue;
+};
+
+struct hrrn {
+  // an array of buckets ordered by service time
+  Bucket *buckets;
+  // the number of buckets
+  int size;
+  // the allocated number of buckets
+  int capacity;
+  // every waiting entry in arrival order, to find the longest wait.
+  // the entries taken are dropped from the front lazily
+  Queue *arrivals;
+  // the entries dropped, kept for the next arrivals
+  Entry *free;
+  // the process put back to continue
+  Process *current;
+  // the last process taken, and the ticks of its burst
+  Process *last;
+  int burst;
+  // the latest arrival time seen
+  int latest;
+};
+
+HRRN *new_hrrn() {
+  HRRN *h = (HRRN *) malloc(sizeof(HRRN));
+
+  if (h == NULL) {
+    abort();
+  }
+
+  h->buckets = malloc(HRRN_BUCKETS * sizeof(Bucket));
+
+  if (h->buckets == NULL) {
+    abort();
+  }
+
+  h->size = 0;
+  h->capacity = HRRN_BUCKETS;
+  h->arrivals = new_queue();
+  h->free = NULL;
+  h->current = NULL;
+  h->last = NULL;
+  h->burst = 0;
+  h->latest = 0;
+  return h;
+}
+
+void delete_hrrn(HRRN *h) {
+  if (h == NULL) {
+    return;
+  }
+
+  for (int i = 0; i < h->size; i++) {
+    delete_queue_list(h->buckets[i].queue);
+  }
+
+  // every entry not dropped is in the arrivals, waiting or taken
+  while (!queue_is_empty(h->arrivals)) {
+    free(queue_pop_front(h->arrivals));
+  }
+
+  delete_queue(h->arrivals);
+
+  while (h->free != NULL) {
+    Entry *e = h->free;
+
+    h->free = e->next;
+    free(e);
+  }
+
+  free(h->buckets);
+  free(h);
+}
+
+// finds the bucket index for a service time, or where to insert it
+static int __hrrn_search(HRRN *h, int service) {
+  int low = 0;
+  int high = h->size;
+
+  while (low < high) {
+    int mid = (low + high) / 2;
+
+    if (h->buckets[mid].service < service) {
+      low = mid + 1;
+    } else {
+      high = mid;
+    }
+  }
+  return low;
+}
+
+static int __hrrn_arrive(Process *p, void *arg) {
+  if (p == NULL || arg == NULL) {
+    return -1;
+  }
+
+  HRRN *h = (HRRN *) arg;
+
+  int service = process_current_service_time(p);
+
+  int index = __hrrn_search(h, service);
+
+  // no bucket for the service time, so insert one
+  if (index == h->size || h->buckets[index].service != service) {
+
+    if (h->size == h->capacity) {
+      Bucket *buckets = realloc(h->buckets, h->capacity * 2 * sizeof(Bucket));
+
+      if (buckets == NULL) {
+        abort();
+      }
+
+      h->buckets = buckets;
+      h->capacity *= 2;
+    }
+
+    memmove(&h->buckets[index + 1], &h->buckets[index], (h->size - index) * sizeof(Bucket));
+
+    h->buckets[index].service = service;
+    h->buckets[index].queue = new_queue();
+    h->size++;
+  }
+
+  if (process_ready_time(p) > h->latest) {
+    h->latest = process_ready_time(p);
+  }
+
+  Entry *e = h->free;
+
+  if (e == NULL) {
+    e = (Entry *) malloc(sizeof(Entry));
+
+    if (e == NULL) {
+      abort();
+    }
+  } else {
+    h->free = e->next;
+  }
+
+  e->process = p;
+  e->taken = 0;
+  e->next = NULL;
+
+  if (queue_push_back(h->arrivals, e)) {
+    return -1;
+  }
+
+  return queue_push_back(h->buckets[index].queue, e);
+}
+
+static int __hrrn_ready(void *arg) {
+  if (arg == NULL) {
+    return -1;
+  }
+
+  HRRN *h = (HRRN *) arg;
+
+  return h->current != NULL || h->size > 0;
+}
+
+// compares the response ratios (wait + service) / service of two processes,
+// waiting since they arrived or woke from I/O
+static long long __hrrn_compare(Process *a, Process *b, int now) {
+  long long sa = process_current_service_time(a);
+  long long sb = process_current_service_time(b);
+
+  // cross multiply to compare the ratios without division
+  long long ratio = (now - process_ready_time(a) + sa) * sb - (now - process_ready_time(b) + sb) * sa;
+
+  if (ratio != 0) {
+    return ratio;
+  }
+
+  // ties go to the longest wait
+  return process_ready_time(b) - process_ready_time(a);
+}
+
+static Process *__hrrn_get(void *arg) {
+  if (arg == NULL) {
+    return NULL;
+  }
+
+  HRRN *h = (HRRN *) arg;
+
+  // non-premptive so keep the current process
+  if (h->current != NULL) {
+    Process *p = h->current;
+    h->current = NULL;
+    return p;
+  }
+
+  // the previous process completed its burst from the tick it was switched to,
+  // after any overhead, or the cpu was idle until the latest arrival
+  int now = h->latest;
+
+  if (process_dispatch_time(h->last) != -1 && process_dispatch_time(h->last) + h->burst > now) {
+    now = process_dispatch_time(h->last) + h->burst;
+  }
+
+  // drop the entries taken from the longest waiting, a process back from
+  // I/O waits again from its later entry
+  Entry *front = queue_peek_front(h->arrivals);
+
+  while (front != NULL && front->taken) {
+    queue_pop_front(h->arrivals);
+
+    front->next = h->free;
+    h->free = front;
+
+    front = queue_peek_front(h->arrivals);
+  }
+
+  if (front == NULL || h->size == 0) {
+    return NULL;
+  }
+
+  Process *oldest = front->process;
+
+  int best = -1;
+
+  for (int i = 0; i < h->size; i++) {
+    long long service = h->buckets[i].service;
+
+    // the best possible ratio of this and longer buckets is with the longest wait
+    if (best != -1 && service > 0) {
+      Process *b = ((Entry *) queue_peek_front(h->buckets[best].queue))->process;
+      long long bs = process_current_service_time(b);
+
+      if ((now - process_ready_time(b) + bs) * service > (now - process_ready_time(oldest) + service) * bs) {
+        break;
+      }
+    }
+
+    // the first in a bucket has waited longest, so has the highest ratio
+    Process *p = ((Entry *) queue_peek_front(h->buckets[i].queue))->process;
+
+    if (best == -1 || __hrrn_compare(p, ((Entry *) queue_peek_front(h->buckets[best].queue))->process, now) > 0) {
+      best = i;
+    }
+  }
+
+  Entry *e = queue_pop_front(h->buckets[best].queue);
+  Process *p = e->process;
+
+  // remove the empty bucket
+  if (queue_is_empty(h->buckets[best].queue)) {
+    delete_queue(h->buckets[best].queue);
+    memmove(&h->buckets[best], &h->buckets[best + 1], (h->size - best - 1) * sizeof(Bucket));
+    h->size--;
+  }
+
+  // its entry in the arrivals is dropped when it reaches the front
+  e->taken = 1;
+
+  // until it completes or blocks for I/O
+  h->last = p;
+  h->burst = process_current_burst_time(p);
+
+  return p;
+}
+
+static int __hrrn_put(Process *p, void *arg) {
+  if (p == NULL || arg == NULL) {
+    return -1;
+  }
+
+  HRRN *h = (HRRN *) arg;
+
+  // non-premptive so keep as current
+  h->current = p;
+
+  return 0;
+}
+
+// non-premptive so run until complete, or an arrival
+static int __hrrn_slice(Process *p, void *arg) {
+  (void) arg;
+
+  return process_current_service_time(p);
+}
+
+SCHEDULER_LOOP(__hrrn_loop, __hrrn_arrive, __hrrn_ready, __hrrn_get, __hrrn_put, __hrrn_slice)
+
+// destroys the data with the algorithm
+static void __hrrn_delete(void *arg) {
+  delete_hrrn((HRRN *) arg);
+}
+
+Algorithm *new_hrrn_algorithm() {
+  HRRN *data = new_hrrn();
+
+  Algorithm *algo = new_algorithm(__hrrn_arrive, __hrrn_ready, __hrrn_get, __hrrn_put, data);
+
+  algorithm_set_on_delete(algo, __hrrn_delete);
+
+  algorithm_set_on_slice(algo, __hrrn_slice);
+
+  algorithm_set_loop(algo, __hrrn_loop);
+
+  return algo;
+}
+
+#ifndef POLICY_LIBRARY
+
+int main(int argc, char *argv[]) {
+
+  // the workload file and switch cost, taken out of the arguments
+  LoaderOptions options;
+
+  if (loader_options(&argc, argv, &options)) {
+    puts("invalid argument");
+    return 1;
+  }
+
+  // create the algorithm
+  Algorithm *algo = new_hrrn_algorithm();
+
+  // create the scheduler
+  Scheduler *sched = new_scheduler(algo);
+
+  // set the switch cost and read the processes
+  if (loader_setup(sched, &options)) {
+    delete_scheduler(sched);
+    return 1;
+  }
+
+  // run
+  int result = scheduler_run(sched);
+
+  // cleanup
+  delete_scheduler(sched);
+
+  return result;
+}
+
+#endif
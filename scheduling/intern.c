@@ -0,0 +1,265 @@
+#include <stdlib.h>
+#include <string.h>
+
+#include "intern.h"
+
+// the initial number of strings
+#define INTERN_CAPACITY 8
+
+// a slot of the hash table
+typedef struct intern_slot {
+  // the hash of the string
+  uint32_t hash;
+  // the id + 1 (0 for empty)
+  uint32_t id;
+} InternSlot;
+
+struct intern {
+  // the strings, indexed by id
+  const char **strings;
+  // the hash of each string, to skip most compares
+  uint32_t *hashes;
+  // the number of strings
+  uint32_t size;
+  // the allocated number of strings
+  uint32_t capacity;
+
+  // open addressed slots, the hash beside the id so most probes
+  // do not touch the strings
+  InternSlot *slots;
+  // the number of slots, a power of 2
+  uint32_t mask;
+  // the number of strings in the slots, the rest were loaded at once
+  // and are hashed on the next lookup
+  uint32_t indexed;
+
+  // holds the strings
+  Arena *arena;
+};
+
+// FNV-1a
+static uint32_t __intern_hash(const char *s) {
+  uint32_t hash = 2166136261u;
+
+  for (; *s; s++) {
+    hash ^= (unsigned char) *s;
+    hash *= 16777619u;
+  }
+
+  return hash;
+}
+
+// rehashes the ids into a number of slots
+static void __intern_rehash(Intern *in, uint32_t slots) {
+  InternSlot *table = calloc(slots, sizeof(InternSlot));
+
+  if (table == NULL) {
+    abort();
+  }
+
+  for (uint32_t id = 0; id < in->indexed; id++) {
+    uint32_t i = in->hashes[id] & (slots - 1);
+
+    while (table[i].id != 0) {
+      i = (i + 1) & (slots - 1);
+    }
+
+    table[i].hash = in->hashes[id];
+    table[i].id = id + 1;
+  }
+
+  free(in->slots);
+
+  in->slots = table;
+  in->mask = slots - 1;
+}
+
+Intern *new_intern(Arena *arena) {
+  Intern *in = (Intern *) malloc(sizeof(Intern));
+
+  if (in == NULL) {
+    abort();
+  }
+
+  in->strings = NULL;
+  in->hashes = NULL;
+  in->size = 0;
+  in->capacity = 0;
+  in->slots = NULL;
+  in->mask = 0;
+  in->indexed = 0;
+  in->arena = arena;
+  return in;
+}
+
+void delete_intern(Intern *in) {
+  if (in == NULL) {
+    return;
+  }
+
+  free(in->strings);
+  free(in->hashes);
+  free(in->slots);
+  free(in);
+}
+
+// grows the strings to a capacity
+static void __intern_grow(Intern *in, uint32_t capacity) {
+  const char **strings = realloc(in->strings, capacity * sizeof(char *));
+  uint32_t *hashes = realloc(in->hashes, capacity * sizeof(uint32_t));
+
+  if (strings == NULL || hashes == NULL) {
+    abort();
+  }
+
+  in->strings = strings;
+  in->hashes = hashes;
+  in->capacity = capacity;
+}
+
+int intern_reserve(Intern *in, int count) {
+  if (in == NULL || count < 0) {
+    return -1;
+  }
+
+  uint32_t capacity = in->size + (uint32_t) count;
+
+  if (capacity >= INTERN_NONE / 2) {
+    return -1;
+  }
+
+  if (capacity > in->capacity) {
+    __intern_grow(in, capacity);
+  }
+
+  // slots for the capacity at most half full
+  uint32_t slots = INTERN_CAPACITY * 2;
+
+  while (slots < capacity * 2) {
+    slots *= 2;
+  }
+
+  if (in->slots == NULL || slots > in->mask + 1) {
+    __intern_rehash(in, slots);
+  }
+
+  return 0;
+}
+
+// hashes the strings loaded at once into slots at most half full
+static void __intern_index(Intern *in) {
+  for (uint32_t id = in->indexed; id < in->size; id++) {
+    in->hashes[id] = __intern_hash(in->strings[id]);
+  }
+
+  in->indexed = in->size;
+
+  uint32_t slots = INTERN_CAPACITY * 2;
+
+  while (slots < in->size * 2) {
+    slots *= 2;
+  }
+
+  __intern_rehash(in, slots);
+}
+
+InternId intern_id(Intern *in, const char *s) {
+  if (in == NULL || s == NULL) {
+    return INTERN_NONE;
+  }
+
+  if (in->indexed < in->size) {
+    __intern_index(in);
+  }
+
+  uint32_t hash = __intern_hash(s);
+
+  if (in->slots != NULL) {
+    for (uint32_t i = hash & in->mask; in->slots[i].id != 0; i = (i + 1) & in->mask) {
+      uint32_t id = in->slots[i].id - 1;
+
+      if (in->slots[i].hash == hash && strcmp(in->strings[id], s) == 0) {
+        return id;
+      }
+    }
+  }
+
+  // the last id is INTERN_NONE
+  if (in->size == INTERN_NONE - 1) {
+    return INTERN_NONE;
+  }
+
+  if (in->size == in->capacity) {
+    __intern_grow(in, in->capacity == 0 ? INTERN_CAPACITY : in->capacity * 2);
+  }
+
+  uint32_t id = in->size++;
+
+  in->strings[id] = arena_strdup(in->arena, s);
+  in->hashes[id] = hash;
+  in->indexed = in->size;
+
+  // keep the slots at most half full
+  if (in->slots == NULL || in->size * 2 > in->mask + 1) {
+    __intern_rehash(in, in->slots == NULL ? INTERN_CAPACITY * 2 : (in->mask + 1) * 2);
+  } else {
+    uint32_t i = hash & in->mask;
+
+    while (in->slots[i].id != 0) {
+      i = (i + 1) & in->mask;
+    }
+
+    in->slots[i].hash = hash;
+    in->slots[i].id = id + 1;
+  }
+
+  return id;
+}
+
+int intern_load(Intern *in, const char *strings, size_t size, const uint64_t *offsets, int count) {
+  if (in == NULL || in->size != 0 || count < 0 || (count > 0 && (strings == NULL || offsets == NULL))) {
+    return -1;
+  }
+
+  if (count == 0) {
+    return 0;
+  }
+
+  // every string ends within the block
+  if (size == 0 || strings[size - 1] != '\0' || (uint32_t) count >= INTERN_NONE / 2) {
+    return -1;
+  }
+
+  for (int i = 0; i < count; i++) {
+    if (offsets[i] >= size) {
+      return -1;
+    }
+  }
+
+  char *block = arena_alloc(in->arena, size);
+
+  memcpy(block, strings, size);
+
+  if ((uint32_t) count > in->capacity) {
+    __intern_grow(in, (uint32_t) count);
+  }
+
+  for (int i = 0; i < count; i++) {
+    in->strings[i] = block + offsets[i];
+  }
+
+  in->size = (uint32_t) count;
+  return 0;
+}
+
+const char *intern_string(Intern *in, InternId id) {
+  if (in == NULL || id >= in->size) {
+    return NULL;
+  }
+
+  return in->strings[id];
+}
+
+int intern_size(Intern *in) {
+  return in == NULL ? 0 : (int) in->size;
+}
@@ -0,0 +1,77 @@
+#ifndef RYJEN_OS_INTERN_H
+#define RYJEN_OS_INTERN_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "arena.h"
+
+// the id of no string
+#define INTERN_NONE UINT32_MAX
+
+// An interning table type
+typedef struct intern Intern;
+
+// the id of an interned string, numbered from 0 in order of interning
+typedef uint32_t InternId;
+
+/**
+ * Allocates a new interning table, mapping each distinct string to
+ * a 32-bit id so equal strings are stored once
+ * @param Arena the arena to copy the strings into
+ * @return the table instance
+ */
+Intern *new_intern(Arena *);
+
+/**
+ * Destroys an interning table instance, the strings are freed with
+ * the arena
+ * @param Intern the table instance
+ */
+void delete_intern(Intern *);
+
+/**
+ * Gets the id of a string, interning it if it is new
+ * NOTE: O(1) expected
+ * @param Intern the table instance
+ * @param char* the string
+ * @return the id, INTERN_NONE on error
+ */
+InternId intern_id(Intern *, const char *);
+
+/**
+ * Makes room for more strings, so interning them does not rehash
+ * @param Intern the table instance
+ * @param int the number of strings to make room for
+ * @return 0 on success, -1 on error
+ */
+int intern_reserve(Intern *, int);
+
+/**
+ * Interns distinct strings at once into an empty table, copying them in
+ * one block.  The strings are hashed on the next lookup rather than now.
+ * @param Intern the table instance
+ * @param char* the block of strings, each terminated
+ * @param size_t the bytes of the block
+ * @param uint64_t the offset of each string in the block, in id order
+ * @param int the number of strings
+ * @return 0 on success, -1 on error
+ */
+int intern_load(Intern *, const char *, size_t, const uint64_t *, int);
+
+/**
+ * Gets the string of an id
+ * @param Intern the table instance
+ * @param InternId the id
+ * @return the string, NULL if there is none
+ */
+const char *intern_string(Intern *, InternId);
+
+/**
+ * Gets the number of distinct strings
+ * @param Intern the table instance
+ * @return the number of strings
+ */
+int intern_size(Intern *);
+
+#endif
@@ -0,0 +1,612 @@
+#define _DEFAULT_SOURCE
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <limits.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "types.h"
+#include "loader.h"
+#include "scheduler.h"
+#include "process.h"
+#include "workload.h"
+
+// the least bytes parsed by a thread
+#define LOADER_CHUNK (1 << 20)
+
+// the most threads parsing at once
+#define LOADER_THREADS 16
+
+// the bytes read at once from input that can not be mapped
+#define LOADER_BLOCK (1 << 20)
+
+// a parsed line, pointing into the input
+typedef struct loader_record {
+  // the name, not terminated
+  const char *name;
+  // the group, not terminated (NULL for none)
+  const char *group;
+  // the I/O bursts, not terminated (NULL for none)
+  const char *io;
+  // the length of the I/O bursts
+  int io_length;
+  int arrival;
+  int service;
+  int priority;
+  int deadline;
+  // the lengths of the name and group
+  unsigned char name_length;
+  unsigned char group_length;
+} LoaderRecord;
+
+// a range of lines parsed by one thread
+typedef struct loader_chunk {
+  // the first byte and the byte after the last line
+  const char *begin;
+  const char *end;
+  // the parsed lines, in order
+  LoaderRecord *records;
+  // the number of records
+  int size;
+  // the allocated number of records
+  int capacity;
+  // the number of lines, blank or not
+  long long lines;
+  // the line in the chunk of the first error (0 for none)
+  long long error;
+  // describes the error
+  const char *message;
+  // the thread parsing the chunk
+  pthread_t thread;
+  // whether the thread was started
+  int started;
+} LoaderChunk;
+
+// the whole input in memory
+typedef struct loader_input {
+  // the bytes of the input
+  char *data;
+  // the number of bytes
+  size_t size;
+  // whether the data is mapped rather than allocated
+  int mapped;
+} LoaderInput;
+
+static int __loader_space(char c) {
+  return c == ' ' || c == '\t' || c == '\r' || c == '\v' || c == '\f';
+}
+
+// finds the next token of a line, returns the position after it
+static const char *__loader_token(const char *s, const char *end, const char **token, int *length) {
+  while (s < end && __loader_space(*s)) {
+    s++;
+  }
+
+  const char *begin = s;
+
+  while (s < end && !__loader_space(*s)) {
+    s++;
+  }
+
+  *token = begin;
+  *length = (int) (s - begin < INT_MAX ? s - begin : INT_MAX);
+  return s;
+}
+
+// parses a decimal integer token
+static int __loader_int(const char *token, int length, int *value) {
+  int i = 0;
+  int negative = 0;
+
+  if (length > 0 && (token[0] == '-' || token[0] == '+')) {
+    negative = token[0] == '-';
+    i++;
+  }
+
+  if (i == length) {
+    return -1;
+  }
+
+  long long result = 0;
+
+  for (; i < length; i++) {
+    if (token[i] < '0' || token[i] > '9') {
+      return -1;
+    }
+
+    result = result * 10 + (token[i] - '0');
+
+    if (result > (long long) INT_MAX + 1) {
+      return -1;
+    }
+  }
+
+  result = negative ? -result : result;
+
+  if (result > INT_MAX) {
+    return -1;
+  }
+
+  *value = (int) result;
+  return 0;
+}
+
+// parses an optional integer token, leaving the default for none or a -
+static int __loader_column(const char *token, int length, int *value) {
+  if (length == 0 || (length == 1 && token[0] == '-')) {
+    return 0;
+  }
+
+  return __loader_int(token, length, value);
+}
+
+/**
+ * parses a line into a record
+ * @return 0 on success, 1 for a blank line, otherwise -1 with a message
+ */
+static int __loader_parse_line(const char *line, const char *end, LoaderRecord *record, const char **message) {
+  const char *token;
+  int length;
+
+  const char *s = __loader_token(line, end, &token, &length);
+
+  if (length == 0) {
+    return 1;
+  }
+
+  *message = "invalid format";
+
+  if (length > LOADER_NAME_MAX) {
+    return -1;
+  }
+
+  record->name = token;
+  record->name_length = (unsigned char) length;
+
+  s = __loader_token(s, end, &token, &length);
+
+  if (__loader_int(token, length, &record->arrival)) {
+    return -1;
+  }
+
+  s = __loader_token(s, end, &token, &length);
+
+  if (__loader_int(token, length, &record->service)) {
+    return -1;
+  }
+
+  record->priority = PROCESS_DEFAULT_PRIORITY;
+  record->deadline = 0;
+
+  s = __loader_token(s, end, &token, &length);
+
+  if (__loader_column(token, length, &record->priority)) {
+    return -1;
+  }
+
+  s = __loader_token(s, end, &token, &length);
+
+  if (__loader_column(token, length, &record->deadline)) {
+    return -1;
+  }
+
+  s = __loader_token(s, end, &token, &length);
+
+  if (length > LOADER_NAME_MAX) {
+    return -1;
+  }
+
+  record->group = length == 0 || (length == 1 && token[0] == '-') ? NULL : token;
+  record->group_length = (unsigned char) length;
+
+  // checked against the service time once the process is created
+  __loader_token(s, end, &token, &length);
+
+  record->io = length == 0 || (length == 1 && token[0] == '-') ? NULL : token;
+  record->io_length = length;
+
+  if (record->priority < 0 || record->priority >= PROCESS_PRIORITIES) {
+    *message = "priority must be between 0 and 139";
+    return -1;
+  }
+
+  if (record->deadline < 0) {
+    *message = "deadline must not be negative";
+    return -1;
+  }
+
+  return 0;
+}
+
+// parses the lines of a chunk, stopping at the first error
+static void *__loader_parse_chunk(void *arg) {
+  LoaderChunk *chunk = (LoaderChunk *) arg;
+
+  // a guess of the lines in the chunk, grown as needed
+  chunk->capacity = (int) ((chunk->end - chunk->begin) / 16 + 16 < INT_MAX / 2 ? (chunk->end - chunk->begin) / 16 + 16 : INT_MAX / 2);
+  chunk->records = malloc((size_t) chunk->capacity * sizeof(LoaderRecord));
+
+  if (chunk->records == NULL) {
+    abort();
+  }
+
+  const char *s = chunk->begin;
+
+  while (s < chunk->end) {
+    const char *eol = memchr(s, '\n', chunk->end - s);
+
+    if (eol == NULL) {
+      eol = chunk->end;
+    }
+
+    chunk->lines++;
+
+    if (chunk->size == chunk->capacity) {
+      if (chunk->capacity == INT_MAX) {
+        chunk->error = chunk->lines;
+        chunk->message = "too many processes";
+        return NULL;
+      }
+
+      chunk->capacity = chunk->capacity > INT_MAX / 2 ? INT_MAX : chunk->capacity * 2;
+
+      LoaderRecord *records = realloc(chunk->records, (size_t) chunk->capacity * sizeof(LoaderRecord));
+
+      if (records == NULL) {
+        abort();
+      }
+
+      chunk->records = records;
+    }
+
+    int err = __loader_parse_line(s, eol, &chunk->records[chunk->size], &chunk->message);
+
+    if (err == -1) {
+      chunk->error = chunk->lines;
+      return NULL;
+    }
+
+    chunk->size += err == 0;
+
+    s = eol + 1;
+  }
+
+  return NULL;
+}
+
+// maps a regular file, otherwise reads the whole input in blocks
+static int __loader_read(int fd, LoaderInput *input) {
+  struct stat st;
+
+  input->data = NULL;
+  input->size = 0;
+  input->mapped = 0;
+
+  if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0) {
+    void *data = mmap(NULL, (size_t) st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+    if (data != MAP_FAILED) {
+      madvise(data, (size_t) st.st_size, MADV_SEQUENTIAL);
+
+      input->data = data;
+      input->size = (size_t) st.st_size;
+      input->mapped = 1;
+      return 0;
+    }
+  }
+
+  size_t capacity = 0;
+
+  for (;;) {
+    if (input->size == capacity) {
+      capacity = capacity == 0 ? LOADER_BLOCK : capacity * 2;
+
+      char *data = realloc(input->data, capacity);
+
+      if (data == NULL) {
+        abort();
+      }
+
+      input->data = data;
+    }
+
+    ssize_t n = read(fd, input->data + input->size, capacity - input->size);
+
+    if (n == 0) {
+      return 0;
+    }
+
+    if (n < 0) {
+      free(input->data);
+      input->data = NULL;
+      return -1;
+    }
+
+    input->size += (size_t) n;
+  }
+}
+
+static void __loader_release(LoaderInput *input) {
+  if (input->mapped) {
+    munmap(input->data, input->size);
+  } else {
+    free(input->data);
+  }
+}
+
+// creates the processes of the parsed chunks in order
+static int __loader_create(ProcessTable *t, LoaderChunk *chunks, int count) {
+  long long total = 0;
+
+  for (int i = 0; i < count; i++) {
+    total += chunks[i].size;
+  }
+
+  if (total > INT_MAX) {
+    puts("too many processes");
+    return -1;
+  }
+
+  // created without moving the table columns
+  if (process_table_reserve(t, (int) total)) {
+    puts("unable to reserve processes");
+    return -1;
+  }
+
+  char name[LOADER_NAME_MAX + 1];
+  char group[LOADER_NAME_MAX + 1];
+
+  for (int i = 0; i < count; i++) {
+    for (int j = 0; j < chunks[i].size; j++) {
+      LoaderRecord *r = &chunks[i].records[j];
+
+      memcpy(name, r->name, r->name_length);
+      name[r->name_length] = '\0';
+
+      Process *p = process_table_new_process(t, name);
+
+      if (p == NULL || process_set_arrival_time(p, r->arrival) || process_set_service_time(p, r->service)
+          || process_set_priority(p, r->priority) || process_set_deadline(p, r->deadline)) {
+        puts("unable to create process");
+        return -1;
+      }
+
+      if (r->group != NULL) {
+        memcpy(group, r->group, r->group_length);
+        group[r->group_length] = '\0';
+
+        if (process_set_group(p, group)) {
+          puts("unable to set process group");
+          return -1;
+        }
+      }
+
+      if (r->io != NULL && process_add_io_bursts(p, r->io, r->io_length)) {
+        printf("invalid I/O bursts of process %s\n", name);
+        return -1;
+      }
+    }
+
+    // done with the chunk
+    free(chunks[i].records);
+    chunks[i].records = NULL;
+  }
+
+  return (int) total;
+}
+
+// parses text in chunks on several threads, then creates the processes
+static int __loader_parse_text(ProcessTable *t, LoaderInput *input) {
+  long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+
+  int count = (int) (input->size / LOADER_CHUNK + 1);
+
+  count = count > cpus ? (int) (cpus > 0 ? cpus : 1) : count;
+  count = count > LOADER_THREADS ? LOADER_THREADS : count;
+
+  LoaderChunk chunks[LOADER_THREADS];
+
+  memset(chunks, 0, sizeof(chunks));
+
+  // split at line ends near equal sizes
+  const char *end = input->data + input->size;
+  const char *begin = input->data;
+
+  for (int i = 0; i < count; i++) {
+    const char *split = i == count - 1 ? end : input->data + input->size / count * (i + 1);
+
+    if (split < begin) {
+      split = begin;
+    }
+
+    if (split < end) {
+      const char *eol = memchr(split, '\n', end - split);
+
+      split = eol == NULL ? end : eol + 1;
+    }
+
+    chunks[i].begin = begin;
+    chunks[i].end = split;
+
+    begin = split;
+  }
+
+  // the first chunk is parsed on this thread
+  for (int i = 1; i < count; i++) {
+    chunks[i].started = pthread_create(&chunks[i].thread, NULL, __loader_parse_chunk, &chunks[i]) == 0;
+  }
+
+  __loader_parse_chunk(&chunks[0]);
+
+  for (int i = 1; i < count; i++) {
+    if (chunks[i].started) {
+      pthread_join(chunks[i].thread, NULL);
+    } else {
+      __loader_parse_chunk(&chunks[i]);
+    }
+  }
+
+  // report the first invalid line of the input
+  long long line = 0;
+
+  int err = 0;
+
+  for (int i = 0; i < count && err == 0; i++) {
+    if (chunks[i].error) {
+      printf("line %lld : %s\n", line + chunks[i].error, chunks[i].message);
+      err = -1;
+    }
+
+    line += chunks[i].lines;
+  }
+
+  int created = err ? -1 : __loader_create(t, chunks, count);
+
+  for (int i = 0; i < count; i++) {
+    free(chunks[i].records);
+  }
+
+  return created;
+}
+
+// adds the columns of a binary workload to the table at once
+static int __loader_read_binary(ProcessTable *t, LoaderInput *input) {
+  Workload w;
+
+  if (workload_view(input->data, input->size, &w)) {
+    puts("invalid binary workload");
+    return -1;
+  }
+
+  if (workload_append(t, &w) == -1) {
+    puts("unable to add the workload");
+    return -1;
+  }
+
+  return w.count;
+}
+
+int loader_read_table(ProcessTable *t, const char *path) {
+  if (t == NULL) {
+    return -1;
+  }
+
+  int stdin_input = path == NULL || strcmp(path, "-") == 0;
+
+  int fd = stdin_input ? STDIN_FILENO : open(path, O_RDONLY);
+
+  if (fd == -1) {
+    printf("unable to open %s\n", path);
+    return -1;
+  }
+
+  LoaderInput input;
+
+  int err = __loader_read(fd, &input);
+
+  if (!stdin_input) {
+    close(fd);
+  }
+
+  if (err) {
+    puts("unable to read processes");
+    return -1;
+  }
+
+  int count = 0;
+
+  if (workload_is_binary(input.data, input.size)) {
+    count = __loader_read_binary(t, &input);
+  } else if (input.size > 0) {
+    count = __loader_parse_text(t, &input);
+  }
+
+  __loader_release(&input);
+
+  return count;
+}
+
+int loader_load_processes(Scheduler *sched, const char *path) {
+  ProcessTable *t = scheduler_processes(sched);
+
+  if (t == NULL) {
+    return -1;
+  }
+
+  int first = process_table_size(t);
+
+  int count = loader_read_table(t, path);
+
+  if (count <= 0) {
+    return count == 0 ? 1 : -1;
+  }
+
+  Process **processes = malloc((size_t) count * sizeof(Process *));
+
+  if (processes == NULL) {
+    abort();
+  }
+
+  for (int i = 0; i < count; i++) {
+    processes[i] = process_table_get(t, (ProcessId) (first + i));
+  }
+
+  int err = scheduler_add_processes(sched, processes, count);
+
+  free(processes);
+
+  if (err) {
+    puts("unable to add processes to scheduler");
+    return -1;
+  }
+
+  return 0;
+}
+
+const char *loader_argument(int *argc, char *argv[]) {
+  if (argc == NULL || argv == NULL) {
+    return NULL;
+  }
+
+  for (int i = 1; i + 1 < *argc; i++) {
+    if (strcmp(argv[i], "-f") == 0) {
+      const char *path = argv[i + 1];
+
+      // shift the rest, keeping the terminating NULL
+      for (int j = i; j + 2 <= *argc; j++) {
+        argv[j] = argv[j + 2];
+      }
+
+      *argc -= 2;
+      return path;
+    }
+  }
+
+  return NULL;
+}
+
+int loader_options(int *argc, char *argv[], LoaderOptions *options) {
+  if (argc == NULL || argv == NULL || options == NULL) {
+    return -1;
+  }
+
+  options->workload = loader_argument(argc, argv);
+
+  return scheduler_switch_argument(argc, argv, &options->cost);
+}
+
+int loader_setup(Scheduler *sched, const LoaderOptions *options) {
+  if (sched == NULL || options == NULL || scheduler_set_switch_cost(sched, &options->cost)) {
+    return -1;
+  }
+
+  // read the processes, without prompting from a workload file
+  int err = options->workload != NULL ? loader_load_processes(sched, options->workload)
+      : scheduler_read_processes(sched);
+
+  return err == -1 ? -1 : 0;
+}
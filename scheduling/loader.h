@@ -0,0 +1,70 @@
+#ifndef RYJEN_OS_LOADER_H
+#define RYJEN_OS_LOADER_H
+
+#include "types.h"
+#include "scheduler.h"
+
+// the longest name or group read, as scheduler_read_processes
+#define LOADER_NAME_MAX 99
+
+// the options every policy takes before its own arguments
+typedef struct loader_options {
+  // the workload file to load rather than prompt for (NULL to prompt)
+  const char *workload;
+  // the cost of switching between processes, free unless given
+  SwitchCost cost;
+} LoaderOptions;
+
+/**
+ * Loads processes from a workload file without prompting, in the format
+ * of scheduler_read_processes or the binary format of workload.h.  The
+ * file is mapped (or read in large blocks when it can not be), large text
+ * files are split into chunks parsed in parallel, and the processes are
+ * added to the scheduler at once.  Blank lines are skipped and an invalid
+ * line loads nothing.
+ * @param Scheduler the scheduler instance
+ * @param char* the path of the workload, NULL or "-" for standard input
+ * @return 0 if processes were added, 1 if not, -1 on error
+ */
+int loader_load_processes(Scheduler *, const char *);
+
+/**
+ * Reads processes from a workload file into a table, as
+ * loader_load_processes but without adding them to a scheduler.  A
+ * binary workload (see workload.h) is copied into the table by column.
+ * @param ProcessTable the table instance
+ * @param char* the path of the workload, NULL or "-" for standard input
+ * @return the number of processes read, -1 on error
+ */
+int loader_read_table(ProcessTable *, const char *);
+
+/**
+ * Finds a "-f <workload>" option in the arguments of a policy and removes
+ * it, so the remaining arguments are parsed as before
+ * @param int* the number of arguments, updated
+ * @param char* the arguments, updated
+ * @return the workload path, NULL if there is no option
+ */
+const char *loader_argument(int *, char *[]);
+
+/**
+ * Finds the options every policy takes, "-f <workload>" and
+ * "-c ticks[,cold_after,cold_ticks]", and removes them, so the remaining
+ * arguments are parsed as the policy's own
+ * @param int* the number of arguments, updated
+ * @param char* the arguments, updated
+ * @param LoaderOptions set to the options found
+ * @return 0 on success, -1 if an option is invalid
+ */
+int loader_options(int *, char *[], LoaderOptions *);
+
+/**
+ * Sets the switch cost of a scheduler and adds its processes, loaded from
+ * the workload of the options or read from standard input with prompts
+ * @param Scheduler the scheduler instance
+ * @param LoaderOptions the options of the policy
+ * @return 0 on success, -1 on error
+ */
+int loader_setup(Scheduler *, const LoaderOptions *);
+
+#endif
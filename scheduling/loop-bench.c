@@ -0,0 +1,210 @@
+#define _POSIX_C_SOURCE 200809L
+#include <stdlib.h>
+#include <stdio.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/wait.h>
+
+#include "types.h"
+#include "scheduler.h"
+#include "process.h"
+#include "algorithm.h"
+#include "policy.h"
+
+// the default number of processes in the workload
+#define BENCH_PROCESSES 100000
+
+// the seed of the workload and the lottery
+#define BENCH_SEED 1
+
+// runs of each loop, the fastest is reported
+#define BENCH_REPEATS 3
+
+// creates an algorithm to benchmark
+typedef Algorithm *(*OnBenchAlgorithm)();
+
+static Algorithm *__bench_rr() {
+  return new_rr_algorithm(3);
+}
+
+static Algorithm *__bench_mlfq() {
+  return new_mlfq_algorithm(3, 3, 0);
+}
+
+// the shipped policies
+static const struct {
+  const char *name;
+  OnBenchAlgorithm create;
+} __bench_policies[] = {
+  { "fcfs", new_fcfs_algorithm },
+  { "str", new_str_algorithm },
+  { "spn", new_spn_algorithm },
+  { "rr", __bench_rr },
+  { "lottery", new_lottery_algorithm },
+  { "mlfq", __bench_mlfq },
+};
+
+// the result of one run
+typedef struct bench_result {
+  // wall time of the run in seconds
+  double seconds;
+  // ticks serviced
+  long long ticks;
+  // to check both loops made the same schedule
+  float turnaround;
+} BenchResult;
+
+static double __bench_now() {
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+
+  return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+// runs a workload of processes with a light load so queues stay short
+static int __bench_run(OnBenchAlgorithm create, int processes, int specialized, BenchResult *result) {
+  Algorithm *algo = create();
+
+  // fall back to calling through the algorithm
+  if (!specialized) {
+    algorithm_set_loop(algo, NULL);
+  }
+
+  Scheduler *sched = new_scheduler(algo);
+
+  scheduler_set_quiet(sched, 1);
+
+  srand(BENCH_SEED);
+
+  int arrival = 0;
+
+  result->ticks = 0;
+
+  for (int i = 0; i < processes; i++) {
+    char name[16];
+
+    snprintf(name, sizeof(name), "P%d", i);
+
+    Process *p = scheduler_new_process(sched, name);
+
+    int service = 1 + rand() % 4;
+
+    arrival += rand() % 7;
+
+    if (process_set_arrival_time(p, arrival) || process_set_service_time(p, service)
+        || scheduler_add_process(sched, p)) {
+      return -1;
+    }
+
+    result->ticks += service;
+  }
+
+  // the lottery draws the same tickets with either loop
+  srand(BENCH_SEED);
+
+  double start = __bench_now();
+
+  int err = scheduler_run_serial(sched);
+
+  result->seconds = __bench_now() - start;
+  result->turnaround = scheduler_avg_turnaround_time(sched);
+
+  delete_scheduler(sched);
+
+  return err;
+}
+
+// runs in a child process so every run starts with a fresh heap
+static int __bench_fork(OnBenchAlgorithm create, int processes, int specialized, BenchResult *result) {
+  int fds[2];
+
+  if (pipe(fds)) {
+    return -1;
+  }
+
+  pid_t pid = fork();
+
+  if (pid == -1) {
+    close(fds[0]);
+    close(fds[1]);
+    return -1;
+  }
+
+  if (pid == 0) {
+    close(fds[0]);
+
+    int err = __bench_run(create, processes, specialized, result);
+
+    if (err || write(fds[1], result, sizeof(BenchResult)) != sizeof(BenchResult)) {
+      _exit(1);
+    }
+    _exit(0);
+  }
+
+  close(fds[1]);
+
+  ssize_t n = read(fds[0], result, sizeof(BenchResult));
+
+  close(fds[0]);
+
+  int status;
+
+  if (waitpid(pid, &status, 0) == -1 || !WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+    return -1;
+  }
+
+  return n == sizeof(BenchResult) ? 0 : -1;
+}
+
+int main(int argc, char *argv[]) {
+
+  int processes = BENCH_PROCESSES;
+
+  if (argc > 1) {
+    processes = atoi(argv[1]);
+
+    if (processes < 1) {
+      puts("invalid argument");
+      return 1;
+    }
+  }
+
+  printf("%-8s %10s %14s %14s %8s\n", "Policy", "Ticks", "Dynamic/s", "Specialized/s", "Speedup");
+
+  for (size_t i = 0; i < sizeof(__bench_policies) / sizeof(__bench_policies[0]); i++) {
+    BenchResult dynamic, specialized, result;
+
+    if (__bench_fork(__bench_policies[i].create, processes, 0, &dynamic)
+        || __bench_fork(__bench_policies[i].create, processes, 1, &specialized)) {
+      printf("%s : unable to run\n", __bench_policies[i].name);
+      return 1;
+    }
+
+    // alternate the loops, keeping the fastest run of each
+    for (int j = 2; j < BENCH_REPEATS * 2; j++) {
+      BenchResult *best = j % 2 ? &specialized : &dynamic;
+
+      if (__bench_fork(__bench_policies[i].create, processes, j % 2, &result)) {
+        printf("%s : unable to run\n", __bench_policies[i].name);
+        return 1;
+      }
+
+      if (result.seconds < best->seconds) {
+        *best = result;
+      }
+    }
+
+    if (dynamic.turnaround != specialized.turnaround) {
+      printf("%s : the loops made different schedules\n", __bench_policies[i].name);
+      return 1;
+    }
+
+    double a = dynamic.ticks / dynamic.seconds;
+    double b = specialized.ticks / specialized.seconds;
+
+    printf("%-8s %10lld %14.0f %14.0f %7.2fx\n", __bench_policies[i].name, dynamic.ticks, a, b, b / a);
+  }
+
+  return 0;
+}
@@ -8,6 +8,9 @@
 #include "queue.h"
 #include "process.h"
 #include "algorithm.h"
+#include "policy.h"
+#include "loader.h"
+#include "scheduler_loop.h"
 
 // global number of tickets
 #define NUM_TICKETS 100
@@ -64,6 +67,24 @@ static int __lottery_arrive(Process *p, void *arg) {
   return l->on_distribution(l);
 }
 
+static int __lottery_arrive_batch(Process **batch, int n, void *arg) {
+  if (batch == NULL || arg == NULL) {
+    return -1;
+  }
+
+  Lottery *l = (Lottery*) arg;
+
+  // put every arrival on the queue
+  for (int i = 0; i < n; i++) {
+    if (batch[i] == NULL || queue_push_back(l->queue, batch[i])) {
+      return -1;
+    }
+  }
+
+  // and redistribute once
+  return l->on_distribution(l);
+}
+
 static int __lottery_ready(void *arg) {
   if (arg == NULL) {
     return -1;
@@ -172,8 +193,39 @@ int  __distribution_service_time(Lottery *l) {
 }
 
 
+SCHEDULER_LOOP_BATCH(__lottery_loop, __lottery_arrive_batch, __lottery_ready, __lottery_get, __lottery_put, scheduler_loop_tick)
+
+// destroys the data with the algorithm
+static void __lottery_delete(void *arg) {
+  delete_lottery((Lottery *) arg);
+}
+
+Algorithm *new_lottery_algorithm() {
+  Lottery *data = new_lottery(__distribution_service_time);
+
+  Algorithm *algo = new_algorithm(__lottery_arrive, __lottery_ready, __lottery_get, __lottery_put, data);
+
+  algorithm_set_on_delete(algo, __lottery_delete);
+
+  algorithm_set_on_arrive_batch(algo, __lottery_arrive_batch);
+
+  algorithm_set_loop(algo, __lottery_loop);
+
+  return algo;
+}
+
+#ifndef POLICY_LIBRARY
+
 int main(int argc, char *argv[]) {
 
+  // the workload file and switch cost, taken out of the arguments
+  LoaderOptions options;
+
+  if (loader_options(&argc, argv, &options)) {
+    puts("invalid argument");
+    return 1;
+  }
+
   if (argc > 1) {
     int seed = atoi(argv[1]);
     srand(seed);
@@ -181,17 +233,17 @@ int main(int argc, char *argv[]) {
     srand(time(0));
   }
 
-  // a new lottery
-  Lottery *lottery = new_lottery(__distribution_service_time);
-
   // create the algorithm
-  Algorithm *algo = new_algorithm(__lottery_arrive, __lottery_ready, __lottery_get, __lottery_put, lottery);
+  Algorithm *algo = new_lottery_algorithm();
 
   // create the scheduler
   Scheduler *sched = new_scheduler(algo);
 
-  // read the processes
-  scheduler_read_processes(sched);
+  // set the switch cost and read the processes
+  if (loader_setup(sched, &options)) {
+    delete_scheduler(sched);
+    return 1;
+  }
 
   // run
   int result = scheduler_run(sched);
@@ -199,8 +251,7 @@ int main(int argc, char *argv[]) {
   // cleanup
   delete_scheduler(sched);
 
-  delete_lottery(lottery);
-
   return result;
 }
 
+#endif
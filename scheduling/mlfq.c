@@ -1,26 +1,45 @@
 #include <stdlib.h>
 #include <stdio.h>
+#include <string.h>
+#include <limits.h>
 
 #include "types.h"
 #include "scheduler.h"
 #include "queue.h"
 #include "algorithm.h"
+#include "policy.h"
+#include "loader.h"
+#include "scheduler_loop.h"
 #include "process.h"
+#include "bitmap.h"
 
 typedef struct mlfq MLFQ;
 
+// a callback to compute the quantum of a queue level from the initial quantum
+typedef int (*OnQuantum)(int, int);
+
 struct mlfq {
   // an array of queues
   Queue **queues;
   // size of the array
   int size;
-  // current queue index
-  int current_index;
+  // a bit for each non empty queue
+  Bitmap *ready;
   // an array of queue quantums
   int *quantums;
+  // ticks between boosting all processes to the top level (0 to disable)
+  int boost;
+  // the tick of the next boost
+  int next_boost;
+  // ticks serviced by the algorithm
+  int clock;
+  // the process last given a time slice
+  Process *running;
+  // the process tick when the time slice was given
+  int mark;
 };
 
-MLFQ *new_mlfq(int size, int initial_quantum) {
+MLFQ *new_mlfq(int size, int initial_quantum, int boost, OnQuantum quantum) {
   MLFQ *val = (MLFQ*) malloc(sizeof(MLFQ));
 
   if (val == NULL) {
@@ -30,13 +49,20 @@ MLFQ *new_mlfq(int size, int initial_quantum) {
   val->queues = calloc(size, sizeof(Queue*));
   val->quantums = calloc(size, sizeof(int));
   val->size = size;
-  val->current_index = 0;
+  val->ready = new_bitmap(size);
+  val->boost = boost;
+  val->next_boost = boost;
+  val->clock = 0;
+  val->running = NULL;
+  val->mark = 0;
+
+  if (val->queues == NULL || val->quantums == NULL || val->ready == NULL) {
+    abort();
+  }
 
   for (int i = 0; i < size; i++) {
     val->queues[i] = new_queue();
-    val->quantums[i] = initial_quantum;
-    // increment the quantum for each queue TODO: use callback
-    initial_quantum += initial_quantum;
+    val->quantums[i] = quantum(i, initial_quantum);
   }
   return val;
 }
@@ -54,9 +80,56 @@ void delete_mlfq(MLFQ *q) {
 
   free(q->quantums);
 
+  delete_bitmap(q->ready);
+
   free(q);
 }
 
+// doubles the quantum for each lower level queue
+static int __quantum_doubling(int level, int quantum) {
+  for (int i = 0; i < level && quantum < INT_MAX; i++) {
+    quantum = quantum > INT_MAX / 2 ? INT_MAX : quantum * 2;
+  }
+  return quantum;
+}
+
+// uses the same quantum for every queue
+static int __quantum_fixed(int level, int quantum) {
+  (void) level;
+  return quantum;
+}
+
+// adds the service time of the last time slice to the clock
+static void __mlfq_account(MLFQ *data) {
+  if (data->running == NULL) {
+    return;
+  }
+
+  // NOTE: completed processes are never put back, so the next get does this
+  data->clock += process_current_tick(data->running) - data->mark;
+  data->running = NULL;
+}
+
+// moves every lower level queue onto the top level queue
+static int __mlfq_boost(MLFQ *data) {
+
+  for (int level = bitmap_next(data->ready, 1); level != -1; level = bitmap_next(data->ready, level + 1)) {
+
+    // relink the whole queue, processes reset their level when next taken
+    if (queue_concat(data->queues[0], data->queues[level])) {
+      return -1;
+    }
+
+    bitmap_clear(data->ready, level);
+
+    bitmap_set(data->ready, 0);
+  }
+
+  // schedule the next boost
+  data->next_boost = (data->clock / data->boost + 1) * data->boost;
+  return 0;
+}
+
 static int __mlfq_arrive(Process *p, void *arg) {
   if (p == NULL || arg == NULL) {
     return -1;
@@ -65,7 +138,11 @@ static int __mlfq_arrive(Process *p, void *arg) {
   MLFQ *data = (MLFQ*) arg;
 
   // always put on back of top level queue
-  return queue_push_back(data->queues[0], p);
+  if (process_set_level(p, 0) || queue_push_back(data->queues[0], p)) {
+    return -1;
+  }
+
+  return bitmap_set(data->ready, 0);
 }
 
 static int __mlfq_ready(void *arg) {
@@ -75,12 +152,7 @@ static int __mlfq_ready(void *arg) {
   MLFQ *data = (MLFQ *) arg;
 
   // any non empty queue
-  for (int i = 0; i < data->size; i++) {
-    if (!queue_is_empty(data->queues[i])) {
-      return 1;
-    }
-  }
-  return 0;
+  return !bitmap_is_empty(data->ready);
 }
 
 static Process *__mlfq_get(void *arg) {
@@ -90,18 +162,39 @@ static Process *__mlfq_get(void *arg) {
 
   MLFQ *data = (MLFQ*) arg;
 
-  // TODO: promote up from lower level queues if needed
+  __mlfq_account(data);
 
-  // first non empty queue from the top level
-  for (int i = 0; i < data->size; i++) {
-    if (!queue_is_empty(data->queues[i])) {
-      // track the current index (hacky)
-      data->current_index = i;
-      // return the first process in FIFO queue
-      return queue_pop_front(data->queues[i]);
+  // promote up from lower level queues if needed
+  if (data->boost > 0 && data->clock >= data->next_boost) {
+    if (__mlfq_boost(data)) {
+      return NULL;
     }
   }
-  return NULL;
+
+  // first non empty queue from the top level
+  int level = bitmap_first(data->ready);
+
+  if (level == -1) {
+    return NULL;
+  }
+
+  // return the first process in FIFO queue
+  Process *p = queue_pop_front(data->queues[level]);
+
+  if (queue_is_empty(data->queues[level])) {
+    bitmap_clear(data->ready, level);
+  }
+
+  // the process was boosted, so start a new quantum on this level
+  if (process_level(p) != level) {
+    process_set_level(p, level);
+    process_reset_ticks(p);
+  }
+
+  data->running = p;
+  data->mark = process_current_tick(p);
+
+  return p;
 }
 
 static int __mlfq_put(Process *p, void *arg) {
@@ -111,18 +204,23 @@ static int __mlfq_put(Process *p, void *arg) {
 
   MLFQ *data = (MLFQ*) arg;
 
-  // validate current index
-  if (data->current_index < 0 || data->current_index >= data->size) {
+  __mlfq_account(data);
+
+  // the level the process was taken from
+  int level = process_level(p);
+
+  // validate the level
+  if (level < 0 || level >= data->size) {
     return -1;
   }
 
-  // get the current queue
-  Queue *q = data->queues[data->current_index];
-
   // process has not reached the quantum...
-  if (process_current_tick(p) < data->quantums[data->current_index]) {
+  if (process_current_tick(p) < data->quantums[level]) {
     // keep on the current queue
-    return queue_push_front(q, p);
+    if (queue_push_front(data->queues[level], p)) {
+      return -1;
+    }
+    return bitmap_set(data->ready, level);
   }
 
   // otherwise, prempt
@@ -131,19 +229,81 @@ static int __mlfq_put(Process *p, void *arg) {
   }
 
   // if there is another queue, demote the process
-  int next_queue = data->current_index + 1;
-
-  if (next_queue < data->size) {
-    q = data->queues[next_queue];
+  if (level + 1 < data->size) {
+    level++;
   }
 
   // and put on back of FIFO queue
-  return queue_push_back(q, p);
+  if (process_set_level(p, level) || queue_push_back(data->queues[level], p)) {
+    return -1;
+  }
+
+  return bitmap_set(data->ready, level);
+}
+
+// run until the quantum of the level is reached, or the next boost
+static int __mlfq_slice(Process *p, void *arg) {
+  if (p == NULL || arg == NULL) {
+    return -1;
+  }
+
+  MLFQ *data = (MLFQ *) arg;
+
+  int ticks = data->quantums[process_level(p)] - process_current_tick(p);
+
+  if (data->boost > 0 && data->next_boost - data->clock < ticks) {
+    ticks = data->next_boost - data->clock;
+  }
+
+  return ticks;
+}
+
+SCHEDULER_LOOP(__mlfq_loop, __mlfq_arrive, __mlfq_ready, __mlfq_get, __mlfq_put, __mlfq_slice)
+
+// destroys the data with the algorithm
+static void __mlfq_delete(void *arg) {
+  delete_mlfq((MLFQ *) arg);
+}
+
+// allocates the algorithm with the quanta of the levels computed by a callback
+static Algorithm *__mlfq_algorithm(int queues, int quantum, int boost, OnQuantum on_quantum) {
+  MLFQ *data = new_mlfq(queues, quantum, boost, on_quantum);
+
+  Algorithm *algo = new_algorithm(__mlfq_arrive, __mlfq_ready, __mlfq_get, __mlfq_put, data);
+
+  algorithm_set_on_delete(algo, __mlfq_delete);
+
+  algorithm_set_on_slice(algo, __mlfq_slice);
+
+  algorithm_set_loop(algo, __mlfq_loop);
+
+  return algo;
+}
+
+Algorithm *new_mlfq_algorithm(int queues, int quantum, int boost) {
+  return __mlfq_algorithm(queues, quantum, boost, __quantum_doubling);
+}
+
+Algorithm *new_mlfq_fixed_algorithm(int queues, int quantum, int boost) {
+  return __mlfq_algorithm(queues, quantum, boost, __quantum_fixed);
 }
 
+#ifndef POLICY_LIBRARY
+
 int main(int argc, char *argv[]) {
+
+  // the workload file and switch cost, taken out of the arguments
+  LoaderOptions options;
+
+  if (loader_options(&argc, argv, &options)) {
+    puts("invalid argument");
+    return 1;
+  }
+
   int quantum = 3;
   int queues = 3;
+  int boost = 0;
+  int fixed = 0;
 
   if (argc > 1) {
     queues = atoi(argv[1]);
@@ -151,23 +311,39 @@ int main(int argc, char *argv[]) {
     if (argc > 2) {
       quantum = atoi(argv[2]);
     }
+
+    if (argc > 3) {
+      boost = atoi(argv[3]);
+    }
+
+    // the same quantum on every level rather than doubling
+    if (argc > 4) {
+      if (strcmp(argv[4], "fixed") == 0) {
+        fixed = 1;
+      } else if (strcmp(argv[4], "doubling") != 0) {
+        puts("invalid argument");
+        return 1;
+      }
+    }
   }
 
-  if (queues < 0 || quantum < 0) {
+  if (queues < 1 || queues > BITMAP_MAX || quantum < 0 || boost < 0) {
     puts("invalid argument");
     return 1;
   }
 
-  MLFQ *data = new_mlfq(queues, quantum);
-
   // create the algorithm
-  Algorithm *algo = new_algorithm(__mlfq_arrive, __mlfq_ready, __mlfq_get, __mlfq_put, data);
+  Algorithm *algo = fixed ? new_mlfq_fixed_algorithm(queues, quantum, boost)
+      : new_mlfq_algorithm(queues, quantum, boost);
 
   // create the scheduler
   Scheduler *sched = new_scheduler(algo);
 
-  // read the processes
-  scheduler_read_processes(sched);
+  // set the switch cost and read the processes
+  if (loader_setup(sched, &options)) {
+    delete_scheduler(sched);
+    return 1;
+  }
 
   // run
   int result = scheduler_run(sched);
@@ -175,8 +351,7 @@ int main(int argc, char *argv[]) {
   // cleanup
   delete_scheduler(sched);
 
-  delete_mlfq(data);
-
   return result;
 }
 
+#endif
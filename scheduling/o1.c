@@ -0,0 +1,266 @@
+#include <stdlib.h>
+#include <stdio.h>
+
+#include "types.h"
+#include "scheduler.h"
+#include "queue.h"
+#include "process.h"
+#include "algorithm.h"
+#include "policy.h"
+#include "loader.h"
+#include "scheduler_loop.h"
+#include "bitmap.h"
+
+// a priority array type
+typedef struct prio_array PrioArray;
+
+// an O(1) scheduler type
+typedef struct o1 O1;
+
+// a FIFO queue for each static priority
+struct prio_array {
+  // an array of queues indexed by priority
+  Queue *queues[PROCESS_PRIORITIES];
+  // a bit for each non empty queue
+  Bitmap *ready;
+  // the number of processes in the array
+  int count;
+};
+
+struct o1 {
+  // the storage for the active and expired arrays
+  PrioArray arrays[2];
+  // processes with time slice left
+  PrioArray *active;
+  // processes that have used their time slice
+  PrioArray *expired;
+  // the time slice for the default priority
+  int quantum;
+};
+
+static void __prio_array_init(PrioArray *array) {
+  for (int i = 0; i < PROCESS_PRIORITIES; i++) {
+    array->queues[i] = new_queue();
+  }
+  array->ready = new_bitmap(PROCESS_PRIORITIES);
+  array->count = 0;
+}
+
+static void __prio_array_destroy(PrioArray *array) {
+  for (int i = 0; i < PROCESS_PRIORITIES; i++) {
+    delete_queue_list(array->queues[i]);
+  }
+  delete_bitmap(array->ready);
+}
+
+O1 *new_o1(int quantum) {
+  O1 *o1 = (O1 *) malloc(sizeof(O1));
+
+  if (o1 == NULL) {
+    abort();
+  }
+
+  __prio_array_init(&o1->arrays[0]);
+  __prio_array_init(&o1->arrays[1]);
+
+  o1->active = &o1->arrays[0];
+  o1->expired = &o1->arrays[1];
+  o1->quantum = quantum;
+  return o1;
+}
+
+void delete_o1(O1 *o1) {
+  if (o1 == NULL) {
+    return;
+  }
+
+  __prio_array_destroy(&o1->arrays[0]);
+  __prio_array_destroy(&o1->arrays[1]);
+
+  free(o1);
+}
+
+// the time slice for a static priority, longer for more important processes
+static int __o1_timeslice(O1 *o1, int priority) {
+  int scale = priority < PROCESS_DEFAULT_PRIORITY ? 20 : 5;
+
+  // the default priority gets the quantum
+  int slice = o1->quantum * (PROCESS_PRIORITIES - priority) * scale / 100;
+
+  return slice < 1 ? 1 : slice;
+}
+
+static int __prio_array_push_back(PrioArray *array, Process *p) {
+  int priority = process_priority(p);
+
+  if (queue_push_back(array->queues[priority], p)) {
+    return -1;
+  }
+  array->count++;
+  return bitmap_set(array->ready, priority);
+}
+
+static int __prio_array_push_front(PrioArray *array, Process *p) {
+  int priority = process_priority(p);
+
+  if (queue_push_front(array->queues[priority], p)) {
+    return -1;
+  }
+  array->count++;
+  return bitmap_set(array->ready, priority);
+}
+
+static int __o1_arrive(Process *p, void *arg) {
+  if (p == NULL || arg == NULL) {
+    return -1;
+  }
+
+  O1 *o1 = (O1 *) arg;
+
+  // new arrivals have a full time slice
+  return __prio_array_push_back(o1->active, p);
+}
+
+static int __o1_ready(void *arg) {
+  if (arg == NULL) {
+    return -1;
+  }
+
+  O1 *o1 = (O1 *) arg;
+
+  return o1->active->count > 0 || o1->expired->count > 0;
+}
+
+static Process *__o1_get(void *arg) {
+  if (arg == NULL) {
+    return NULL;
+  }
+
+  O1 *o1 = (O1 *) arg;
+
+  // every process has used its time slice, so swap the arrays
+  if (o1->active->count == 0) {
+    PrioArray *array = o1->active;
+    o1->active = o1->expired;
+    o1->expired = array;
+  }
+
+  // the highest priority non empty queue
+  int priority = bitmap_first(o1->active->ready);
+
+  if (priority == -1) {
+    return NULL;
+  }
+
+  Queue *q = o1->active->queues[priority];
+
+  Process *p = queue_pop_front(q);
+
+  if (queue_is_empty(q)) {
+    bitmap_clear(o1->active->ready, priority);
+  }
+
+  o1->active->count--;
+
+  return p;
+}
+
+static int __o1_put(Process *p, void *arg) {
+  if (p == NULL || arg == NULL) {
+    return -1;
+  }
+
+  O1 *o1 = (O1 *) arg;
+
+  // process has time slice left...
+  if (process_current_tick(p) < __o1_timeslice(o1, process_priority(p))) {
+    // keep at the front of its queue, a higher priority will still run first
+    return __prio_array_push_front(o1->active, p);
+  }
+
+  // otherwise, prempt
+  if (process_prempt(p) == -1) {
+    return -1;
+  }
+
+  // and wait for the arrays to swap
+  return __prio_array_push_back(o1->expired, p);
+}
+
+// run until the time slice is used
+static int __o1_slice(Process *p, void *arg) {
+  if (p == NULL || arg == NULL) {
+    return -1;
+  }
+
+  O1 *o1 = (O1 *) arg;
+
+  return __o1_timeslice(o1, process_priority(p)) - process_current_tick(p);
+}
+
+SCHEDULER_LOOP(__o1_loop, __o1_arrive, __o1_ready, __o1_get, __o1_put, __o1_slice)
+
+// destroys the data with the algorithm
+static void __o1_delete(void *arg) {
+  delete_o1((O1 *) arg);
+}
+
+Algorithm *new_o1_algorithm(int quantum) {
+  O1 *data = new_o1(quantum);
+
+  Algorithm *algo = new_algorithm(__o1_arrive, __o1_ready, __o1_get, __o1_put, data);
+
+  algorithm_set_on_delete(algo, __o1_delete);
+
+  algorithm_set_on_slice(algo, __o1_slice);
+
+  algorithm_set_loop(algo, __o1_loop);
+
+  return algo;
+}
+
+#ifndef POLICY_LIBRARY
+
+int main(int argc, char *argv[]) {
+
+  // the workload file and switch cost, taken out of the arguments
+  LoaderOptions options;
+
+  if (loader_options(&argc, argv, &options)) {
+    puts("invalid argument");
+    return 1;
+  }
+
+  int quantum = 3;
+
+  if (argc > 1) {
+    quantum = atoi(argv[1]);
+
+    if (quantum < 1) {
+      puts("invalid argument");
+      return 1;
+    }
+  }
+
+  // create the algorithm
+  Algorithm *algo = new_o1_algorithm(quantum);
+
+  // create the scheduler
+  Scheduler *sched = new_scheduler(algo);
+
+  // set the switch cost and read the processes
+  if (loader_setup(sched, &options)) {
+    delete_scheduler(sched);
+    return 1;
+  }
+
+  // run
+  int result = scheduler_run(sched);
+
+  // cleanup
+  delete_scheduler(sched);
+
+  return result;
+}
+
+#endif
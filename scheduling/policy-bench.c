@@ -0,0 +1,374 @@
+#define _POSIX_C_SOURCE 200809L
+#define _DEFAULT_SOURCE
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+
+#include "types.h"
+#include "scheduler.h"
+#include "process.h"
+#include "algorithm.h"
+#include "policy.h"
+#include "loader.h"
+
+// the seed of the lottery
+#define BENCH_SEED 1
+
+// runs below this many processes are repeated, the fastest is reported
+#define BENCH_SMALL 1000000
+
+// runs of each small workload
+#define BENCH_REPEATS 3
+
+// the default percent a result may be worse than its baseline
+#define BENCH_THRESHOLD 10
+
+// the most results a baseline can hold
+#define BENCH_RESULTS 256
+
+// the header of the results
+#define BENCH_HEADER "policy,processes,ticks,dispatches,seconds,ticks_per_second,ns_per_dispatch,peak_rss_kb,allocations"
+
+// the allocations made since the counter was reset, counted by wrapping the allocator
+static long long __bench_allocations = 0;
+
+void *__real_malloc(size_t);
+void *__real_calloc(size_t, size_t);
+void *__real_realloc(void *, size_t);
+
+void *__wrap_malloc(size_t size) {
+  __bench_allocations++;
+  return __real_malloc(size);
+}
+
+void *__wrap_calloc(size_t count, size_t size) {
+  __bench_allocations++;
+  return __real_calloc(count, size);
+}
+
+void *__wrap_realloc(void *ptr, size_t size) {
+  __bench_allocations++;
+  return __real_realloc(ptr, size);
+}
+
+// creates an algorithm to benchmark
+typedef Algorithm *(*OnBenchAlgorithm)();
+
+static Algorithm *__bench_rr() {
+  return new_rr_algorithm(3);
+}
+
+static Algorithm *__bench_mlfq() {
+  return new_mlfq_algorithm(3, 3, 0);
+}
+
+// the shipped policies
+static const struct {
+  const char *name;
+  OnBenchAlgorithm create;
+} __bench_policies[] = {
+  { "fcfs", new_fcfs_algorithm },
+  { "spn", new_spn_algorithm },
+  { "str", new_str_algorithm },
+  { "rr", __bench_rr },
+  { "lottery", new_lottery_algorithm },
+  { "mlfq", __bench_mlfq },
+};
+
+// the result of one run
+typedef struct bench_result {
+  // the policy run
+  char policy[16];
+  // the processes in the workload
+  int processes;
+  // ticks serviced
+  long long ticks;
+  // time slices given to processes
+  long long dispatches;
+  // wall time of the run in seconds
+  double seconds;
+  // the peak resident set of the run in kilobytes
+  long peak_rss;
+  // allocations made by the run, not the load
+  long long allocations;
+} BenchResult;
+
+static double __bench_now() {
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+
+  return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+// loads a workload and runs it with the serial loop
+static int __bench_run(OnBenchAlgorithm create, const char *workload, BenchResult *result) {
+  Scheduler *sched = new_scheduler(create());
+
+  scheduler_set_quiet(sched, 1);
+
+  if (loader_load_processes(sched, workload) != 0) {
+    delete_scheduler(sched);
+    return -1;
+  }
+
+  ProcessColumns c;
+
+  if (process_table_columns(scheduler_processes(sched), &c)) {
+    delete_scheduler(sched);
+    return -1;
+  }
+
+  result->processes = c.size;
+  result->ticks = 0;
+
+  for (int i = 0; i < c.size; i++) {
+    result->ticks += c.service[i];
+  }
+
+  srand(BENCH_SEED);
+
+  __bench_allocations = 0;
+
+  double start = __bench_now();
+
+  int err = scheduler_run_serial(sched);
+
+  result->seconds = __bench_now() - start;
+  result->allocations = __bench_allocations;
+  result->dispatches = scheduler_dispatches(sched);
+
+  delete_scheduler(sched);
+
+  return err;
+}
+
+// runs in a child process so every run starts with a fresh heap and its own peak
+static int __bench_fork(OnBenchAlgorithm create, const char *workload, BenchResult *result) {
+  int fds[2];
+
+  if (pipe(fds)) {
+    return -1;
+  }
+
+  pid_t pid = fork();
+
+  if (pid == -1) {
+    close(fds[0]);
+    close(fds[1]);
+    return -1;
+  }
+
+  if (pid == 0) {
+    close(fds[0]);
+
+    int err = __bench_run(create, workload, result);
+
+    if (err || write(fds[1], result, sizeof(BenchResult)) != sizeof(BenchResult)) {
+      _exit(1);
+    }
+    _exit(0);
+  }
+
+  close(fds[1]);
+
+  ssize_t n = read(fds[0], result, sizeof(BenchResult));
+
+  close(fds[0]);
+
+  int status;
+  struct rusage usage;
+
+  if (wait4(pid, &status, 0, &usage) == -1 || !WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+    return -1;
+  }
+
+  result->peak_rss = usage.ru_maxrss;
+
+  return n == sizeof(BenchResult) ? 0 : -1;
+}
+
+static double __bench_ticks_per_second(const BenchResult *r) {
+  return r->seconds > 0 ? r->ticks / r->seconds : 0;
+}
+
+static double __bench_ns_per_dispatch(const BenchResult *r) {
+  return r->dispatches > 0 ? r->seconds * 1e9 / r->dispatches : 0;
+}
+
+static void __bench_write(FILE *out, const BenchResult *r) {
+  fprintf(out, "%s,%d,%lld,%lld,%.6f,%.0f,%.2f,%ld,%lld\n", r->policy, r->processes, r->ticks, r->dispatches,
+      r->seconds, __bench_ticks_per_second(r), __bench_ns_per_dispatch(r), r->peak_rss, r->allocations);
+}
+
+// reads the results of an earlier run, -1 if it can not be read
+static int __bench_read(const char *path, BenchResult *results, int size) {
+  FILE *in = fopen(path, "r");
+
+  if (in == NULL) {
+    perror(path);
+    return -1;
+  }
+
+  char line[256];
+  int count = 0;
+
+  while (count < size && fgets(line, sizeof(line), in) != NULL) {
+    BenchResult *r = &results[count];
+    double ticks_per_second, ns_per_dispatch;
+
+    // the header and anything else that is not a result
+    if (sscanf(line, "%15[^,],%d,%lld,%lld,%lf,%lf,%lf,%ld,%lld", r->policy, &r->processes, &r->ticks,
+        &r->dispatches, &r->seconds, &ticks_per_second, &ns_per_dispatch, &r->peak_rss, &r->allocations) == 9) {
+      count++;
+    }
+  }
+
+  fclose(in);
+  return count;
+}
+
+// checks a result against the same run of a baseline, 1 if it regressed
+static int __bench_compare(const BenchResult *r, const BenchResult *baseline, int count, double threshold) {
+  for (int i = 0; i < count; i++) {
+    const BenchResult *b = &baseline[i];
+
+    if (strcmp(b->policy, r->policy) != 0 || b->processes != r->processes) {
+      continue;
+    }
+
+    int regressed = 0;
+
+    if (__bench_ticks_per_second(r) < __bench_ticks_per_second(b) * (1 - threshold)) {
+      printf("  regression : %s %d ticks/s %.0f -> %.0f\n", r->policy, r->processes,
+          __bench_ticks_per_second(b), __bench_ticks_per_second(r));
+      regressed = 1;
+    }
+
+    if (r->peak_rss > b->peak_rss * (1 + threshold)) {
+      printf("  regression : %s %d peak rss %ld -> %ld kB\n", r->policy, r->processes, b->peak_rss, r->peak_rss);
+      regressed = 1;
+    }
+
+    if (r->allocations > b->allocations * (1 + threshold)) {
+      printf("  regression : %s %d allocations %lld -> %lld\n", r->policy, r->processes,
+          b->allocations, r->allocations);
+      regressed = 1;
+    }
+
+    return regressed;
+  }
+
+  return 0;
+}
+
+static void __bench_usage() {
+  puts("usage: policy-bench [-o results] [-b baseline] [-t percent] workload...");
+}
+
+int main(int argc, char *argv[]) {
+
+  const char *output = NULL;
+  const char *baseline_path = NULL;
+  double threshold = BENCH_THRESHOLD / 100.0;
+  int opt;
+
+  while ((opt = getopt(argc, argv, "o:b:t:")) != -1) {
+    switch (opt) {
+      case 'o':
+        output = optarg;
+        break;
+      case 'b':
+        baseline_path = optarg;
+        break;
+      case 't':
+        threshold = atof(optarg) / 100.0;
+
+        if (threshold <= 0) {
+          puts("invalid threshold");
+          return 1;
+        }
+        break;
+      default:
+        __bench_usage();
+        return 1;
+    }
+  }
+
+  if (optind == argc) {
+    __bench_usage();
+    return 1;
+  }
+
+  static BenchResult baseline[BENCH_RESULTS];
+  int baselines = 0;
+
+  if (baseline_path != NULL && (baselines = __bench_read(baseline_path, baseline, BENCH_RESULTS)) == -1) {
+    return 1;
+  }
+
+  FILE *out = NULL;
+
+  if (output != NULL) {
+    if ((out = fopen(output, "w")) == NULL) {
+      perror(output);
+      return 1;
+    }
+    fprintf(out, "%s\n", BENCH_HEADER);
+  }
+
+  printf("%-8s %10s %12s %14s %12s %10s %12s\n", "Policy", "Processes", "Ticks", "Ticks/s", "ns/dispatch",
+      "RSS (kB)", "Allocations");
+
+  int regressions = 0;
+
+  for (int w = optind; w < argc; w++) {
+    for (size_t i = 0; i < sizeof(__bench_policies) / sizeof(__bench_policies[0]); i++) {
+      BenchResult best, result;
+
+      if (__bench_fork(__bench_policies[i].create, argv[w], &best)) {
+        printf("%s : unable to run %s\n", __bench_policies[i].name, argv[w]);
+        return 1;
+      }
+
+      // short runs are noisy, keep the fastest of a few
+      for (int j = 1; best.processes < BENCH_SMALL && j < BENCH_REPEATS; j++) {
+        if (__bench_fork(__bench_policies[i].create, argv[w], &result)) {
+          printf("%s : unable to run %s\n", __bench_policies[i].name, argv[w]);
+          return 1;
+        }
+
+        if (result.seconds < best.seconds) {
+          best = result;
+        }
+      }
+
+      snprintf(best.policy, sizeof(best.policy), "%s", __bench_policies[i].name);
+
+      printf("%-8s %10d %12lld %14.0f %12.2f %10ld %12lld\n", best.policy, best.processes, best.ticks,
+          __bench_ticks_per_second(&best), __bench_ns_per_dispatch(&best), best.peak_rss, best.allocations);
+
+      if (out != NULL) {
+        __bench_write(out, &best);
+        fflush(out);
+      }
+
+      regressions += __bench_compare(&best, baseline, baselines, threshold);
+    }
+  }
+
+  if (out != NULL) {
+    fclose(out);
+  }
+
+  if (regressions > 0) {
+    printf("%d regression%s against %s\n", regressions, regressions == 1 ? "" : "s", baseline_path);
+    return 1;
+  }
+
+  return 0;
+}
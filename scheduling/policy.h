@@ -0,0 +1,80 @@
+#ifndef RYJEN_OS_POLICY_H
+#define RYJEN_OS_POLICY_H
+
+/**
+ * Allocates a first come first serve algorithm
+ * @return the algorithm instance, destroying it destroys its data
+ */
+Algorithm *new_fcfs_algorithm();
+
+/**
+ * Allocates a shortest process next algorithm
+ * @return the algorithm instance, destroying it destroys its data
+ */
+Algorithm *new_spn_algorithm();
+
+/**
+ * Allocates a shortest time remaining algorithm
+ * @return the algorithm instance, destroying it destroys its data
+ */
+Algorithm *new_str_algorithm();
+
+/**
+ * Allocates a round robin algorithm
+ * @param int the time slice of a process
+ * @return the algorithm instance, destroying it destroys its data
+ */
+Algorithm *new_rr_algorithm(int quantum);
+
+/**
+ * Allocates a lottery algorithm, weighted by service time
+ * @return the algorithm instance, destroying it destroys its data
+ */
+Algorithm *new_lottery_algorithm();
+
+/**
+ * Allocates a multi-level feedback queue algorithm with doubling quanta
+ * @param int the number of queues
+ * @param int the quantum of the highest priority queue
+ * @param int ticks between priority boosts, 0 for none
+ * @return the algorithm instance, destroying it destroys its data
+ */
+Algorithm *new_mlfq_algorithm(int queues, int quantum, int boost);
+
+/**
+ * Allocates a multi-level feedback queue algorithm with the same quantum on every queue
+ * @param int the number of queues
+ * @param int the quantum of every queue
+ * @param int ticks between priority boosts, 0 for none
+ * @return the algorithm instance, destroying it destroys its data
+ */
+Algorithm *new_mlfq_fixed_algorithm(int queues, int quantum, int boost);
+
+/**
+ * Allocates a completely fair algorithm
+ * @param int ticks in which every runnable process should run once
+ * @param int minimum ticks a process runs before being prempted
+ * @return the algorithm instance, destroying it destroys its data
+ */
+Algorithm *new_cfs_algorithm(int latency, int granularity);
+
+/**
+ * Allocates an O(1) priority array algorithm
+ * @param int the time slice of the default priority
+ * @return the algorithm instance, destroying it destroys its data
+ */
+Algorithm *new_o1_algorithm(int quantum);
+
+/**
+ * Allocates an earliest deadline first algorithm
+ * @return the algorithm instance, destroying it destroys its data
+ */
+Algorithm *new_edf_algorithm();
+
+/**
+ * Allocates a highest response ratio next algorithm
+ * @return the algorithm instance, destroying it destroys its data
+ */
+Algorithm *new_hrrn_algorithm();
+
+#endif
@@ -3,62 +3,482 @@
 #include <unistd.h>
 #include <string.h>
 #include <time.h>
+#include <limits.h>
 
 #include "types.h"
 #include "process.h"
+#include "arena.h"
+#include "intern.h"
 
-// a process in the queue
-struct process {
-  // process id
-  char *name;
+// the initial number of processes in a table
+#define PROCESS_TABLE_CAPACITY 1024
+
+// the int columns of a table
+#define PROCESS_TABLE_INTS 17
+
+// the int columns of a table with I/O bursts
+#define PROCESS_TABLE_IO_INTS 4
+
+// the pointer columns of a table
+#define PROCESS_TABLE_POINTERS 1
+
+// a column of a process in its table
+#define PROCESS_COLUMN(p, column) ((p)->table->column[(p)->id])
+
+// the initial number of I/O bursts in a table
+#define PROCESS_IO_CAPACITY 64
+
+// the live work of a process
+typedef struct process_task {
+  // runs one tick of the work
+  ProcessWork work;
+  // the state passed to the work
+  void *state;
+} ProcessTask;
+
+// an I/O burst of a process
+typedef struct io_burst {
+  // the ticks of service before the burst starts
+  int at;
+  // the ticks blocked on the I/O
+  int ticks;
+} IoBurst;
+
+// processes in parallel arrays indexed by id
+struct process_table {
+  // the number of processes
+  int size;
+  // the allocated number of processes in each column
+  int capacity;
+
+  // one block holding the int columns
+  int *ints;
   // the time the process arrives
-  int arrival;
+  int *arrival;
   // the time needed to process
-  int service;
-
+  int *service;
   // status of the process
-  int status;
+  int *status;
   // the time the process completed
-  int complete;
-
+  int *complete;
   // how many ticks serviced so far
-  int total_ticks;
+  int *total_ticks;
   // the ticks serviced before premption
-  int ticks;
+  int *ticks;
+  // the static priority
+  int *priority;
+  // the time to complete by after arrival (0 for none)
+  int *deadline;
+  // the algorithm queue level
+  int *level;
+  // the time the process first ran (-1 until then)
+  int *start;
+  // the share group id in the group names (-1 for none)
+  int *group;
+  // the process name id in the names (INTERN_NONE for none)
+  InternId *name;
+  // the times the process was switched to
+  int *dispatches;
+  // the calls to process_prempt
+  int *preemptions;
+  // the time the process was last ready (-1 for its arrival)
+  int *ready;
+  // the longest wait between being ready and running
+  int *longest_wait;
+  // the time the process was last switched to (-1 until then)
+  int *dispatched;
+  // one block holding the I/O columns, NULL until a process has I/O bursts
+  int *io_ints;
+  // the index of the first I/O burst in the bursts (-1 for none)
+  int *io_first;
+  // the number of I/O bursts
+  int *io_count;
+  // the number of I/O bursts started
+  int *io_done;
+  // the ticks blocked on I/O so far
+  int *io_ticks;
+
+  // the I/O bursts of every process, each process in a run of its own
+  IoBurst *bursts;
+  // the number of I/O bursts, including runs moved away from
+  int bursts_size;
+  // the allocated number of I/O bursts
+  int bursts_capacity;
+
+  // the live work of the processes, NULL until a process has work
+  ProcessTask *tasks;
+
+  // one block holding the pointer columns
+  void **pointers;
+  // the handle of the process
+  Process **handles;
+
+  // the distinct process names
+  Intern *names;
+  // the distinct share group names, so group ids are dense
+  Intern *groups;
 
-  void (*work)();
+  // the handles and strings
+  Arena *arena;
+  // destroyed with its only process, see new_process
+  int owned;
 };
 
-static void __process_work() {
-  // TODO: define process work
+// a process in a table
+struct process {
+  // the table holding the process
+  ProcessTable *table;
+  // the index of the process in the table
+  ProcessId id;
+};
+
+// runs one tick of the live work of a process, 1 if it has more work, 0 if done, -1 on error
+static int __process_work(Process *p) {
+  ProcessTask *task = &PROCESS_COLUMN(p, tasks);
+
+  return task->work(p, task->state);
 }
 
-Process *new_process(const char *name) {
-  Process *p = (Process *) malloc(sizeof(Process));
+// points the columns into blocks of a capacity
+static void __process_table_layout(ProcessTable *t, int *ints, void **pointers, int capacity) {
+  t->ints = ints;
+  t->arrival = ints;
+  t->service = ints + capacity;
+  t->status = ints + capacity * 2;
+  t->complete = ints + capacity * 3;
+  t->total_ticks = ints + capacity * 4;
+  t->ticks = ints + capacity * 5;
+  t->priority = ints + capacity * 6;
+  t->deadline = ints + capacity * 7;
+  t->level = ints + capacity * 8;
+  t->start = ints + capacity * 9;
+  t->group = ints + capacity * 10;
+  t->name = (InternId *) (ints + capacity * 11);
+  t->dispatches = ints + capacity * 12;
+  t->preemptions = ints + capacity * 13;
+  t->ready = ints + capacity * 14;
+  t->longest_wait = ints + capacity * 15;
+  t->dispatched = ints + capacity * 16;
 
-  if (p == NULL) {
+  t->pointers = pointers;
+  t->handles = (Process **) pointers;
+  t->capacity = capacity;
+}
+
+// points the I/O columns into a block of a capacity
+static void __process_table_layout_io(ProcessTable *t, int *ints, int capacity) {
+  t->io_ints = ints;
+  t->io_first = ints;
+  t->io_count = ints + capacity;
+  t->io_done = ints + capacity * 2;
+  t->io_ticks = ints + capacity * 3;
+}
+
+// clears the I/O columns of processes
+static void __process_table_clear_io(ProcessTable *t, int from, int to) {
+  for (int i = from; i < to; i++) {
+    t->io_first[i] = -1;
+    t->io_count[i] = 0;
+    t->io_done[i] = 0;
+    t->io_ticks[i] = 0;
+  }
+}
+
+// moves the I/O columns from a block of a previous capacity to the capacity of the table
+static void __process_table_grow_io(ProcessTable *t, int previous) {
+  int *ints = malloc((size_t) t->capacity * PROCESS_TABLE_IO_INTS * sizeof(int));
+
+  if (ints == NULL) {
+    abort();
+  }
+
+  for (int i = 0; t->io_ints != NULL && i < PROCESS_TABLE_IO_INTS; i++) {
+    memcpy(ints + i * t->capacity, t->io_ints + i * previous, t->size * sizeof(int));
+  }
+
+  free(t->io_ints);
+
+  __process_table_layout_io(t, ints, t->capacity);
+}
+
+// moves the live work to the capacity of the table
+static void __process_table_grow_tasks(ProcessTable *t) {
+  ProcessTask *tasks = realloc(t->tasks, (size_t) t->capacity * sizeof(ProcessTask));
+
+  if (tasks == NULL) {
+    abort();
+  }
+
+  t->tasks = tasks;
+}
+
+// moves the columns into blocks of a larger capacity
+static void __process_table_grow(ProcessTable *t, int capacity) {
+  int *ints = malloc((size_t) capacity * PROCESS_TABLE_INTS * sizeof(int));
+  void **pointers = malloc((size_t) capacity * PROCESS_TABLE_POINTERS * sizeof(void *));
+
+  if (ints == NULL || pointers == NULL) {
     abort();
   }
 
-  p->name = name == NULL ? NULL : strdup(name);
-  p->status = PROCESS_END;
-  p->arrival = 0;
-  p->service = 0;
-  p->complete = 0;
-  p->ticks = 0;
-  p->total_ticks = 0;
-  p->work = __process_work;
+  for (int i = 0; i < PROCESS_TABLE_INTS; i++) {
+    memcpy(ints + i * capacity, t->ints + i * t->capacity, t->size * sizeof(int));
+  }
+
+  for (int i = 0; i < PROCESS_TABLE_POINTERS; i++) {
+    memcpy(pointers + i * capacity, t->pointers + i * t->capacity, t->size * sizeof(void *));
+  }
+
+  free(t->ints);
+  free(t->pointers);
+
+  int previous = t->capacity;
+
+  __process_table_layout(t, ints, pointers, capacity);
+
+  if (t->io_ints != NULL) {
+    __process_table_grow_io(t, previous);
+  }
+
+  if (t->tasks != NULL) {
+    __process_table_grow_tasks(t);
+  }
+}
+
+// allocates a table for a capacity, with an arena block for the handles and names
+static ProcessTable *__new_process_table(int capacity, size_t arena) {
+  ProcessTable *t = (ProcessTable *) malloc(sizeof(ProcessTable));
+
+  if (t == NULL) {
+    abort();
+  }
+
+  int *ints = malloc((size_t) capacity * PROCESS_TABLE_INTS * sizeof(int));
+  void **pointers = malloc((size_t) capacity * PROCESS_TABLE_POINTERS * sizeof(void *));
+
+  if (ints == NULL || pointers == NULL) {
+    abort();
+  }
+
+  __process_table_layout(t, ints, pointers, capacity);
+
+  t->size = 0;
+  t->io_ints = NULL;
+  t->io_first = NULL;
+  t->io_count = NULL;
+  t->io_done = NULL;
+  t->io_ticks = NULL;
+  t->tasks = NULL;
+  t->bursts = NULL;
+  t->bursts_size = 0;
+  t->bursts_capacity = 0;
+  t->arena = new_arena(arena);
+  t->names = new_intern(t->arena);
+  t->groups = new_intern(t->arena);
+  t->owned = 0;
+  return t;
+}
+
+ProcessTable *new_process_table() {
+  return __new_process_table(PROCESS_TABLE_CAPACITY, PROCESS_TABLE_CAPACITY * (sizeof(Process) + 16));
+}
+
+void delete_process_table(ProcessTable *t) {
+  if (t == NULL) {
+    return;
+  }
+
+  delete_intern(t->names);
+  delete_intern(t->groups);
+  delete_arena(t->arena);
+  free(t->ints);
+  free(t->pointers);
+  free(t->io_ints);
+  free(t->tasks);
+  free(t->bursts);
+  free(t);
+}
+
+Process *process_table_new_process(ProcessTable *t, const char *name) {
+  if (t == NULL) {
+    return NULL;
+  }
+
+  // ids are 32 bit and the columns are indexed by int
+  if (t->size == INT_MAX) {
+    return NULL;
+  }
+
+  if (t->size == t->capacity) {
+    __process_table_grow(t, t->capacity > INT_MAX / 2 ? INT_MAX : t->capacity * 2);
+  }
+
+  Process *p = arena_alloc(t->arena, sizeof(Process));
+
+  ProcessId id = (ProcessId) t->size++;
+
+  p->table = t;
+  p->id = id;
+
+  t->handles[id] = p;
+  t->name[id] = intern_id(t->names, name);
+  t->group[id] = -1;
+  t->start[id] = -1;
+  t->status[id] = PROCESS_END;
+  t->arrival[id] = 0;
+  t->service[id] = 0;
+  t->complete[id] = 0;
+  t->ticks[id] = 0;
+  t->total_ticks[id] = 0;
+  t->priority[id] = PROCESS_DEFAULT_PRIORITY;
+  t->deadline[id] = 0;
+  t->level[id] = 0;
+  t->dispatches[id] = 0;
+  t->preemptions[id] = 0;
+  t->ready[id] = -1;
+  t->longest_wait[id] = 0;
+  t->dispatched[id] = -1;
+
+  if (t->io_ints != NULL) {
+    __process_table_clear_io(t, id, id + 1);
+  }
+
+  if (t->tasks != NULL) {
+    memset(&t->tasks[id], 0, sizeof(ProcessTask));
+  }
   return p;
 }
 
+int process_table_reserve(ProcessTable *t, int count) {
+  if (t == NULL || count < 0 || count > INT_MAX - t->size) {
+    return -1;
+  }
+
+  if (t->size + count > t->capacity) {
+    __process_table_grow(t, t->size + count);
+  }
+
+  return intern_reserve(t->names, count);
+}
+
+int process_table_append(ProcessTable *t, const ProcessBatch *batch) {
+  if (t == NULL || batch == NULL || batch->arrival == NULL || batch->service == NULL || batch->size < 0) {
+    return -1;
+  }
+
+  int first = t->size;
+  int size = batch->size;
+
+  if (size > INT_MAX - first) {
+    return -1;
+  }
+
+  if (first + size > t->capacity) {
+    __process_table_grow(t, first + size);
+  }
+
+  // one block for the handles rather than one allocation each
+  Process *handles = size > 0 ? arena_alloc(t->arena, (size_t) size * sizeof(Process)) : NULL;
+
+  for (int i = 0; i < size; i++) {
+    handles[i].table = t;
+    handles[i].id = (ProcessId) (first + i);
+    t->handles[first + i] = &handles[i];
+  }
+
+  memcpy(t->arrival + first, batch->arrival, size * sizeof(int));
+  memcpy(t->service + first, batch->service, size * sizeof(int));
+
+  for (int i = first; i < first + size; i++) {
+    t->status[i] = PROCESS_END;
+    t->complete[i] = 0;
+    t->ticks[i] = 0;
+    t->total_ticks[i] = 0;
+    t->level[i] = 0;
+    t->start[i] = -1;
+    t->dispatches[i] = 0;
+    t->preemptions[i] = 0;
+    t->ready[i] = -1;
+    t->longest_wait[i] = 0;
+    t->dispatched[i] = -1;
+  }
+
+  if (t->io_ints != NULL) {
+    __process_table_clear_io(t, first, first + size);
+  }
+
+  if (t->tasks != NULL) {
+    memset(t->tasks + first, 0, (size_t) size * sizeof(ProcessTask));
+  }
+
+  for (int i = 0; i < size; i++) {
+    t->priority[first + i] = batch->priority == NULL ? PROCESS_DEFAULT_PRIORITY : batch->priority[i];
+    t->deadline[first + i] = batch->deadline == NULL ? 0 : batch->deadline[i];
+    t->group[first + i] = batch->group == NULL ? -1 : batch->group[i];
+    t->name[first + i] = batch->name == NULL ? INTERN_NONE : batch->name[i];
+  }
+
+  t->size += size;
+  return first;
+}
+
+InternId process_table_name_id(ProcessTable *t, const char *name) {
+  return t == NULL ? INTERN_NONE : intern_id(t->names, name);
+}
+
+int process_table_load_names(ProcessTable *t, const char *names, size_t size, const uint64_t *offsets, int count) {
+  return t == NULL ? -1 : intern_load(t->names, names, size, offsets, count);
+}
+
+int process_table_group_id(ProcessTable *t, const char *name) {
+  if (t == NULL || name == NULL) {
+    return -1;
+  }
+
+  InternId id = intern_id(t->groups, name);
+
+  // the group column is an int
+  return id == INTERN_NONE || id > INT_MAX ? -1 : (int) id;
+}
+
+int process_table_size(ProcessTable *t) {
+  return t == NULL ? 0 : t->size;
+}
+
+Process *process_table_get(ProcessTable *t, ProcessId id) {
+  if (t == NULL || id >= (ProcessId) t->size) {
+    return NULL;
+  }
+
+  return t->handles[id];
+}
+
+Process *new_process(const char *name) {
+  // a table of its own, with room for the handle and a short name
+  ProcessTable *t = __new_process_table(1, sizeof(Process) + 48);
+
+  t->owned = 1;
+
+  return process_table_new_process(t, name);
+}
+
 void delete_process(Process *p) {
   if (p == NULL) {
     return;
   }
-  if (p->name) {
-    free(p->name);
+
+  // otherwise destroyed with its table
+  if (p->table->owned) {
+    delete_process_table(p->table);
   }
-  free(p);
+}
+
+ProcessId process_id(Process *p) {
+  return p == NULL ? 0 : p->id;
+}
+
+ProcessTable *process_table(Process *p) {
+  return p == NULL ? NULL : p->table;
 }
 
 const char *process_name(Process *p) {
@@ -66,15 +486,19 @@ const char *process_name(Process *p) {
     return NULL;
   }
 
-  return p->name;
+  return intern_string(p->table->names, PROCESS_COLUMN(p, name));
+}
+
+InternId process_name_id(Process *p) {
+  return p == NULL ? INTERN_NONE : PROCESS_COLUMN(p, name);
 }
 
 int process_arrival_time(Process *p) {
-  return p == NULL ? 0 : p->arrival;
+  return p == NULL ? 0 : PROCESS_COLUMN(p, arrival);
 }
 
 int process_current_arrival_time(Process *p) {
-  return p == NULL ? 0 : (p->arrival + p->total_ticks);
+  return p == NULL ? 0 : (PROCESS_COLUMN(p, arrival) + PROCESS_COLUMN(p, total_ticks));
 }
 
 int process_set_arrival_time(Process *p, int value) {
@@ -82,16 +506,16 @@ int process_set_arrival_time(Process *p, int value) {
     return -1;
   }
 
-  p->arrival = value;
+  PROCESS_COLUMN(p, arrival) = value;
   return 0;
 }
 
 int process_service_time(Process *p) {
-  return p == NULL ? 0 : p->service;
+  return p == NULL ? 0 : PROCESS_COLUMN(p, service);
 }
 
 int process_current_service_time(Process *p) {
-  return p == NULL ? 0 : (p->service - p->total_ticks);
+  return p == NULL ? 0 : (PROCESS_COLUMN(p, service) - PROCESS_COLUMN(p, total_ticks));
 }
 
 int process_set_service_time(Process *p, int value) {
@@ -99,12 +523,12 @@ int process_set_service_time(Process *p, int value) {
     return -1;
   }
 
-  p->service = value;
+  PROCESS_COLUMN(p, service) = value;
   return 0;
 }
 
 int process_completion_time(Process *p) {
-  return p == NULL ? 0 : p->complete;
+  return p == NULL ? 0 : PROCESS_COLUMN(p, complete);
 }
 
 int process_set_completion_time(Process *p, int value) {
@@ -112,7 +536,7 @@ int process_set_completion_time(Process *p, int value) {
     return -1;
   }
 
-  p->complete = value;
+  PROCESS_COLUMN(p, complete) = value;
   return 0;
 }
 
@@ -138,7 +562,30 @@ int process_compare_arrival_times(void *a, void *b) {
   Process *p1 = (Process *) a;
   Process *p2 = (Process *) b;
 
-  return p1->arrival - p2->arrival;
+  return PROCESS_COLUMN(p1, arrival) - PROCESS_COLUMN(p2, arrival);
+}
+
+int process_compare_deadlines(void *a, void *b) {
+  if (a == NULL) {
+    return b ? -1 : 0;
+  }
+  if (b == NULL) {
+    return a ? 1 : 0;
+  }
+
+  Process *p1 = (Process *) a;
+  Process *p2 = (Process *) b;
+
+  // no deadline is later than any deadline
+  if (PROCESS_COLUMN(p1, deadline) == 0 || PROCESS_COLUMN(p2, deadline) == 0) {
+    if (PROCESS_COLUMN(p1, deadline) != PROCESS_COLUMN(p2, deadline)) {
+      return PROCESS_COLUMN(p1, deadline) == 0 ? 1 : -1;
+    }
+  } else if (process_absolute_deadline(p1) != process_absolute_deadline(p2)) {
+    return process_absolute_deadline(p1) - process_absolute_deadline(p2);
+  }
+
+  return PROCESS_COLUMN(p1, arrival) - PROCESS_COLUMN(p2, arrival);
 }
 
 int microsleep(int milliseconds) {
@@ -157,15 +604,34 @@ int process_run(Process *p) {
     return PROCESS_ERROR;
   }
 
-  if (p->service == p->ticks) {
+  if (PROCESS_COLUMN(p, service) == PROCESS_COLUMN(p, ticks)) {
     return PROCESS_END;
   }
 
-  p->work();
-  p->ticks++;
-  p->total_ticks++;
+  if (p->table->tasks != NULL && PROCESS_COLUMN(p, tasks).work != NULL) {
+    int more = __process_work(p);
+
+    if (more < 0) {
+      return PROCESS_ERROR;
+    }
+
+    PROCESS_COLUMN(p, ticks)++;
+    PROCESS_COLUMN(p, total_ticks)++;
+
+    // the service time is an estimate, the work decides when it is done
+    if (!more) {
+      PROCESS_COLUMN(p, service) = PROCESS_COLUMN(p, total_ticks);
+    } else if (PROCESS_COLUMN(p, service) <= PROCESS_COLUMN(p, total_ticks)) {
+      PROCESS_COLUMN(p, service) = PROCESS_COLUMN(p, total_ticks) + 1;
+    }
+
+    return PROCESS_COLUMN(p, service) - PROCESS_COLUMN(p, total_ticks);
+  }
+
+  PROCESS_COLUMN(p, ticks)++;
+  PROCESS_COLUMN(p, total_ticks)++;
 
-  return p->service - p->total_ticks;
+  return PROCESS_COLUMN(p, service) - PROCESS_COLUMN(p, total_ticks);
 }
 
 int process_prempt(Process *p) {
@@ -173,7 +639,17 @@ int process_prempt(Process *p) {
     return -1;
   }
 
-  p->ticks = 0;
+  PROCESS_COLUMN(p, ticks) = 0;
+  PROCESS_COLUMN(p, preemptions)++;
+  return 0;
+}
+
+int process_reset_ticks(Process *p) {
+  if (p == NULL) {
+    return -1;
+  }
+
+  PROCESS_COLUMN(p, ticks) = 0;
   return 0;
 }
 
@@ -182,7 +658,381 @@ int process_current_tick(Process *p) {
     return -1;
   }
 
-  return p->ticks;
+  return PROCESS_COLUMN(p, ticks);
 }
 
+int process_priority(Process *p) {
+  return p == NULL ? -1 : PROCESS_COLUMN(p, priority);
+}
 
+int process_set_priority(Process *p, int value) {
+  if (p == NULL || value < 0 || value >= PROCESS_PRIORITIES) {
+    return -1;
+  }
+
+  PROCESS_COLUMN(p, priority) = value;
+  return 0;
+}
+
+int process_deadline(Process *p) {
+  return p == NULL ? 0 : PROCESS_COLUMN(p, deadline);
+}
+
+int process_absolute_deadline(Process *p) {
+  return p == NULL || PROCESS_COLUMN(p, deadline) == 0 ? 0 : PROCESS_COLUMN(p, arrival) + PROCESS_COLUMN(p, deadline);
+}
+
+int process_set_deadline(Process *p, int value) {
+  if (p == NULL || value < 0) {
+    return -1;
+  }
+
+  PROCESS_COLUMN(p, deadline) = value;
+  return 0;
+}
+
+int process_level(Process *p) {
+  return p == NULL ? -1 : PROCESS_COLUMN(p, level);
+}
+
+int process_set_level(Process *p, int value) {
+  if (p == NULL) {
+    return -1;
+  }
+
+  PROCESS_COLUMN(p, level) = value;
+  return 0;
+}
+
+const char *process_group(Process *p) {
+  if (p == NULL || PROCESS_COLUMN(p, group) == -1) {
+    return NULL;
+  }
+
+  return intern_string(p->table->groups, PROCESS_COLUMN(p, group));
+}
+
+int process_set_group(Process *p, const char *value) {
+  if (p == NULL) {
+    return -1;
+  }
+
+  if (value == NULL) {
+    PROCESS_COLUMN(p, group) = -1;
+    return 0;
+  }
+
+  int id = process_table_group_id(p->table, value);
+
+  if (id == -1) {
+    return -1;
+  }
+
+  PROCESS_COLUMN(p, group) = id;
+  return 0;
+}
+
+int process_group_id(Process *p) {
+  return p == NULL ? -1 : PROCESS_COLUMN(p, group);
+}
+
+int process_start_time(Process *p) {
+  return p == NULL ? -1 : PROCESS_COLUMN(p, start);
+}
+
+int process_set_start_time(Process *p, int value) {
+  if (p == NULL) {
+    return -1;
+  }
+
+  PROCESS_COLUMN(p, start) = value;
+  return 0;
+}
+
+int process_dispatch(Process *p, int tick) {
+  if (p == NULL) {
+    return -1;
+  }
+
+  int wait = tick - process_ready_time(p);
+
+  if (wait > PROCESS_COLUMN(p, longest_wait)) {
+    PROCESS_COLUMN(p, longest_wait) = wait;
+  }
+
+  if (PROCESS_COLUMN(p, start) == -1) {
+    PROCESS_COLUMN(p, start) = tick;
+  }
+
+  PROCESS_COLUMN(p, dispatches)++;
+  PROCESS_COLUMN(p, dispatched) = tick;
+  return 0;
+}
+
+int process_set_ready_time(Process *p, int tick) {
+  if (p == NULL) {
+    return -1;
+  }
+
+  PROCESS_COLUMN(p, ready) = tick;
+  return 0;
+}
+
+int process_ready_time(Process *p) {
+  if (p == NULL) {
+    return 0;
+  }
+
+  return PROCESS_COLUMN(p, ready) == -1 ? PROCESS_COLUMN(p, arrival) : PROCESS_COLUMN(p, ready);
+}
+
+int process_dispatches(Process *p) {
+  return p == NULL ? -1 : PROCESS_COLUMN(p, dispatches);
+}
+
+int process_preemptions(Process *p) {
+  return p == NULL ? -1 : PROCESS_COLUMN(p, preemptions);
+}
+
+int process_longest_wait(Process *p) {
+  return p == NULL ? -1 : PROCESS_COLUMN(p, longest_wait);
+}
+
+int process_dispatch_time(Process *p) {
+  return p == NULL ? -1 : PROCESS_COLUMN(p, dispatched);
+}
+
+// the next I/O burst of a process, NULL when it has started them all
+static IoBurst *__process_next_burst(Process *p) {
+  if (p->table->io_ints == NULL || PROCESS_COLUMN(p, io_done) == PROCESS_COLUMN(p, io_count)) {
+    return NULL;
+  }
+
+  return &p->table->bursts[PROCESS_COLUMN(p, io_first) + PROCESS_COLUMN(p, io_done)];
+}
+
+int process_add_io_burst(Process *p, int cpu, int io) {
+  if (p == NULL || cpu < 1 || io < 1) {
+    return -1;
+  }
+
+  ProcessTable *t = p->table;
+
+  // the first process with I/O bursts in the table
+  if (t->io_ints == NULL) {
+    __process_table_grow_io(t, t->capacity);
+    __process_table_clear_io(t, 0, t->size);
+  }
+
+  int first = PROCESS_COLUMN(p, io_first);
+  int count = PROCESS_COLUMN(p, io_count);
+
+  // the bursts start after the cpu burst following the last one
+  long long at = count == 0 ? cpu : (long long) t->bursts[first + count - 1].at + cpu;
+
+  // the process ends with a cpu burst
+  if (at >= PROCESS_COLUMN(p, service)) {
+    return -1;
+  }
+
+  // the bursts of another process were added since, so move this run to the end
+  int moved = count > 0 && first + count != t->bursts_size;
+
+  if (t->bursts_size + count + 1 > t->bursts_capacity) {
+    int capacity = t->bursts_capacity == 0 ? PROCESS_IO_CAPACITY : t->bursts_capacity * 2;
+
+    while (capacity < t->bursts_size + count + 1) {
+      capacity *= 2;
+    }
+
+    IoBurst *bursts = realloc(t->bursts, (size_t) capacity * sizeof(IoBurst));
+
+    if (bursts == NULL) {
+      abort();
+    }
+
+    t->bursts = bursts;
+    t->bursts_capacity = capacity;
+  }
+
+  if (moved) {
+    memcpy(t->bursts + t->bursts_size, t->bursts + first, count * sizeof(IoBurst));
+  }
+
+  if (count == 0 || moved) {
+    PROCESS_COLUMN(p, io_first) = t->bursts_size;
+    t->bursts_size += count;
+  }
+
+  t->bursts[t->bursts_size].at = (int) at;
+  t->bursts[t->bursts_size].ticks = io;
+  t->bursts_size++;
+
+  PROCESS_COLUMN(p, io_count)++;
+  return 0;
+}
+
+int process_add_io_bursts(Process *p, const char *bursts, int length) {
+  if (p == NULL || bursts == NULL || length < 0) {
+    return -1;
+  }
+
+  const char *s = bursts;
+  const char *end = bursts + length;
+
+  while (s < end) {
+    long value[2];
+
+    // cpu:io, separated by commas
+    for (int i = 0; i < 2; i++) {
+      if (s == end || *s < '0' || *s > '9') {
+        return -1;
+      }
+
+      for (value[i] = 0; s < end && *s >= '0' && *s <= '9'; s++) {
+        value[i] = value[i] * 10 + (*s - '0');
+
+        if (value[i] > INT_MAX) {
+          return -1;
+        }
+      }
+
+      if (i == 0 && (s == end || *s++ != ':')) {
+        return -1;
+      }
+    }
+
+    if ((s < end && *s++ != ',') || (s == end && s[-1] == ',')) {
+      return -1;
+    }
+
+    if (process_add_io_burst(p, (int) value[0], (int) value[1])) {
+      return -1;
+    }
+  }
+
+  return 0;
+}
+
+int process_io_bursts(Process *p) {
+  return p == NULL || p->table->io_ints == NULL ? 0 : PROCESS_COLUMN(p, io_count);
+}
+
+int process_io_burst_at(Process *p, int index, int *cpu, int *io) {
+  if (p == NULL || index < 0 || index >= process_io_bursts(p) || cpu == NULL || io == NULL) {
+    return -1;
+  }
+
+  IoBurst *bursts = &p->table->bursts[PROCESS_COLUMN(p, io_first)];
+
+  *cpu = index == 0 ? bursts[0].at : bursts[index].at - bursts[index - 1].at;
+  *io = bursts[index].ticks;
+  return 0;
+}
+
+int process_io_due(Process *p) {
+  if (p == NULL) {
+    return 0;
+  }
+
+  IoBurst *burst = __process_next_burst(p);
+
+  return burst != NULL && burst->at == PROCESS_COLUMN(p, total_ticks) ? burst->ticks : 0;
+}
+
+int process_block(Process *p) {
+  int io = process_io_due(p);
+
+  if (io == 0) {
+    return -1;
+  }
+
+  // the next cpu burst starts a time slice of its own
+  PROCESS_COLUMN(p, ticks) = 0;
+  PROCESS_COLUMN(p, io_done)++;
+  PROCESS_COLUMN(p, io_ticks) += io;
+  return io;
+}
+
+int process_current_burst_time(Process *p) {
+  if (p == NULL) {
+    return 0;
+  }
+
+  IoBurst *burst = __process_next_burst(p);
+
+  return burst == NULL ? process_current_service_time(p) : burst->at - PROCESS_COLUMN(p, total_ticks);
+}
+
+int process_io_time(Process *p) {
+  return p == NULL || p->table->io_ints == NULL ? 0 : PROCESS_COLUMN(p, io_ticks);
+}
+
+int process_table_groups(ProcessTable *t) {
+  return t == NULL ? 0 : intern_size(t->groups);
+}
+
+const char *process_table_group(ProcessTable *t, int group) {
+  if (t == NULL || group < 0) {
+    return NULL;
+  }
+
+  return intern_string(t->groups, (InternId) group);
+}
+
+int process_table_names(ProcessTable *t) {
+  return t == NULL ? 0 : intern_size(t->names);
+}
+
+const char *process_table_name(ProcessTable *t, InternId name) {
+  return t == NULL ? NULL : intern_string(t->names, name);
+}
+
+int process_table_columns(ProcessTable *t, ProcessColumns *columns) {
+  if (t == NULL || columns == NULL) {
+    return -1;
+  }
+
+  columns->arrival = t->arrival;
+  columns->service = t->service;
+  columns->start = t->start;
+  columns->completion = t->complete;
+  columns->deadline = t->deadline;
+  columns->group = t->group;
+  columns->priority = t->priority;
+  columns->name = t->name;
+  columns->dispatches = t->dispatches;
+  columns->preemptions = t->preemptions;
+  columns->longest_wait = t->longest_wait;
+  columns->io = t->io_ticks;
+  columns->size = t->size;
+  return 0;
+}
+
+int process_set_work(Process *p, ProcessWork work, void *state) {
+  if (p == NULL) {
+    return -1;
+  }
+
+  ProcessTable *t = p->table;
+
+  if (t->tasks == NULL) {
+    t->tasks = calloc((size_t) t->capacity, sizeof(ProcessTask));
+
+    if (t->tasks == NULL) {
+      abort();
+    }
+  }
+
+  t->tasks[p->id].work = work;
+  t->tasks[p->id].state = state;
+  return 0;
+}
+
+ProcessWork process_work(Process *p) {
+  return p == NULL || p->table->tasks == NULL ? NULL : PROCESS_COLUMN(p, tasks).work;
+}
+
+void *process_state(Process *p) {
+  return p == NULL || p->table->tasks == NULL ? NULL : PROCESS_COLUMN(p, tasks).state;
+}
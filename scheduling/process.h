@@ -1,30 +1,239 @@
 #ifndef RYJEN_OS_PROCESS_H
 #define RYJEN_OS_PROCESS_H
 
+#include "intern.h"
+
 #define PROCESS_ERROR -1
 #define PROCESS_END    0
 #define PROCESS_ALIVE  1
 #define PROCESS_PREMPT 2
 
+// the number of static priorities (lower is more important)
+#define PROCESS_PRIORITIES       140
+// the default static priority
+#define PROCESS_DEFAULT_PRIORITY 120
+
+/**
+ * Runs one tick of the live work of a process, a bounded unit of work so
+ * the algorithm can take the processor back after any tick
+ * @param Process the process instance
+ * @param void* the state of the work
+ * @return 1 while the work has more to do, 0 when it is done, -1 on error
+ */
+typedef int (*ProcessWork)(Process *, void *);
+
+// read only columns of a process table, indexed by process id
+typedef struct process_columns {
+  // the arrival times
+  const int *arrival;
+  // the service times
+  const int *service;
+  // the times the processes first ran (-1 if not yet)
+  const int *start;
+  // the completion times
+  const int *completion;
+  // the deadlines relative to arrival (0 for none)
+  const int *deadline;
+  // the share group indexes (-1 for none)
+  const int *group;
+  // the static priorities
+  const int *priority;
+  // the name ids (INTERN_NONE for none)
+  const InternId *name;
+  // the times the processes were switched to (NULL if not kept)
+  const int *dispatches;
+  // the times the processes were prempted
+  const int *preemptions;
+  // the longest each process waited to run, from arrival or a time slice
+  const int *longest_wait;
+  // the ticks the processes were blocked on I/O (NULL for none)
+  const int *io;
+  // the number of processes
+  int size;
+} ProcessColumns;
+
+// columns of processes to add to a table at once
+typedef struct process_batch {
+  // the arrival times
+  const int *arrival;
+  // the service times
+  const int *service;
+  // the static priorities (NULL for the default)
+  const int *priority;
+  // the deadlines relative to arrival (NULL for none)
+  const int *deadline;
+  // the share group ids in the table (NULL for none)
+  const int *group;
+  // the name ids in the table (NULL for none)
+  const InternId *name;
+  // the number of processes
+  int size;
+} ProcessBatch;
+
+/**
+ * Allocates a new table of processes.  The fields of the processes are
+ * kept in parallel arrays indexed by process id, and the processes and
+ * their names are allocated from an arena, so the table is freed at once.
+ * Names and groups are interned, so processes sharing a name store it once.
+ * @return the table instance
+ */
+ProcessTable *new_process_table();
+
+/**
+ * Destroys a table instance and every process in it
+ * @param ProcessTable the table instance
+ */
+void delete_process_table(ProcessTable *);
+
+/**
+ * Allocates a new process in a table, with the next id
+ * @param ProcessTable the table instance
+ * @param char* the process name
+ * @return the process instance, NULL on error
+ */
+Process *process_table_new_process(ProcessTable *, const char *);
+
+/**
+ * Makes room for more processes in a table, so adding them does not
+ * move the columns
+ * @param ProcessTable the table instance
+ * @param int the number of processes to make room for
+ * @return 0 on success, -1 on error
+ */
+int process_table_reserve(ProcessTable *, int);
+
+/**
+ * Adds processes to a table at once, copying the columns of a batch
+ * @param ProcessTable the table instance
+ * @param ProcessBatch the columns of the processes
+ * @return the id of the first process added, -1 on error
+ */
+int process_table_append(ProcessTable *, const ProcessBatch *);
+
+/**
+ * Gets the id of a process name in a table, adding the name if needed
+ * @param ProcessTable the table instance
+ * @param char* the name
+ * @return the name id, INTERN_NONE on error
+ */
+InternId process_table_name_id(ProcessTable *, const char *);
+
 /**
- * Allocates a new process
+ * Adds distinct process names to a table without names at once, so
+ * their ids are their indexes (see intern_load)
+ * @param ProcessTable the table instance
+ * @param char* the block of names, each terminated
+ * @param size_t the bytes of the block
+ * @param uint64_t the offset of each name in the block
+ * @param int the number of names
+ * @return 0 on success, -1 on error
+ */
+int process_table_load_names(ProcessTable *, const char *, size_t, const uint64_t *, int);
+
+/**
+ * Gets the index of a share group in a table, adding the group if needed
+ * @param ProcessTable the table instance
+ * @param char* the group name
+ * @return the group index, -1 on error
+ */
+int process_table_group_id(ProcessTable *, const char *);
+
+/**
+ * Gets the number of processes in a table
+ * @param ProcessTable the table instance
+ * @return the number of processes
+ */
+int process_table_size(ProcessTable *);
+
+/**
+ * Gets a process in a table by id
+ * @param ProcessTable the table instance
+ * @param ProcessId the process id
+ * @return the process instance, NULL if there is none
+ */
+Process *process_table_get(ProcessTable *, ProcessId);
+
+/**
+ * Gets the number of distinct share groups in a table
+ * @param ProcessTable the table instance
+ * @return the number of groups
+ */
+int process_table_groups(ProcessTable *);
+
+/**
+ * Gets the name of a share group in a table
+ * @param ProcessTable the table instance
+ * @param int the group index (see process_group_id)
+ * @return the group name, NULL if there is none
+ */
+const char *process_table_group(ProcessTable *, int);
+
+/**
+ * Gets the number of distinct process names in a table
+ * @param ProcessTable the table instance
+ * @return the number of names
+ */
+int process_table_names(ProcessTable *);
+
+/**
+ * Gets a process name in a table by id
+ * @param ProcessTable the table instance
+ * @param InternId the name id (see process_name_id)
+ * @return the name as a string, NULL if there is none
+ */
+const char *process_table_name(ProcessTable *, InternId);
+
+/**
+ * Gets the columns of a table for a scan, valid until a process is added
+ * @param ProcessTable the table instance
+ * @param ProcessColumns set to the columns
+ * @return 0 on success, -1 on error
+ */
+int process_table_columns(ProcessTable *, ProcessColumns *);
+
+/**
+ * Allocates a new process in a table of its own
+ * @param char* the process name
  * @return the process instance
  */
-Process *new_process();
+Process *new_process(const char *);
 
 /**
- * Destroys a process instance
+ * Destroys a process instance allocated with new_process, processes
+ * in a shared table are destroyed with the table
  * @param Process the process instance
  */
 void delete_process(Process *);
 
 /**
- * Gets the name of the process
+ * Gets the id of the process in its table
+ * @param Process the process instance
+ * @return the id
+ */
+ProcessId process_id(Process *);
+
+/**
+ * Gets the table holding the process
+ * @param Process the process instance
+ * @return the table instance
+ */
+ProcessTable *process_table(Process *);
+
+/**
+ * Gets the name of the process, an index into the interned names of its
+ * table, so resolving it on every trace line costs less than the printf
  * @param Process the process instance
  * @return the name as a string
  */
 const char *process_name(Process *);
 
+/**
+ * Gets the id of the process name in its table
+ * @param Process the process instance
+ * @return the name id, INTERN_NONE if the process has no name
+ */
+InternId process_name_id(Process *);
+
 /**
  * sleeps for microseconds
  * @param int the value in microseconds
@@ -52,6 +261,17 @@ int process_compare_current_service_times(void *, void *);
  */
 int process_compare_arrival_times(void *, void *);
 
+/**
+ * A comparator for process absolute deadlines. Processes without a
+ * deadline are greater, ties are ordered by arrival time.
+ * @param Process the first process
+ * @param Process the second process
+ * @return 0 if the deadlines are equal, a negative value if the first
+ *         process is less than, a positive value if the second
+ *         process is less than
+ */
+int process_compare_deadlines(void *, void *);
+
 /**
  * Runs the process
  * @param Process the process instance
@@ -121,12 +341,20 @@ int process_set_service_time(Process *, int);
 int process_set_completion_time(Process *, int);
 
 /**
- * Finishes a process. Sets the internal state to not active.
+ * Prempts a process, starting a new quantum and counting the premption
  * @param Process the process instance
  * @return 0 on success, -1 on error
  */
 int process_prempt(Process *);
 
+/**
+ * Starts a new quantum of a process without counting a premption, for an
+ * algorithm moving a process that was not running (e.g. a priority boost)
+ * @param Process the process instance
+ * @return 0 on success, -1 on error
+ */
+int process_reset_ticks(Process *);
+
 /**
  * Gets the process quantum, or how long the process has been running
  * @param Process the process instance
@@ -134,5 +362,239 @@ int process_prempt(Process *);
  */
 int process_current_tick(Process *);
 
+/**
+ * Gets the process static priority (0 to 139, lower is more important)
+ * @param Process the process instance
+ * @return the priority as an integer, -1 on error
+ */
+int process_priority(Process *);
+
+/**
+ * Sets the process static priority
+ * @param Process the process instance
+ * @param int the priority value (0 to 139)
+ * @return 0 on success, -1 on error
+ */
+int process_set_priority(Process *, int);
+
+/**
+ * Gets the process deadline, relative to the arrival time
+ * @param Process the process instance
+ * @return the deadline as an integer, 0 if the process has no deadline
+ */
+int process_deadline(Process *);
+
+/**
+ * Gets the process absolute deadline, the tick the process should complete by
+ * @param Process the process instance
+ * @return the absolute deadline as an integer, 0 if the process has no deadline
+ */
+int process_absolute_deadline(Process *);
+
+/**
+ * Sets the process deadline
+ * @param Process the process instance
+ * @param int the deadline relative to the arrival time (0 for none)
+ * @return 0 on success, -1 on error
+ */
+int process_set_deadline(Process *, int);
+
+/**
+ * Gets the algorithm queue level the process was last put on
+ * @param Process the process instance
+ * @return the level as an integer, -1 on error
+ */
+int process_level(Process *);
+
+/**
+ * Sets the algorithm queue level for a process
+ * @param Process the process instance
+ * @param int the level value
+ * @return 0 on success, -1 on error
+ */
+int process_set_level(Process *, int);
+
+/**
+ * Gets the share group the process belongs to
+ * @param Process the process instance
+ * @return the group name as a string, NULL if the process has no group
+ */
+const char *process_group(Process *);
+
+/**
+ * Sets the share group the process belongs to
+ * @param Process the process instance
+ * @param char* the group name (NULL for none)
+ * @return 0 on success, -1 on error
+ */
+int process_set_group(Process *, const char *);
+
+/**
+ * Gets the index of the share group in the table of the process
+ * @param Process the process instance
+ * @return the group index, -1 if the process has no group
+ */
+int process_group_id(Process *);
+
+/**
+ * Gets the time the process first ran
+ * @param Process the process instance
+ * @return the start time as an integer, -1 if it has not run
+ */
+int process_start_time(Process *);
+
+/**
+ * Sets the time the process first ran
+ * @param Process the process instance
+ * @param int the start time value
+ * @return 0 on success, -1 on error
+ */
+int process_set_start_time(Process *, int);
+
+/**
+ * Switches to the process, setting the time it first ran and counting
+ * the ticks it waited since it was last ready
+ * @param Process the process instance
+ * @param int the tick of the time slice
+ * @return 0 on success, -1 on error
+ */
+int process_dispatch(Process *, int);
+
+/**
+ * Sets the time the process is ready again after a time slice
+ * @param Process the process instance
+ * @param int the tick the time slice ended
+ * @return 0 on success, -1 on error
+ */
+int process_set_ready_time(Process *, int);
+
+/**
+ * Gets the time the process was last ready to run
+ * @param Process the process instance
+ * @return the end of its last time slice, or its arrival time if it has not run
+ */
+int process_ready_time(Process *);
+
+/**
+ * Gets the number of times the process was switched to
+ * @param Process the process instance
+ * @return the number of dispatches, -1 on error
+ */
+int process_dispatches(Process *);
+
+/**
+ * Gets the number of times the process was prempted
+ * @param Process the process instance
+ * @return the number of premptions, -1 on error
+ */
+int process_preemptions(Process *);
+
+/**
+ * Gets the longest the process waited to run, from its arrival or the
+ * end of a time slice to the next
+ * @param Process the process instance
+ * @return the ticks waited, -1 on error
+ */
+int process_longest_wait(Process *);
+
+/**
+ * Gets the time the process was last switched to, when it started
+ * running after any switch overhead
+ * @param Process the process instance
+ * @return the time, -1 if it was never switched to
+ */
+int process_dispatch_time(Process *);
+
+/**
+ * Adds an I/O burst to the process, after its earlier bursts.  The
+ * process runs for a cpu burst, then blocks for the I/O, and ends with
+ * the service left after its last burst.  Set the service time first.
+ * @param Process the process instance
+ * @param int the ticks of service before the burst (at least 1)
+ * @param int the ticks blocked on the I/O (at least 1)
+ * @return 0 on success, -1 on error or if the process would end blocked
+ */
+int process_add_io_burst(Process *, int, int);
+
+/**
+ * Adds the I/O bursts of a column like 3:5,4:2, which runs 3 ticks,
+ * blocks 5, runs 4, blocks 2, then runs the rest of the service time
+ * @param Process the process instance
+ * @param char* the bursts, not necessarily terminated
+ * @param int the length of the bursts
+ * @return 0 on success, -1 on error
+ */
+int process_add_io_bursts(Process *, const char *, int);
+
+/**
+ * Gets the number of I/O bursts of the process
+ * @param Process the process instance
+ * @return the number of bursts
+ */
+int process_io_bursts(Process *);
+
+/**
+ * Gets an I/O burst of the process, as it was added
+ * @param Process the process instance
+ * @param int the index of the burst
+ * @param int* set to the ticks of service before the burst
+ * @param int* set to the ticks blocked on the I/O
+ * @return 0 on success, -1 on error
+ */
+int process_io_burst_at(Process *, int, int *, int *);
+
+/**
+ * Tests the process finished a cpu burst and has to block for I/O
+ * @param Process the process instance
+ * @return the ticks of the I/O due, 0 if none
+ */
+int process_io_due(Process *);
+
+/**
+ * Starts the I/O burst due, so the next cpu burst starts a new time slice
+ * @param Process the process instance
+ * @return the ticks blocked on the I/O, -1 if none is due
+ */
+int process_block(Process *);
+
+/**
+ * Gets the ticks the process runs before it blocks for I/O or completes
+ * @param Process the process instance
+ * @return the ticks left in the current cpu burst
+ */
+int process_current_burst_time(Process *);
+
+/**
+ * Gets the ticks the process was blocked on I/O so far
+ * @param Process the process instance
+ * @return the ticks blocked
+ */
+int process_io_time(Process *);
+
+/**
+ * Gives the process live work, run once each tick by process_run.  The
+ * service time becomes an estimate: the process completes when the work
+ * is done, and runs past the estimate while it has more to do.
+ * @param Process the process instance
+ * @param ProcessWork the work, NULL for a simulated process
+ * @param void* the state passed to the work
+ * @return 0 on success, -1 on error
+ */
+int process_set_work(Process *, ProcessWork, void *);
+
+/**
+ * Gets the live work of the process
+ * @param Process the process instance
+ * @return the work, NULL for a simulated process
+ */
+ProcessWork process_work(Process *);
+
+/**
+ * Gets the state of the live work of the process
+ * @param Process the process instance
+ * @return the state, NULL if none
+ */
+void *process_state(Process *);
+
 #endif
 
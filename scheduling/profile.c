@@ -0,0 +1,78 @@
+#define _POSIX_C_SOURCE 200809L
+#include <string.h>
+#include <time.h>
+
+#include "types.h"
+#include "profile.h"
+
+static const char *__profile_sections[PROFILE_SECTIONS] = {
+  "arrive", "ready", "get", "put", "slice", "output", "sort", "stats"
+};
+
+static const char *__profile_threads[PROFILE_THREADS] = { "producer", "consumer" };
+
+void profile_init(Profile *profile) {
+  memset(profile, 0, sizeof(Profile));
+}
+
+long long profile_now() {
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+
+  return ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+void profile_section(Profile *profile, ProfileSection section, long long start) {
+  profile->calls[section]++;
+  profile->nanos[section] += profile_now() - start;
+}
+
+void profile_locked(Profile *profile, ProfileThread thread, long long start) {
+  long long now = profile_now();
+
+  profile->locks[thread]++;
+  profile->lock_wait[thread] += now - start;
+  profile->locked[thread] = now;
+}
+
+void profile_unlocked(Profile *profile, ProfileThread thread) {
+  profile->lock_hold[thread] += profile_now() - profile->locked[thread];
+}
+
+void profile_woken(Profile *profile, ProfileThread thread, long long start, int spurious) {
+  long long waited = profile_now() - start;
+
+  profile->wakeups[thread]++;
+  profile->spurious[thread] += spurious != 0;
+  profile->cond_wait[thread] += waited;
+
+  // the lock was released while waiting
+  profile->locked[thread] += waited;
+}
+
+void profile_print(const Profile *profile, FILE *out) {
+  fprintf(out, "\n%-10s %12s %12s %10s\n", "Section", "Calls", "Total ms", "ns/call");
+
+  for (int i = 0; i < PROFILE_SECTIONS; i++) {
+    if (profile->calls[i] == 0) {
+      continue;
+    }
+
+    fprintf(out, "%-10s %12lld %12.3f %10.1f\n", __profile_sections[i], profile->calls[i],
+        profile->nanos[i] / 1e6, (double) profile->nanos[i] / profile->calls[i]);
+  }
+
+  fprintf(out, "\n%-10s %10s %10s %10s %10s %10s %10s\n", "Thread", "Locks", "Wait ms", "Hold ms",
+      "Wakeups", "Spurious", "Cond ms");
+
+  for (int i = 0; i < PROFILE_THREADS; i++) {
+    if (profile->locks[i] == 0) {
+      continue;
+    }
+
+    fprintf(out, "%-10s %10lld %10.3f %10.3f %10lld %10lld %10.3f\n", __profile_threads[i], profile->locks[i],
+        profile->lock_wait[i] / 1e6, profile->lock_hold[i] / 1e6, profile->wakeups[i], profile->spurious[i],
+        profile->cond_wait[i] / 1e6);
+  }
+}
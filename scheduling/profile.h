@@ -0,0 +1,134 @@
+#ifndef RYJEN_OS_PROFILE_H
+#define RYJEN_OS_PROFILE_H
+
+#include <stdio.h>
+
+#include "types.h"
+
+// the sections of a run that are timed
+typedef enum profile_section {
+  // the algorithm callbacks
+  PROFILE_ARRIVE,
+  PROFILE_READY,
+  PROFILE_GET,
+  PROFILE_PUT,
+  PROFILE_SLICE,
+  // printing the ticks
+  PROFILE_OUTPUT,
+  // sorting the arrivals
+  PROFILE_SORT,
+  // the statistics of the completed processes
+  PROFILE_STATS,
+  PROFILE_SECTIONS
+} ProfileSection;
+
+// the threads holding the scheduler lock
+typedef enum profile_thread {
+  PROFILE_PRODUCER,
+  PROFILE_CONSUMER,
+  PROFILE_THREADS
+} ProfileThread;
+
+// instrumentation of the hot path of a run, in nanoseconds
+struct profile {
+  // the calls of each section
+  long long calls[PROFILE_SECTIONS];
+  // the time spent in each section
+  long long nanos[PROFILE_SECTIONS];
+
+  // the times each thread took the lock
+  long long locks[PROFILE_THREADS];
+  // the time each thread waited for the lock
+  long long lock_wait[PROFILE_THREADS];
+  // the time each thread held the lock, not counting condition waits
+  long long lock_hold[PROFILE_THREADS];
+  // when each thread last took the lock
+  long long locked[PROFILE_THREADS];
+
+  // the times each thread woke from a condition wait
+  long long wakeups[PROFILE_THREADS];
+  // the wakeups that found nothing to do
+  long long spurious[PROFILE_THREADS];
+  // the time each thread spent in condition waits
+  long long cond_wait[PROFILE_THREADS];
+};
+
+/**
+ * Instruments the scheduler when compiled with SCHEDULER_PROFILE, otherwise
+ * every macro expands to nothing so the hot path is unchanged.
+ *
+ *   PROFILE_START(t);
+ *   Process *p = algorithm_process_get(algo);
+ *   PROFILE_SECTION(profile, PROFILE_GET, t);
+ */
+#ifdef SCHEDULER_PROFILE
+
+#define PROFILE_START(t) long long t = profile_now()
+#define PROFILE_SECTION(profile, section, t) profile_section(profile, section, t)
+#define PROFILE_LOCKED(profile, thread, t) profile_locked(profile, thread, t)
+#define PROFILE_UNLOCKED(profile, thread) profile_unlocked(profile, thread)
+#define PROFILE_WOKEN(profile, thread, t, spurious) profile_woken(profile, thread, t, spurious)
+
+#else
+
+#define PROFILE_START(t)
+#define PROFILE_SECTION(profile, section, t)
+#define PROFILE_LOCKED(profile, thread, t)
+#define PROFILE_UNLOCKED(profile, thread)
+#define PROFILE_WOKEN(profile, thread, t, spurious)
+
+#endif
+
+/**
+ * Clears a profile to count into
+ * @param Profile the profile
+ */
+void profile_init(Profile *);
+
+/**
+ * Gets a monotonic time to measure from
+ * @return the time in nanoseconds
+ */
+long long profile_now();
+
+/**
+ * Counts a call of a section started at a time
+ * @param Profile the profile
+ * @param ProfileSection the section
+ * @param long long the time the section started
+ */
+void profile_section(Profile *, ProfileSection, long long);
+
+/**
+ * Counts a thread taking the lock after waiting since a time
+ * @param Profile the profile
+ * @param ProfileThread the thread
+ * @param long long the time the thread asked for the lock
+ */
+void profile_locked(Profile *, ProfileThread, long long);
+
+/**
+ * Counts a thread releasing the lock
+ * @param Profile the profile
+ * @param ProfileThread the thread
+ */
+void profile_unlocked(Profile *, ProfileThread);
+
+/**
+ * Counts a thread woken from a condition wait started at a time, which
+ * does not count as holding the lock
+ * @param Profile the profile
+ * @param ProfileThread the thread
+ * @param long long the time the wait started
+ * @param int 1 if the wakeup found nothing to do, 0 otherwise
+ */
+void profile_woken(Profile *, ProfileThread, long long, int);
+
+/**
+ * Prints a profile as a table
+ * @param Profile the profile
+ * @param FILE the output
+ */
+void profile_print(const Profile *, FILE *);
+
+#endif
@@ -6,6 +6,9 @@
 #include "queue.h"
 #include "process.h"
 #include "algorithm.h"
+#include "policy.h"
+#include "loader.h"
+#include "scheduler_loop.h"
 
 typedef struct round_robin RR;
 
@@ -85,8 +88,50 @@ static int __rr_put(Process *p, void *arg) {
   return queue_push_back(rr->queue, p);
 }
 
+// run until the quantum is reached
+static int __rr_slice(Process *p, void *arg) {
+  if (p == NULL || arg == NULL) {
+    return -1;
+  }
+
+  RR *rr = (RR *) arg;
+
+  return rr->quantum - process_current_tick(p);
+}
+
+SCHEDULER_LOOP(__rr_loop, __rr_arrive, __rr_ready, __rr_get, __rr_put, __rr_slice)
+
+// destroys the data with the algorithm
+static void __rr_delete(void *arg) {
+  delete_round_robin((RR *) arg);
+}
+
+Algorithm *new_rr_algorithm(int quantum) {
+  RR *data = new_round_robin(quantum);
+
+  Algorithm *algo = new_algorithm(__rr_arrive, __rr_ready, __rr_get, __rr_put, data);
+
+  algorithm_set_on_delete(algo, __rr_delete);
+
+  algorithm_set_on_slice(algo, __rr_slice);
+
+  algorithm_set_loop(algo, __rr_loop);
+
+  return algo;
+}
+
+#ifndef POLICY_LIBRARY
+
 int main(int argc, char *argv[]) {
 
+  // the workload file and switch cost, taken out of the arguments
+  LoaderOptions options;
+
+  if (loader_options(&argc, argv, &options)) {
+    puts("invalid argument");
+    return 1;
+  }
+
   int quantum = 3;
 
   if (argc > 1) {
@@ -98,24 +143,24 @@ int main(int argc, char *argv[]) {
     }
   }
 
-  RR *data = new_round_robin(quantum);
-
   // create the algorithm
-  Algorithm *algo = new_algorithm(__rr_arrive, __rr_ready, __rr_get, __rr_put, data);
+  Algorithm *algo = new_rr_algorithm(quantum);
 
   // create the scheduler
   Scheduler *sched = new_scheduler(algo);
 
-  // read the processes
-  scheduler_read_processes(sched);
+  // set the switch cost and read the processes
+  if (loader_setup(sched, &options)) {
+    delete_scheduler(sched);
+    return 1;
+  }
 
   // run
   int result = scheduler_run(sched);
 
   delete_scheduler(sched);
 
-  delete_round_robin(data);
-
   return result;
 }
 
+#endif
@@ -1,12 +1,18 @@
 #include <stdlib.h>
 #include <pthread.h>
 #include <stdio.h>
+#include <string.h>
+#include <limits.h>
 
 #include "types.h"
 #include "scheduler.h"
 #include "queue.h"
 #include "process.h"
 #include "algorithm.h"
+#include "heap.h"
+#include "scheduler_loop.h"
+#include "stats.h"
+#include "profile.h"
 
 // an error occurred in scheduler
 #define SCHEDULER_ERROR -1
@@ -19,12 +25,49 @@
 
 
 #define SCHEDULER_FLAG_DAEMON (1 << 0)
+#define SCHEDULER_FLAG_QUIET  (1 << 1)
+
+// the initial number of arrivals handed over at once
+#define SCHEDULER_BATCH 16
+
+// the share group of processes without one
+#define SCHEDULER_DEFAULT_GROUP "default"
 
 struct scheduler {
   // a queue for new arrivals
   Queue *arrivals;
   // completed processes queue
   Queue *completed;
+  // the processes read or created by the scheduler
+  ProcessTable *processes;
+  // the number of completed processes
+  int finished;
+  // the number of processes added from other tables
+  int foreign;
+  // the number of time slices given to processes
+  long long dispatches;
+  // the number of time slices given to another process than the last
+  long long switches;
+  // the process given the last time slice
+  Process *running;
+  // the cost of a context switch
+  SwitchCost cost;
+  // the ticks spent switching
+  long long overhead;
+  // processes blocked on I/O, by the tick they wake
+  Heap *blocked;
+  // the number of processes blocked, so loops without I/O skip the heap
+  int blocked_count;
+  // the ticks at least one process was blocked on I/O
+  long long io_ticks;
+  // the tick the blocked processes became more than none
+  int io_since;
+  // the ticks a process ran while another was blocked on I/O
+  long long overlap;
+  // the tick the last time slice started (-1 once it ended)
+  int slice_start;
+  // whether a process was blocked on I/O when the time slice started
+  int slice_io;
   // the algorithm to manage processing
   Algorithm *algorithm;
   // a status code (see above)
@@ -33,10 +76,17 @@ struct scheduler {
   int error;
   // current tick in the clock
   int tick;
+  // arrivals due in the same tick, handed to the algorithm at once
+  Process **batch;
+  // the allocated number of batch arrivals
+  int batch_capacity;
 
   // flags for runtime
   int flags;
 
+  // the hot path instrumentation, when compiled with SCHEDULER_PROFILE
+  Profile profile;
+
   // a signal the producer has a new process
   pthread_cond_t new_process;
   // a signal the consumer has a scheduled process
@@ -45,6 +95,32 @@ struct scheduler {
   pthread_mutex_t lock;
 };
 
+// statistics of the completed processes
+typedef struct run_summary {
+  // every completed process
+  Stats stats;
+  // each group, the first for processes without one
+  StatsGroup *groups;
+  // the name of each group
+  const char **names;
+  // the number of groups, including processes without one
+  int size;
+  // whether any process had a group
+  int grouped;
+} RunSummary;
+
+// orders blocked processes by the tick they wake, then by id so runs are repeatable
+static int __scheduler_compare_wakeups(void *a, void *b) {
+  int wake1 = process_ready_time((Process *) a);
+  int wake2 = process_ready_time((Process *) b);
+
+  if (wake1 != wake2) {
+    return wake1 < wake2 ? -1 : 1;
+  }
+
+  return process_id((Process *) a) < process_id((Process *) b) ? -1 : 1;
+}
+
 /**
  * allocates a new scheduler instance
  * @return the scheduler created
@@ -60,6 +136,22 @@ Scheduler *new_scheduler(Algorithm *algo) {
   // create queues
   value->arrivals = new_queue();
   value->completed = new_queue();
+  value->processes = new_process_table();
+  value->finished = 0;
+  value->foreign = 0;
+  value->dispatches = 0;
+  value->switches = 0;
+  value->running = NULL;
+  value->overhead = 0;
+  value->blocked = new_heap(__scheduler_compare_wakeups);
+  value->blocked_count = 0;
+  value->io_ticks = 0;
+  value->io_since = 0;
+  value->overlap = 0;
+  value->slice_start = -1;
+  value->slice_io = 0;
+
+  memset(&value->cost, 0, sizeof(SwitchCost));
 
   // initialize
   value->algorithm = algo;
@@ -68,6 +160,15 @@ Scheduler *new_scheduler(Algorithm *algo) {
   value->tick = 0;
   value->flags = 0;
 
+  profile_init(&value->profile);
+
+  value->batch = malloc(SCHEDULER_BATCH * sizeof(Process *));
+  value->batch_capacity = SCHEDULER_BATCH;
+
+  if (value->batch == NULL) {
+    abort();
+  }
+
   pthread_mutex_init(&value->lock, NULL);
 
   pthread_cond_init(&value->new_process, NULL);
@@ -84,18 +185,37 @@ Scheduler *new_scheduler_daemon(Algorithm *algo) {
   return value;
 }
 
+// destroys a process allocated with new_process
+static int __scheduler_delete_iterator(Queue *queue, int index, void *data, void *arg) {
+  (void) queue;
+  (void) index;
+  (void) arg;
+
+  delete_process((Process *) data);
+
+  return QUEUE_ITERATE_NEXT;
+}
+
 /**
  * frees an allocated scheduler instance
- * NOTE: does not delete processes in the queues
+ * NOTE: destroys the processes in the queues, not those held by the algorithm
  * @param value the scheduler instance
  */
 void delete_scheduler(Scheduler *value) {
 
-  delete_queue_data(value->arrivals);
-  delete_queue_data(value->completed);
+  // processes of their own, the rest are destroyed with the table
+  queue_iterate(value->arrivals, __scheduler_delete_iterator, NULL);
+  queue_iterate(value->completed, __scheduler_delete_iterator, NULL);
+
+  delete_queue_list(value->arrivals);
+  delete_queue_list(value->completed);
+  delete_heap(value->blocked);
+  delete_process_table(value->processes);
 
   delete_algorithm(value->algorithm);
 
+  free(value->batch);
+
   pthread_mutex_destroy(&value->lock);
 
   pthread_cond_destroy(&value->scheduled_process);
@@ -146,18 +266,58 @@ static int __scheduler_has_new_arrival(Scheduler *sched) {
  * @return 0 on success, -1 on error
  */
 static int __scheduler_wait_for_new_process(Scheduler *sched) {
-  // while there is no new arrival...
-  while(!__scheduler_has_new_arrival(sched)) {
+  // while there is no new arrival, and the consumer did not hand over the last one...
+  while(sched->status == SCHEDULER_ALIVE && !__scheduler_has_new_arrival(sched)) {
+    PROFILE_START(wait);
 
     // wait for a new item on the queue
     if (pthread_cond_wait(&sched->new_process, &sched->lock)) {
       return -1;
     }
+
+    PROFILE_WOKEN(&sched->profile, PROFILE_PRODUCER, wait, !__scheduler_has_new_arrival(sched));
   }
 
   return 0;
 }
 
+/**
+ * hands every arrival due to the algorithm, by the producer or by the
+ * consumer while the cpu switches between processes
+ * @param sched the scheduler instance
+ * @return 0 on success, -1 on error
+ */
+static int __scheduler_arrive(Scheduler *sched) {
+  int count = 0;
+
+  // remove every arrival due
+  Process **batch = scheduler_pop_arrivals(sched, sched->tick, &count);
+
+  PROFILE_START(output);
+
+  for (int i = 0; i < count && (sched->flags & SCHEDULER_FLAG_QUIET) == 0; i++) {
+    printf("Time %02d : Process %s Arrival %02d\n", sched->tick, process_name(batch[i]),
+        process_arrival_time(batch[i]));
+  }
+
+  PROFILE_SECTION(&sched->profile, PROFILE_OUTPUT, output);
+  PROFILE_START(arrive);
+
+  // pass to the algorithm to insert in its queue at once
+  int err = algorithm_process_arrive_batch(sched->algorithm, batch, count);
+
+  PROFILE_SECTION(&sched->profile, PROFILE_ARRIVE, arrive);
+
+  if ((sched->flags & SCHEDULER_FLAG_DAEMON) == 0) {
+    // when nothing in the arrival queue, set the scheduler as "done"
+    if (queue_is_empty(sched->arrivals)) {
+      sched->status = SCHEDULER_DONE;
+    }
+  }
+
+  return err;
+}
+
 /**
  * produces new arrivals and puts them on the queue
  * @param arg the thread parameter (should be scheduler instance)
@@ -169,6 +329,7 @@ static void *__scheduler_produce(void *arg) {
 
   // while the scheduler is active...
   while(sched->status == SCHEDULER_ALIVE) {
+    PROFILE_START(lock);
 
     // lock the scheduler
     err = pthread_mutex_lock(&sched->lock);
@@ -177,6 +338,8 @@ static void *__scheduler_produce(void *arg) {
       break;
     }
 
+    PROFILE_LOCKED(&sched->profile, PROFILE_PRODUCER, lock);
+
     // wait for new arrivals
     err = __scheduler_wait_for_new_process(sched);
 
@@ -184,28 +347,14 @@ static void *__scheduler_produce(void *arg) {
       break;
     }
 
-    // remove the first arrival and put on the queue
-    Process *p = queue_pop_front(sched->arrivals);
-
-    if (p != NULL) {
-      
-      printf("Time %02d : Process %s Arrival %02d\n", sched->tick, process_name(p), 
-          process_arrival_time(p));
-
-      // pass to the algorithm to insert in its queue
-      err = algorithm_process_arrive(sched->algorithm, p);
+    // pass every arrival due to the algorithm
+    err = __scheduler_arrive(sched);
 
-      if (__scheduler_error(sched, err, "algorithm_new_arrival")) {
-        break;
-      }
+    if (__scheduler_error(sched, err, "algorithm_new_arrival")) {
+      break;
     }
 
-    if ((sched->flags & SCHEDULER_FLAG_DAEMON) == 0) {
-      // when nothing in the arrival queue, set the scheduler as "done"
-      if (queue_size(sched->arrivals) == 0) {
-        sched->status = SCHEDULER_DONE;
-      }
-    }
+    PROFILE_UNLOCKED(&sched->profile, PROFILE_PRODUCER);
 
     // unlock the scheduler
     err = pthread_mutex_unlock(&sched->lock);
@@ -225,6 +374,53 @@ static void *__scheduler_produce(void *arg) {
   return NULL;
 }
 
+/**
+ * tests the algorithm has a process ready
+ * @param sched the scheduler instance
+ * @return positive if ready, 0 otherwise
+ */
+static int __scheduler_ready(Scheduler *sched) {
+  PROFILE_START(start);
+
+  int ready = algorithm_process_ready(sched->algorithm);
+
+  PROFILE_SECTION(&sched->profile, PROFILE_READY, start);
+
+  return ready;
+}
+
+/**
+ * hands the processes done with their I/O back to the algorithm
+ * @param sched the scheduler instance
+ * @return 0 on success, -1 on error
+ */
+static int __scheduler_wake(Scheduler *sched) {
+  int count = 0;
+
+  Process **batch = scheduler_pop_wakeups(sched, sched->tick, &count);
+
+  if (count == 0) {
+    return 0;
+  }
+
+  PROFILE_START(output);
+
+  for (int i = 0; i < count && (sched->flags & SCHEDULER_FLAG_QUIET) == 0; i++) {
+    printf("Time %02d : Process %s Wakeup %02d\n", sched->tick, process_name(batch[i]),
+        process_current_service_time(batch[i]));
+  }
+
+  PROFILE_SECTION(&sched->profile, PROFILE_OUTPUT, output);
+  PROFILE_START(arrive);
+
+  // back through arrive, like a new process
+  int err = algorithm_process_arrive_batch(sched->algorithm, batch, count);
+
+  PROFILE_SECTION(&sched->profile, PROFILE_ARRIVE, arrive);
+
+  return err;
+}
+
 /**
  * waits for a new process in the queue
  * @param sched the scheduler instance
@@ -232,15 +428,82 @@ static void *__scheduler_produce(void *arg) {
  */
 static int __scheduler_wait_for_scheduled_process(Scheduler *sched) {
   // test the algorithm doesn't have a process ready
-  while (!algorithm_process_ready(sched->algorithm)) {
+  while (!__scheduler_ready(sched)) {
+    int wakeup = scheduler_next_wakeup(sched);
+    Process *next = queue_peek_front(sched->arrivals);
+
+    // the cpu is idle until a process is done with its I/O, unless another arrives first
+    if (wakeup != -1 && (next == NULL || wakeup < process_arrival_time(next))) {
+      if (wakeup > sched->tick) {
+        sched->tick = wakeup;
+      }
+
+      if (__scheduler_wake(sched)) {
+        return -1;
+      }
+      continue;
+    }
+
+    // the cpu is idle until the next arrival
+    if (!queue_is_empty(sched->arrivals) && !__scheduler_has_new_arrival(sched)) {
+      sched->tick = process_arrival_time(queue_peek_front(sched->arrivals));
+
+      if (pthread_cond_signal(&sched->new_process)) {
+        return -1;
+      }
+    }
+
+    PROFILE_START(wait);
+
     if (pthread_cond_wait(&sched->scheduled_process, &sched->lock)) {
       return -1;
     }
+
+    PROFILE_WOKEN(&sched->profile, PROFILE_CONSUMER, wait, !algorithm_process_ready(sched->algorithm));
   }
 
   return 0;
 }
 
+/**
+ * gets the ticks a process can run before it is put back, ending
+ * at the next arrival or wakeup so the algorithm can prempt, or when
+ * the process blocks for I/O
+ * @param sched the scheduler instance
+ * @param p the process taken from the algorithm
+ * @return the ticks, at least 1
+ */
+static int __scheduler_slice(Scheduler *sched, Process *p) {
+  PROFILE_START(start);
+
+  int slice = algorithm_process_slice(sched->algorithm, p);
+
+  PROFILE_SECTION(&sched->profile, PROFILE_SLICE, start);
+
+  if (slice < 1) {
+    return 1;
+  }
+
+  // the cpu burst ends before the time slice, so the process can block for I/O
+  int burst = process_current_burst_time(p);
+
+  if (burst > 0 && burst < slice) {
+    slice = burst;
+  }
+
+  int next = scheduler_next_event(sched);
+
+  if (next != -1) {
+    int until = next - sched->tick;
+
+    if (until < slice) {
+      return until < 1 ? 1 : until;
+    }
+  }
+
+  return slice;
+}
+
 /**
  * consumes new arrival put on the queue.
  * the scheduler will use the algorithm specified to
@@ -254,6 +517,7 @@ static void *__scheduler_consume(void *arg) {
 
   // while the scheduler is still alive or the producer is done...
   while(sched->status >= SCHEDULER_ALIVE) {
+    PROFILE_START(lock);
 
     // lock the scheduler
     err = pthread_mutex_lock(&sched->lock);
@@ -262,6 +526,8 @@ static void *__scheduler_consume(void *arg) {
       break;
     }
 
+    PROFILE_LOCKED(&sched->profile, PROFILE_CONSUMER, lock);
+
     // if the queue is empty, wait for a new process
     err = __scheduler_wait_for_scheduled_process(sched);
 
@@ -269,35 +535,101 @@ static void *__scheduler_consume(void *arg) {
       break;
     }
 
+    // processes done with their I/O this tick
+    err = __scheduler_wake(sched);
+
+    if (__scheduler_error(sched, err, "scheduler_wake")) {
+      break;
+    }
+
+    PROFILE_START(get);
+
     // run the algorithm to find the next process in the queue
     Process *p = algorithm_process_get(sched->algorithm);
 
+    PROFILE_SECTION(&sched->profile, PROFILE_GET, get);
+
     // if there is a process in the queue...
     if (p != NULL) {
 
-      // output and update tick count
-      printf("Time %02d : Process %s Service %02d\n", sched->tick, process_name(p), 
-          process_current_service_time(p));
+      // count the time slice and the first time the process runs
+      int overhead = scheduler_dispatch_process(sched, p, sched->tick);
+
+      if (__scheduler_error(sched, overhead == -1 ? -1 : 0, "scheduler_dispatch_process")) {
+        break;
+      }
+
+      // the cpu switches to the process before it runs
+      for (; overhead > 0 && err == 0; overhead--) {
+        if ((sched->flags & SCHEDULER_FLAG_QUIET) == 0) {
+          printf("Time %02d : Process %s Switch %02d\n", sched->tick, process_name(p), overhead);
+        }
+
+        sched->tick++;
+
+        // the arrivals and wakeups of each tick are handed over while switching
+        err = __scheduler_arrive(sched) || __scheduler_wake(sched) ? -1 : 0;
+      }
+
+      if (__scheduler_error(sched, err, "scheduler_switch")) {
+        break;
+      }
+
+      // the ticks the process can run before it is put back
+      int slice = __scheduler_slice(sched, p);
+
+      int current = 0;
+
+      do {
+        // output and update tick count
+        if ((sched->flags & SCHEDULER_FLAG_QUIET) == 0) {
+          PROFILE_START(output);
+
+          printf("Time %02d : Process %s Service %02d\n", sched->tick, process_name(p), 
+              process_current_service_time(p));
 
-      sched->tick++;
+          PROFILE_SECTION(&sched->profile, PROFILE_OUTPUT, output);
+        }
 
-      // execute a time slice on the process
-      int current = process_run(p);
+        sched->tick++;
+
+        // execute a tick of the time slice on the process
+        current = process_run(p);
+
+      } while (--slice > 0 && current > 0);
 
       switch(current) {
         case 0:
           // no more service time, set as completed
-          process_set_completion_time(p, sched->tick);
-          err = queue_push_back(sched->completed, p);
+          err = scheduler_complete_process(sched, p, sched->tick);
           break;
         case -1:
           // record funkiness
           sched->status = SCHEDULER_ERROR;
           break;
-        default: 
+        default: {
+          // the cpu burst ended, so the process blocks until its I/O is done
+          if (process_io_due(p)) {
+            int io = scheduler_block_process(sched, p, sched->tick);
+
+            if (io != -1 && (sched->flags & SCHEDULER_FLAG_QUIET) == 0) {
+              printf("Time %02d : Process %s Blocked %02d\n", sched->tick, process_name(p), io);
+            }
+
+            err = io == -1 ? -1 : 0;
+            break;
+          }
+
+          process_set_ready_time(p, sched->tick);
+
+          PROFILE_START(put);
+
           // use algorithm to put process back in queue
           err = algorithm_process_put(sched->algorithm, p);
+
+          PROFILE_SECTION(&sched->profile, PROFILE_PUT, put);
           break;
+        }
 
       }
 
@@ -308,12 +640,14 @@ static void *__scheduler_consume(void *arg) {
 
     // quick check to stop the consumer if producer is done
     if (sched->status == SCHEDULER_DONE && (sched->flags & SCHEDULER_FLAG_DAEMON) == 0) {
-      // test no more processes in algorithm queue
-      if (!algorithm_process_ready(sched->algorithm)) {
+      // test no more processes in algorithm queue or blocked on I/O
+      if (!__scheduler_ready(sched) && sched->blocked_count == 0) {
         sched->status = SCHEDULER_END;
       }
     }
 
+    PROFILE_UNLOCKED(&sched->profile, PROFILE_CONSUMER);
+
     // unlock the scheduler
     err = pthread_mutex_unlock(&sched->lock);
 
@@ -335,6 +669,68 @@ static void *__scheduler_consume(void *arg) {
   return NULL;
 }
 
+// the callbacks of any algorithm, for a loop not specialized to one
+static inline int __scheduler_loop_arrive(Process **batch, int n, void *arg) {
+  Scheduler *sched = (Scheduler *) arg;
+
+  PROFILE_START(start);
+
+  int err = algorithm_process_arrive_batch(sched->algorithm, batch, n);
+
+  PROFILE_SECTION(&sched->profile, PROFILE_ARRIVE, start);
+
+  return err;
+}
+
+static inline int __scheduler_loop_ready(void *arg) {
+  return __scheduler_ready((Scheduler *) arg);
+}
+
+static inline Process *__scheduler_loop_get(void *arg) {
+  Scheduler *sched = (Scheduler *) arg;
+
+  PROFILE_START(start);
+
+  Process *p = algorithm_process_get(sched->algorithm);
+
+  PROFILE_SECTION(&sched->profile, PROFILE_GET, start);
+
+  return p;
+}
+
+static inline int __scheduler_loop_put(Process *p, void *arg) {
+  Scheduler *sched = (Scheduler *) arg;
+
+  PROFILE_START(start);
+
+  int err = algorithm_process_put(sched->algorithm, p);
+
+  PROFILE_SECTION(&sched->profile, PROFILE_PUT, start);
+
+  return err;
+}
+
+static inline int __scheduler_loop_slice(Process *p, void *arg) {
+  Scheduler *sched = (Scheduler *) arg;
+
+  PROFILE_START(start);
+
+  int slice = algorithm_process_slice(sched->algorithm, p);
+
+  PROFILE_SECTION(&sched->profile, PROFILE_SLICE, start);
+
+  return slice;
+}
+
+SCHEDULER_LOOP_BATCH(__scheduler_loop, __scheduler_loop_arrive, __scheduler_loop_ready,
+    __scheduler_loop_get, __scheduler_loop_put, __scheduler_loop_slice)
+
+static void __scheduler_print_stats(Scheduler *);
+static int __scheduler_summary(Scheduler *, RunSummary *);
+static void __scheduler_summary_free(RunSummary *);
+static void __scheduler_print_groups(RunSummary *);
+static int __scheduler_sweep(Scheduler *, Comparator);
+
 /**
  * runs the scheduler by spawning an arrival producer,
  * a process consumer, and a cpu ticks.
@@ -365,166 +761,1223 @@ int scheduler_run(Scheduler *sched) {
   pthread_join(producer, NULL);
   pthread_join(consumer, NULL);
 
-  printf("\n%-24s : %.2f\n", "Average Turn Around Time", scheduler_avg_turnaround_time(sched));
-  printf("%-24s : %.2f\n\n", "Average Wait Time", scheduler_avg_wait_time(sched));
+  __scheduler_print_stats(sched);
 
   return sched->error;
 }
 
-
 /**
- * adds a process to the scheduler arrivals queue
- * @param sched the scheduler
- * @param p the process
- * @return -1 on error, 0 on success
+ * runs a non-premptive schedule without simulating ticks.
+ * completion times are prefix sums of the service times in dispatch
+ * order, so every process is dispatched once from a heap of waiting
+ * processes, gated by arrival time.  the dispatch order matches the
+ * tick based engine: every process arrived by the tick another completes,
+ * including the ticks the cpu spent switching, is considered.
+ * @param sched the scheduler instance
+ * @param compare orders waiting processes, NULL for arrival order
+ * @return 0 on success, otherwise an integer indicating an error
  */
-int scheduler_add_process(Scheduler *sched, Process *p) {
-  // sanitize
-  if (sched == NULL || p == NULL) {
+int scheduler_run_analytic(Scheduler *sched, Comparator compare) {
+  if (sched == NULL) {
     return -1;
   }
 
-  if (pthread_mutex_lock(&sched->lock)) {
-    return -1;
-  }
+  int err = pthread_mutex_lock(&sched->lock);
 
-  // push process onto arrivals queue
-  if (queue_push_back(sched->arrivals, p)) {
-    pthread_mutex_unlock(&sched->lock);
-    return -1;
+  if (__scheduler_error(sched, err, "pthread_mutex_lock")) {
+    return sched->error;
   }
 
-  // sort the arrivals based on arrival time
-  if (queue_sort(sched->arrivals, process_compare_arrival_times) == -1) {
-    pthread_mutex_unlock(&sched->lock);
-    return -1;
-  }
+  sched->status = SCHEDULER_ALIVE;
 
-  if (pthread_mutex_unlock(&sched->lock)) {
-    return -1;
+  err = __scheduler_sweep(sched, compare);
+
+  __scheduler_error(sched, err, "scheduler_sweep");
+
+  if (sched->status != SCHEDULER_ERROR) {
+    sched->status = SCHEDULER_END;
   }
 
-  if (pthread_cond_signal(&sched->new_process)) {
-    return -1;
+  err = pthread_mutex_unlock(&sched->lock);
+
+  if (__scheduler_error(sched, err, "pthread_mutex_unlock")) {
+    return sched->error;
   }
 
-  return 0;
+  __scheduler_print_stats(sched);
+
+  return sched->error;
 }
 
 /**
- * reads process information from input
+ * runs the scheduler in a single thread, without the producer and
+ * consumer.  uses the loop specialized for the algorithm when it has
+ * one, otherwise a loop calling through the algorithm callbacks.
  * @param sched the scheduler instance
- * @return 0 if items were added to the queue, 1 if not, -1 on error
+ * @return 0 on success, otherwise an integer indicating an error
  */
-int scheduler_read_processes(Scheduler *sched) {
+int scheduler_run_serial(Scheduler *sched) {
+  if (sched == NULL) {
+    return -1;
+  }
 
-  char buf[BUFSIZ] = {0};
+  int err = pthread_mutex_lock(&sched->lock);
 
-  // prompt the user
-  puts("Enter processes in the following format (enter blank line to quit):\n");
+  if (__scheduler_error(sched, err, "pthread_mutex_lock")) {
+    return sched->error;
+  }
 
-  puts("<Name> <Arrival Time> <Service Time>\n");
+  sched->status = SCHEDULER_ALIVE;
 
-  // while reading from standard input...
-  while(fgets(buf, BUFSIZ, stdin)) {
-    char name[100] = {0};
-    int atime = 0;
-    int stime = 0;
+  if (algorithm_has_loop(sched->algorithm)) {
+    err = algorithm_run_loop(sched->algorithm, sched);
+  } else {
+    err = __scheduler_loop(sched, sched);
+  }
 
-    // scan the line for parameters
-    if (sscanf(buf, "%99s %d %d", name, &atime, &stime) != 3) {
-      // check for empty line
-      if (buf[0] == '\n') {
-        break;
-      }
-      // otherwise print error
-      puts("Sorry, invalid format or could not scan.  Please try again.");
-      continue;
-    }
+  __scheduler_error(sched, err, "scheduler_loop");
 
-    // create a new process with specified parameters
-    Process *p = new_process(name);
+  if (sched->status != SCHEDULER_ERROR) {
+    sched->status = SCHEDULER_END;
+  }
 
-    if (process_set_arrival_time(p, atime) == -1) {
-      puts("unable to set arrival time");
-      return -1;
-    }
+  err = pthread_mutex_unlock(&sched->lock);
 
-    if (process_set_service_time(p, stime) == -1) {
-      puts("unable to set process service time");
-      return -1;
-    }
+  if (__scheduler_error(sched, err, "pthread_mutex_unlock")) {
+    return sched->error;
+  }
 
-    // finally add the process to the arrivals queue
-    if (scheduler_add_process(sched, p) == -1) {
-      puts("unable to add process to scheduler");
-      return -1; 
-    }
+  __scheduler_print_stats(sched);
 
-    printf("Added : Process %s Arrival %02d Service %02d\n", name, atime, stime);
-  }
+  return sched->error;
+}
 
-  printf("\n");
+// the ticks the cpu had nothing to run, from tick 0 to the last completion
+static long long __scheduler_idle_ticks(Scheduler *sched, const Stats *stats) {
+  return stats->count == 0 ? 0 : stats->last_completion - stats->service - sched->overhead;
+}
 
-  // return 0 if items were added to queue 1 otherwise
-  return queue_size(sched->arrivals) > 0 ? 0 : 1;
+// the share of the ticks the cpu was servicing processes
+static double __scheduler_utilization(const Stats *stats) {
+  return stats->count == 0 || stats->last_completion <= 0 ? 0 : (double) stats->service / stats->last_completion;
 }
 
-// iterates a queue tracking the total turnaround time
-static int __process_turnaround_time_iterator(Queue *list, int index, void *data, void *arg) {
+// the processes completed per 1000 ticks
+static double __scheduler_throughput(const Stats *stats) {
+  return stats->count == 0 || stats->last_completion <= 0 ? 0 : 1000.0 * stats->count / stats->last_completion;
+}
 
-  if (list == NULL || arg == NULL || data == NULL || index == -1) {
+/**
+ * prints the statistics of the completed processes
+ * @param sched the scheduler instance
+ */
+static void __scheduler_print_stats(Scheduler *sched) {
+  RunSummary summary;
+
+  if (sched->flags & SCHEDULER_FLAG_QUIET || __scheduler_summary(sched, &summary) == -1) {
+    return;
+  }
+
+  Stats *stats = &summary.stats;
+
+  printf("\n%-24s : %.2f\n", "Average Turn Around Time", (float) ((double) stats->turnaround / stats->count));
+  printf("%-24s : %.2f\n\n", "Average Wait Time", (float) ((double) stats->wait / stats->count));
+
+  printf("%-24s : %.2f\n", "Average Response Time", (float) ((double) stats->response / stats->count));
+  printf("%-24s : %.2f\n", "Average Dispatches", (float) ((double) stats->dispatches / stats->count));
+  printf("%-24s : %lld\n", "Preemptions", stats->preemptions);
+  printf("%-24s : %.2f\n", "Average Longest Wait", (float) ((double) stats->longest_wait / stats->count));
+  printf("%-24s : %d\n\n", "Maximum Longest Wait", stats->max_longest_wait);
+
+  printf("%-24s : %lld\n", "Context Switches", sched->switches);
+  printf("%-24s : %lld\n", "Overhead Ticks", sched->overhead);
+  printf("%-24s : %lld\n", "Idle Ticks", __scheduler_idle_ticks(sched, stats));
+  printf("%-24s : %.2f%%\n", "CPU Utilization", 100 * __scheduler_utilization(stats));
+  printf("%-24s : %.2f\n\n", "Throughput (per 1000)", __scheduler_throughput(stats));
+
+  // only report I/O when processes blocked on it
+  if (sched->io_ticks > 0) {
+    printf("%-24s : %lld\n", "I/O Ticks", sched->io_ticks);
+    printf("%-24s : %.2f%%\n\n", "I/O Overlap", 100 * scheduler_io_overlap(sched));
+  }
+
+  // only report deadlines when processes had them
+  if (stats->deadlines > 0) {
+    printf("%-24s : %lld/%lld\n", "Deadline Misses", stats->misses, stats->deadlines);
+    printf("%-24s : %.2f\n", "Average Tardiness", (float) ((double) stats->tardiness / stats->deadlines));
+    printf("%-24s : %d\n\n", "Maximum Tardiness", stats->max_tardiness);
+  }
+
+  __scheduler_print_groups(&summary);
+
+  __scheduler_summary_free(&summary);
+
+#ifdef SCHEDULER_PROFILE
+  profile_print(&sched->profile, stderr);
+#endif
+}
+
+
+/**
+ * sorts the arrivals by arrival time
+ * @param sched the scheduler instance
+ * @return 0 on success, -1 on error
+ */
+static int __scheduler_sort_arrivals(Scheduler *sched) {
+  PROFILE_START(start);
+
+  int err = queue_sort(sched->arrivals, process_compare_arrival_times);
+
+  PROFILE_SECTION(&sched->profile, PROFILE_SORT, start);
+
+  return err;
+}
+
+/**
+ * adds a process to the scheduler arrivals queue
+ * @param sched the scheduler
+ * @param p the process
+ * @return -1 on error, 0 on success
+ */
+int scheduler_add_process(Scheduler *sched, Process *p) {
+  // sanitize
+  if (sched == NULL || p == NULL) {
     return -1;
   }
 
-  int *total = (int*) arg;
-  Process *p = (Process *) data;
+  if (pthread_mutex_lock(&sched->lock)) {
+    return -1;
+  }
 
-  *total += (process_completion_time(p) - process_arrival_time(p));
+  // the latest arrival so far
+  Process *last = queue_peek_back(sched->arrivals);
 
-  return QUEUE_ITERATE_NEXT;
+  // push process onto arrivals queue
+  if (queue_push_back(sched->arrivals, p)) {
+    pthread_mutex_unlock(&sched->lock);
+    return -1;
+  }
+
+  // the statistics can only scan the table when every process is in it
+  if (process_table(p) != sched->processes) {
+    sched->foreign++;
+  }
+
+  // sort the arrivals based on arrival time, unless added in order
+  if (last != NULL && process_compare_arrival_times(last, p) > 0 &&
+      __scheduler_sort_arrivals(sched) == -1) {
+    pthread_mutex_unlock(&sched->lock);
+    return -1;
+  }
+
+  if (pthread_mutex_unlock(&sched->lock)) {
+    return -1;
+  }
+
+  if (pthread_cond_signal(&sched->new_process)) {
+    return -1;
+  }
+
+  return 0;
+}
+
+/**
+ * adds processes to the scheduler arrivals queue at once
+ * @param sched the scheduler
+ * @param processes the processes
+ * @param count the number of processes
+ * @return -1 on error, 0 on success
+ */
+int scheduler_add_processes(Scheduler *sched, Process **processes, int count) {
+  // sanitize
+  if (sched == NULL || processes == NULL || count < 0) {
+    return -1;
+  }
+
+  if (pthread_mutex_lock(&sched->lock)) {
+    return -1;
+  }
+
+  // the latest arrival so far
+  Process *last = queue_peek_back(sched->arrivals);
+
+  // whether the arrivals need sorting after the pushes
+  int sort = 0;
+
+  for (int i = 0; i < count; i++) {
+    Process *p = processes[i];
+
+    if (p == NULL || queue_push_back(sched->arrivals, p)) {
+      pthread_mutex_unlock(&sched->lock);
+      return -1;
+    }
+
+    if (process_table(p) != sched->processes) {
+      sched->foreign++;
+    }
+
+    sort |= last != NULL && process_compare_arrival_times(last, p) > 0;
+    last = p;
+  }
+
+  // sort once rather than after each push
+  if (sort && __scheduler_sort_arrivals(sched) == -1) {
+    pthread_mutex_unlock(&sched->lock);
+    return -1;
+  }
+
+  if (pthread_mutex_unlock(&sched->lock)) {
+    return -1;
+  }
+
+  if (pthread_cond_signal(&sched->new_process)) {
+    return -1;
+  }
+
+  return 0;
+}
+
+// parses an optional integer column, leaving the default for a -
+static int __scheduler_parse_column(const char *column, int *value) {
+  if (strcmp(column, "-") == 0) {
+    return 0;
+  }
+
+  char *end = NULL;
+
+  long result = strtol(column, &end, 10);
+
+  if (end == column || *end != '\0' || result < INT_MIN || result > INT_MAX) {
+    return -1;
+  }
+
+  *value = (int) result;
+  return 0;
+}
+
+// tests I/O bursts fit in a service time, before the process is created
+static int __scheduler_check_bursts(const char *bursts, int service) {
+  Process *p = new_process(NULL);
+
+  int err = process_set_service_time(p, service) || process_add_io_bursts(p, bursts, (int) strlen(bursts));
+
+  delete_process(p);
+  return err ? -1 : 0;
+}
+
+/**
+ * reads process information from input
+ * @param sched the scheduler instance
+ * @return 0 if items were added to the queue, 1 if not, -1 on error
+ */
+int scheduler_read_processes(Scheduler *sched) {
+
+  char buf[BUFSIZ] = {0};
+
+  // prompt the user
+  puts("Enter processes in the following format (enter blank line to quit):\n");
+
+  puts("<Name> <Arrival Time> <Service Time> [Priority] [Deadline] [Group] [I/O Bursts]\n");
+
+  puts("I/O bursts are cpu:io ticks separated by commas, like 3:5,4:2.\n");
+
+  puts("Use - to skip an optional column.\n");
+
+  // while reading from standard input...
+  while(fgets(buf, BUFSIZ, stdin)) {
+    char name[100] = {0};
+    int atime = 0;
+    int stime = 0;
+    int priority = PROCESS_DEFAULT_PRIORITY;
+    int deadline = 0;
+    char spriority[16] = "-";
+    char sdeadline[16] = "-";
+    char group[100] = "-";
+    char bursts[256] = "-";
+
+    // scan the line for parameters
+    if (sscanf(buf, "%99s %d %d %15s %15s %99s %255s", name, &atime, &stime, spriority, sdeadline, group,
+        bursts) < 3) {
+      // check for empty line
+      if (buf[0] == '\n') {
+        break;
+      }
+      // otherwise print error
+      puts("Sorry, invalid format or could not scan.  Please try again.");
+      continue;
+    }
+
+    if (__scheduler_parse_column(spriority, &priority) || __scheduler_parse_column(sdeadline, &deadline)) {
+      puts("Sorry, invalid format or could not scan.  Please try again.");
+      continue;
+    }
+
+    if (priority < 0 || priority >= PROCESS_PRIORITIES) {
+      puts("Sorry, priority must be between 0 and 139.  Please try again.");
+      continue;
+    }
+
+    if (deadline < 0) {
+      puts("Sorry, deadline must not be negative.  Please try again.");
+      continue;
+    }
+
+    if (strcmp(bursts, "-") != 0 && __scheduler_check_bursts(bursts, stime)) {
+      puts("Sorry, I/O bursts must be cpu:io ticks ending before the service time.  Please try again.");
+      continue;
+    }
+
+    // create a new process with specified parameters
+    Process *p = scheduler_new_process(sched, name);
+
+    if (process_set_arrival_time(p, atime) == -1) {
+      puts("unable to set arrival time");
+      return -1;
+    }
+
+    if (process_set_service_time(p, stime) == -1) {
+      puts("unable to set process service time");
+      return -1;
+    }
+
+    if (process_set_priority(p, priority) == -1) {
+      puts("unable to set process priority");
+      return -1;
+    }
+
+    if (process_set_deadline(p, deadline) == -1) {
+      puts("unable to set process deadline");
+      return -1;
+    }
+
+    if (strcmp(group, "-") != 0 && process_set_group(p, group) == -1) {
+      puts("unable to set process group");
+      return -1;
+    }
+
+    if (strcmp(bursts, "-") != 0 && process_add_io_bursts(p, bursts, (int) strlen(bursts)) == -1) {
+      puts("unable to set process I/O bursts");
+      return -1;
+    }
+
+    // finally add the process to the arrivals queue
+    if (scheduler_add_process(sched, p) == -1) {
+      puts("unable to add process to scheduler");
+      return -1; 
+    }
+
+    printf("Added : Process %s Arrival %02d Service %02d\n", name, atime, stime);
+  }
+
+  printf("\n");
+
+  // return 0 if items were added to queue 1 otherwise
+  return queue_size(sched->arrivals) > 0 ? 0 : 1;
 }
 
-// iterates a queue tracking the total wait time
-static int __process_wait_time_iterator(Queue *list, int index, void *data, void *arg) {
+// completed processes copied into columns, when not all in the table
+typedef struct gathered {
+  // the columns the statistics scan
+  ProcessColumns columns;
+  // the blocks behind the columns
+  int *ints;
+  // the name of each group
+  const char **names;
+  // the number of group names
+  int size;
+} Gathered;
+
+// iterates a queue copying the completed processes into columns
+static int __process_gather_iterator(Queue *list, int index, void *data, void *arg) {
   if (list == NULL || arg == NULL || data == NULL || index == -1) {
     return -1;
   }
 
-  int *total = (int *) arg;
+  Gathered *g = (Gathered *) arg;
   Process *p = (Process *) data;
 
-  *total += ((process_completion_time(p) - process_arrival_time(p)) - process_service_time(p));
+  int *arrival = (int *) g->columns.arrival;
+  int *service = (int *) g->columns.service;
+  int *start = (int *) g->columns.start;
+  int *completion = (int *) g->columns.completion;
+  int *deadline = (int *) g->columns.deadline;
+  int *group = (int *) g->columns.group;
+  int *dispatches = (int *) g->columns.dispatches;
+  int *preemptions = (int *) g->columns.preemptions;
+  int *longest_wait = (int *) g->columns.longest_wait;
+  int *io = (int *) g->columns.io;
+
+  arrival[index] = process_arrival_time(p);
+  service[index] = process_service_time(p);
+  start[index] = process_start_time(p);
+  completion[index] = process_completion_time(p);
+  deadline[index] = process_deadline(p);
+  group[index] = -1;
+  dispatches[index] = process_dispatches(p);
+  preemptions[index] = process_preemptions(p);
+  longest_wait[index] = process_longest_wait(p);
+  io[index] = process_io_time(p);
+
+  // the processes may be from several tables, so match the groups by name
+  const char *name = process_group(p);
+
+  if (name != NULL) {
+    int i = 0;
+
+    while (i < g->size && strcmp(g->names[i], name) != 0) {
+      i++;
+    }
+
+    g->names[i] = name;
+    g->size += i == g->size;
+
+    group[index] = i;
+  }
 
   return QUEUE_ITERATE_NEXT;
 }
 
-float scheduler_avg_turnaround_time(Scheduler *sched) {
-
+// computes the statistics of the completed processes in one pass
+static int __scheduler_summary(Scheduler *sched, RunSummary *summary) {
   if (sched == NULL || sched->status != SCHEDULER_END) {
     return -1;
   }
 
-  int total = 0;
+  Gathered gathered = { .ints = NULL, .names = NULL, .size = 0 };
+
+  ProcessColumns *columns = &gathered.columns;
+
+  int groups = 0;
+
+  // every process completed from the table, so scan its columns
+  if (sched->foreign == 0 && sched->finished == process_table_size(sched->processes)) {
+    process_table_columns(sched->processes, columns);
+
+    groups = process_table_groups(sched->processes);
+  } else {
+    int size = sched->finished;
+
+    gathered.ints = malloc((size_t) (size > 0 ? size : 1) * 10 * sizeof(int));
+    gathered.names = malloc((size > 0 ? size : 1) * sizeof(char *));
+
+    if (gathered.ints == NULL || gathered.names == NULL) {
+      abort();
+    }
+
+    columns->arrival = gathered.ints;
+    columns->service = gathered.ints + size;
+    columns->start = gathered.ints + size * 2;
+    columns->completion = gathered.ints + size * 3;
+    columns->deadline = gathered.ints + size * 4;
+    columns->group = gathered.ints + size * 5;
+    columns->priority = NULL;
+    columns->name = NULL;
+    columns->dispatches = gathered.ints + size * 6;
+    columns->preemptions = gathered.ints + size * 7;
+    columns->longest_wait = gathered.ints + size * 8;
+    columns->io = gathered.ints + size * 9;
+    columns->size = size;
+
+    if (queue_iterate(sched->completed, __process_gather_iterator, &gathered) == -1) {
+      free(gathered.ints);
+      free(gathered.names);
+      return -1;
+    }
+
+    groups = gathered.size;
+  }
+
+  summary->size = groups + 1;
+  summary->groups = malloc(summary->size * sizeof(StatsGroup));
+  summary->names = malloc(summary->size * sizeof(char *));
+
+  if (summary->groups == NULL || summary->names == NULL) {
+    abort();
+  }
+
+  summary->names[0] = SCHEDULER_DEFAULT_GROUP;
+
+  for (int i = 0; i < groups; i++) {
+    summary->names[i + 1] = gathered.ints == NULL ? process_table_group(sched->processes, i) : gathered.names[i];
+  }
+
+  stats_init(&summary->stats);
+  stats_group_init(summary->groups, summary->size);
+
+  PROFILE_START(start);
+
+  int err = stats_accumulate(&summary->stats, summary->groups, summary->size, columns);
+
+  PROFILE_SECTION(&sched->profile, PROFILE_STATS, start);
+
+  free(gathered.ints);
+  free(gathered.names);
+
+  summary->grouped = 0;
+
+  for (int i = 1; i < summary->size; i++) {
+    summary->grouped |= summary->groups[i].count > 0;
+  }
+
+  // a group named like the default is the same group
+  for (int i = 1; i < summary->size && err == 0; i++) {
+    if (strcmp(summary->names[i], SCHEDULER_DEFAULT_GROUP) == 0) {
+      StatsGroup *from = &summary->groups[i];
+      StatsGroup *to = &summary->groups[0];
+
+      to->count += from->count;
+      to->turnaround += from->turnaround;
+      to->wait += from->wait;
+      to->response += from->response;
+      to->first = from->first < to->first ? from->first : to->first;
+
+      stats_group_init(from, 1);
+    }
+  }
+
+  if (err) {
+    free(summary->groups);
+    free(summary->names);
+  }
+
+  return err;
+}
+
+static void __scheduler_summary_free(RunSummary *summary) {
+  free(summary->groups);
+  free(summary->names);
+}
+
+int scheduler_stats(Scheduler *sched, Stats *stats) {
+  RunSummary summary;
 
-  if (queue_iterate(sched->completed, __process_turnaround_time_iterator, &total) == -1) {
+  if (stats == NULL || __scheduler_summary(sched, &summary) == -1) {
     return -1;
   }
 
-  return (float) total / (float) queue_size(sched->completed);
+  *stats = summary.stats;
+
+  __scheduler_summary_free(&summary);
+  return 0;
 }
 
-float scheduler_avg_wait_time(Scheduler *sched) {
-  if (sched == NULL || sched->status != SCHEDULER_END) {
+int scheduler_profile(Scheduler *sched, Profile *profile) {
+#ifdef SCHEDULER_PROFILE
+  if (sched == NULL || profile == NULL) {
     return -1;
   }
 
-  int total = 0;
+  *profile = sched->profile;
+  return 0;
+#else
+  (void) sched;
+  (void) profile;
+  return -1;
+#endif
+}
+
+float scheduler_avg_turnaround_time(Scheduler *sched) {
+  Stats stats;
 
-  if (queue_iterate(sched->completed, __process_wait_time_iterator, &total) == -1) {
+  if (scheduler_stats(sched, &stats) == -1) {
     return -1;
   }
 
-  return (float) total / (float) queue_size(sched->completed);
+  return (double) stats.turnaround / (double) stats.count;
 }
 
+float scheduler_avg_wait_time(Scheduler *sched) {
+  Stats stats;
+
+  if (scheduler_stats(sched, &stats) == -1) {
+    return -1;
+  }
+
+  return (double) stats.wait / (double) stats.count;
+}
+
+float scheduler_avg_response_time(Scheduler *sched) {
+  Stats stats;
+
+  if (scheduler_stats(sched, &stats) == -1) {
+    return -1;
+  }
+
+  return (double) stats.response / (double) stats.count;
+}
+
+int scheduler_deadlines(Scheduler *sched) {
+  Stats stats;
+
+  if (scheduler_stats(sched, &stats) == -1) {
+    return -1;
+  }
+
+  return stats.deadlines;
+}
+
+int scheduler_deadline_misses(Scheduler *sched) {
+  Stats stats;
+
+  if (scheduler_stats(sched, &stats) == -1) {
+    return -1;
+  }
+
+  return stats.misses;
+}
+
+float scheduler_avg_tardiness(Scheduler *sched) {
+  Stats stats;
+
+  if (scheduler_stats(sched, &stats) == -1 || stats.deadlines == 0) {
+    return -1;
+  }
+
+  return (double) stats.tardiness / (double) stats.deadlines;
+}
+
+long long scheduler_idle_ticks(Scheduler *sched) {
+  Stats stats;
+
+  if (scheduler_stats(sched, &stats) == -1) {
+    return -1;
+  }
+
+  return __scheduler_idle_ticks(sched, &stats);
+}
+
+float scheduler_utilization(Scheduler *sched) {
+  Stats stats;
+
+  if (scheduler_stats(sched, &stats) == -1) {
+    return -1;
+  }
+
+  return __scheduler_utilization(&stats);
+}
+
+float scheduler_throughput(Scheduler *sched) {
+  Stats stats;
+
+  if (scheduler_stats(sched, &stats) == -1) {
+    return -1;
+  }
+
+  return __scheduler_throughput(&stats);
+}
+
+int scheduler_max_tardiness(Scheduler *sched) {
+  Stats stats;
+
+  if (scheduler_stats(sched, &stats) == -1) {
+    return -1;
+  }
+
+  return stats.max_tardiness;
+}
+
+// finds the statistics of one group
+static int __scheduler_group_find(Scheduler *sched, const char *group, StatsGroup *stats) {
+  RunSummary summary;
+
+  if (group == NULL || __scheduler_summary(sched, &summary) == -1) {
+    return -1;
+  }
+
+  int result = -1;
+
+  for (int i = 0; i < summary.size; i++) {
+    if (summary.groups[i].count > 0 && strcmp(summary.names[i], group) == 0) {
+      *stats = summary.groups[i];
+      result = 0;
+    }
+  }
+
+  __scheduler_summary_free(&summary);
+  return result;
+}
+
+int scheduler_groups(Scheduler *sched) {
+  RunSummary summary;
+
+  if (__scheduler_summary(sched, &summary) == -1) {
+    return -1;
+  }
+
+  int groups = 0;
+
+  for (int i = 0; i < summary.size && summary.grouped; i++) {
+    groups += summary.groups[i].count > 0;
+  }
+
+  __scheduler_summary_free(&summary);
+  return groups;
+}
+
+float scheduler_group_avg_turnaround_time(Scheduler *sched, const char *group) {
+  StatsGroup stats;
+
+  if (__scheduler_group_find(sched, group, &stats) == -1) {
+    return -1;
+  }
+
+  return (double) stats.turnaround / (double) stats.count;
+}
+
+float scheduler_group_avg_wait_time(Scheduler *sched, const char *group) {
+  StatsGroup stats;
+
+  if (__scheduler_group_find(sched, group, &stats) == -1) {
+    return -1;
+  }
+
+  return (double) stats.wait / (double) stats.count;
+}
+
+// prints the statistics of every group, in order of first completion
+static void __scheduler_print_groups(RunSummary *summary) {
+  if (!summary->grouped) {
+    return;
+  }
+
+  printf("%-16s %9s %12s %12s\n", "Group", "Processes", "Turn Around", "Wait");
+
+  // completions are at distinct ticks, so a selection by first completion
+  for (int last = INT_MIN;;) {
+    int next = -1;
+
+    for (int i = 0; i < summary->size; i++) {
+      StatsGroup *g = &summary->groups[i];
+
+      if (g->count > 0 && g->first > last && (next == -1 || g->first < summary->groups[next].first)) {
+        next = i;
+      }
+    }
+
+    if (next == -1) {
+      break;
+    }
+
+    StatsGroup *g = &summary->groups[next];
+
+    printf("%-16s %9lld %12.2f %12.2f\n", summary->names[next], g->count,
+        (double) g->turnaround / (double) g->count, (double) g->wait / (double) g->count);
+
+    last = g->first;
+  }
+
+  printf("\n");
+}
+
+// a waiting process in an analytic sweep
+typedef struct sweep_entry {
+  // the waiting process
+  Process *process;
+  // the arrival order, to break ties like a stable sort
+  int seq;
+  // orders the waiting processes
+  Comparator compare;
+} SweepEntry;
+
+// orders sweep entries by the comparator, then arrival order
+static int __sweep_entry_compare(void *a, void *b) {
+  SweepEntry *e1 = (SweepEntry *) a;
+  SweepEntry *e2 = (SweepEntry *) b;
+
+  int result = e1->compare(e1->process, e2->process);
+
+  return result != 0 ? result : e1->seq - e2->seq;
+}
+
+// finds the first process with I/O bursts
+static int __sweep_io_iterator(Queue *queue, int index, void *data, void *arg) {
+  (void) queue;
+  (void) index;
+
+  if (process_io_bursts((Process *) data) > 0) {
+    *(int *) arg = 1;
+    return QUEUE_ITERATE_FINISH;
+  }
+
+  return QUEUE_ITERATE_NEXT;
+}
+
+// dispatches every arrival once, completing the processes without ticks
+static int __scheduler_sweep(Scheduler *sched, Comparator compare) {
+  int size = queue_size(sched->arrivals);
+
+  SweepEntry *entries = malloc((size > 0 ? size : 1) * sizeof(SweepEntry));
+
+  if (entries == NULL) {
+    abort();
+  }
+
+  int io = 0;
+
+  // a process blocked on I/O comes back in the middle of the schedule
+  if (queue_iterate(sched->arrivals, __sweep_io_iterator, &io) || io) {
+    puts("processes with I/O bursts need a run with ticks");
+    free(entries);
+    return -1;
+  }
+
+  // the arrivals are already in order
+  for (int i = 0; i < size; i++) {
+    entries[i].process = queue_pop_front(sched->arrivals);
+    entries[i].seq = i;
+    entries[i].compare = compare;
+  }
+
+  Heap *waiting = new_heap(__sweep_entry_compare);
+
+  int next = 0;
+  int err = 0;
+
+  for (int done = 0; done < size && err == 0; done++) {
+
+    // the cpu idles until the next arrival when nothing is waiting
+    if (heap_is_empty(waiting) && process_arrival_time(entries[next].process) > sched->tick) {
+      sched->tick = process_arrival_time(entries[next].process);
+    }
+
+    // every process arrived by this tick is compared, as the tick engine sorts on each get
+    while (compare != NULL && next < size && process_arrival_time(entries[next].process) <= sched->tick) {
+      if (heap_push(waiting, &entries[next++])) {
+        err = -1;
+      }
+    }
+
+    SweepEntry *e = heap_pop(waiting);
+
+    // otherwise the processes run in arrival order
+    if (e == NULL) {
+      e = &entries[next++];
+    }
+
+    // a process takes at least a tick to find it has no service time
+    int service = process_service_time(e->process);
+
+    // the process runs after the cpu switches to it
+    int overhead = scheduler_dispatch_process(sched, e->process, sched->tick);
+
+    if (overhead == -1
+        || scheduler_complete_process(sched, e->process, sched->tick + overhead + (service > 0 ? service : 1))) {
+      err = -1;
+    }
+  }
+
+  delete_heap(waiting);
+  free(entries);
+
+  return err;
+}
+
+int scheduler_set_quiet(Scheduler *sched, int quiet) {
+  if (sched == NULL) {
+    return -1;
+  }
+
+  if (quiet) {
+    sched->flags |= SCHEDULER_FLAG_QUIET;
+  } else {
+    sched->flags &= ~SCHEDULER_FLAG_QUIET;
+  }
+  return 0;
+}
+
+int scheduler_is_quiet(Scheduler *sched) {
+  return sched != NULL && (sched->flags & SCHEDULER_FLAG_QUIET) != 0;
+}
+
+Process *scheduler_new_process(Scheduler *sched, const char *name) {
+  if (sched == NULL) {
+    return NULL;
+  }
+
+  // the table can grow, moving the columns the running threads read
+  if (pthread_mutex_lock(&sched->lock)) {
+    return NULL;
+  }
+
+  Process *p = process_table_new_process(sched->processes, name);
+
+  if (pthread_mutex_unlock(&sched->lock)) {
+    return NULL;
+  }
+
+  return p;
+}
+
+ProcessTable *scheduler_processes(Scheduler *sched) {
+  return sched == NULL ? NULL : sched->processes;
+}
+
+Process *scheduler_pop_arrival(Scheduler *sched, int tick) {
+  if (sched == NULL) {
+    return NULL;
+  }
+
+  Process *p = queue_peek_front(sched->arrivals);
+
+  if (p == NULL || process_arrival_time(p) > tick) {
+    return NULL;
+  }
+
+  sched->tick = tick;
+
+  return queue_pop_front(sched->arrivals);
+}
+
+Process **scheduler_pop_arrivals(Scheduler *sched, int tick, int *count) {
+  if (sched == NULL || count == NULL) {
+    return NULL;
+  }
+
+  Process *p = NULL;
+
+  *count = 0;
+
+  while ((p = scheduler_pop_arrival(sched, tick)) != NULL) {
+    if (*count == sched->batch_capacity) {
+      Process **batch = realloc(sched->batch, sched->batch_capacity * 2 * sizeof(Process *));
+
+      if (batch == NULL) {
+        abort();
+      }
+
+      sched->batch = batch;
+      sched->batch_capacity *= 2;
+    }
+
+    sched->batch[(*count)++] = p;
+  }
+
+  return sched->batch;
+}
+
+int scheduler_next_arrival(Scheduler *sched) {
+  if (sched == NULL) {
+    return -1;
+  }
+
+  Process *p = queue_peek_front(sched->arrivals);
+
+  return p == NULL ? -1 : process_arrival_time(p);
+}
+
+Process **scheduler_pop_wakeups(Scheduler *sched, int tick, int *count) {
+  if (sched == NULL || count == NULL) {
+    return NULL;
+  }
+
+  *count = 0;
+
+  Process *p = NULL;
+
+  while (sched->blocked_count > 0 && process_ready_time(p = heap_peek(sched->blocked)) <= tick) {
+    heap_pop(sched->blocked);
+    sched->blocked_count--;
+
+    if (*count == sched->batch_capacity) {
+      Process **batch = realloc(sched->batch, sched->batch_capacity * 2 * sizeof(Process *));
+
+      if (batch == NULL) {
+        abort();
+      }
+
+      sched->batch = batch;
+      sched->batch_capacity *= 2;
+    }
+
+    sched->batch[(*count)++] = p;
+
+    // the last process blocked is done with its I/O
+    if (sched->blocked_count == 0) {
+      sched->io_ticks += process_ready_time(p) - sched->io_since;
+    }
+  }
+
+  if (*count > 0) {
+    sched->tick = tick;
+  }
+
+  return sched->batch;
+}
+
+int scheduler_next_wakeup(Scheduler *sched) {
+  if (sched == NULL || sched->blocked_count == 0) {
+    return -1;
+  }
+
+  return process_ready_time(heap_peek(sched->blocked));
+}
+
+int scheduler_next_event(Scheduler *sched) {
+  int arrival = scheduler_next_arrival(sched);
+
+  if (sched == NULL || sched->blocked_count == 0) {
+    return arrival;
+  }
+
+  int wakeup = scheduler_next_wakeup(sched);
+
+  return arrival == -1 || wakeup < arrival ? wakeup : arrival;
+}
+
+// ends the running time slice at a tick, counting the ticks it overlapped I/O
+static void __scheduler_end_slice(Scheduler *sched, int tick) {
+  if (sched->slice_start != -1 && sched->slice_io && tick > sched->slice_start) {
+    sched->overlap += tick - sched->slice_start;
+  }
+
+  sched->slice_start = -1;
+}
+
+int scheduler_block_process(Scheduler *sched, Process *p, int tick) {
+  if (sched == NULL || p == NULL) {
+    return -1;
+  }
+
+  int io = process_block(p);
+
+  if (io == -1) {
+    return -1;
+  }
+
+  // the blocked processes do not change during a time slice, see scheduler_next_event
+  __scheduler_end_slice(sched, tick);
+
+  if (sched->blocked_count == 0) {
+    sched->io_since = tick;
+  }
+
+  sched->tick = tick;
+
+  // ready once the I/O is done, which orders the blocked processes
+  if (process_set_ready_time(p, tick + io) || heap_push(sched->blocked, p)) {
+    return -1;
+  }
+
+  sched->blocked_count++;
+  return io;
+}
+
+long long scheduler_io_ticks(Scheduler *sched) {
+  return sched == NULL ? 0 : sched->io_ticks;
+}
+
+float scheduler_io_overlap(Scheduler *sched) {
+  return sched == NULL || sched->io_ticks == 0 ? 0 : (double) sched->overlap / sched->io_ticks;
+}
+
+int scheduler_dispatch_process(Scheduler *sched, Process *p, int tick) {
+  if (sched == NULL || p == NULL) {
+    return -1;
+  }
+
+  sched->dispatches++;
+
+  __scheduler_end_slice(sched, tick);
+
+  sched->slice_start = tick;
+  sched->slice_io = sched->blocked_count > 0;
+
+  // a process running on after its time slice is not switched to
+  if (sched->running == p) {
+    return 0;
+  }
+
+  int overhead = 0;
+
+  if (sched->running != NULL) {
+    sched->switches++;
+    overhead += sched->cost.ticks;
+  }
+
+  // a process resuming after waiting long enough finds its cache cold
+  if (sched->cost.cold_after > 0 && process_start_time(p) != -1
+      && tick - process_ready_time(p) > sched->cost.cold_after) {
+    overhead += sched->cost.cold_ticks;
+  }
+
+  sched->running = p;
+  sched->overhead += overhead;
+  sched->slice_start += overhead;
+
+  // the process starts running once switched to
+  return process_dispatch(p, tick + overhead) == -1 ? -1 : overhead;
+}
+
+long long scheduler_dispatches(Scheduler *sched) {
+  return sched == NULL ? 0 : sched->dispatches;
+}
+
+long long scheduler_context_switches(Scheduler *sched) {
+  return sched == NULL ? 0 : sched->switches;
+}
+
+int scheduler_set_switch_cost(Scheduler *sched, const SwitchCost *cost) {
+  if (sched == NULL || (cost != NULL && (cost->ticks < 0 || cost->cold_after < 0 || cost->cold_ticks < 0))) {
+    return -1;
+  }
+
+  if (cost == NULL) {
+    memset(&sched->cost, 0, sizeof(SwitchCost));
+  } else {
+    sched->cost = *cost;
+  }
+
+  return 0;
+}
+
+int scheduler_switch_argument(int *argc, char *argv[], SwitchCost *cost) {
+  if (argc == NULL || argv == NULL || cost == NULL) {
+    return -1;
+  }
+
+  memset(cost, 0, sizeof(SwitchCost));
+
+  for (int i = 1; i + 1 < *argc; i++) {
+    if (strcmp(argv[i], "-c") != 0) {
+      continue;
+    }
+
+    char extra;
+    int n = sscanf(argv[i + 1], "%d,%d,%d%c", &cost->ticks, &cost->cold_after, &cost->cold_ticks, &extra);
+
+    if ((n != 1 && n != 3) || cost->ticks < 0 || cost->cold_after < 0 || cost->cold_ticks < 0) {
+      return -1;
+    }
+
+    // shift the rest, keeping the terminating NULL
+    for (int j = i; j + 2 <= *argc; j++) {
+      argv[j] = argv[j + 2];
+    }
+
+    *argc -= 2;
+    return 0;
+  }
+
+  return 0;
+}
+
+long long scheduler_overhead_ticks(Scheduler *sched) {
+  return sched == NULL ? 0 : sched->overhead;
+}
+
+int scheduler_complete_process(Scheduler *sched, Process *p, int tick) {
+  if (sched == NULL || p == NULL) {
+    return -1;
+  }
+
+  sched->tick = tick;
+
+  __scheduler_end_slice(sched, tick);
+
+  if (process_set_completion_time(p, tick) || queue_push_back(sched->completed, p)) {
+    return -1;
+  }
+
+  sched->finished++;
+  return 0;
+}
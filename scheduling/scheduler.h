@@ -1,6 +1,16 @@
 #ifndef RYJEN_OS_SCHEDULER_H
 #define RYJEN_OS_SCHEDULER_H
 
+// the cost of switching the cpu between processes, charged in ticks
+typedef struct switch_cost {
+  // the ticks of each context switch
+  int ticks;
+  // the ticks a process waits before its cache is cold (0 for never)
+  int cold_after;
+  // the ticks added to resume a process with a cold cache
+  int cold_ticks;
+} SwitchCost;
+
 /**
  * Allocates a new scheduler
  * @param Algorithm the algorithm to use
@@ -30,9 +40,32 @@ void delete_scheduler(Scheduler *);
  */
 int scheduler_run(Scheduler *);
 
+/**
+ * Runs the scheduler in a single thread, handing over arrivals and
+ * dispatching processes in one loop with the same output as scheduler_run.
+ * Uses the loop specialized for the algorithm (see scheduler_loop.h) when
+ * it has one, otherwise calls through the algorithm callbacks.
+ * @param Scheduler the scheduler instance
+ * @return 0 on success, -1 on error
+ */
+int scheduler_run_serial(Scheduler *);
+
+/**
+ * Runs a non-premptive schedule analytically, without simulating each tick.
+ * Completion times are prefix sums of service times in dispatch order, found
+ * with a heap of waiting processes gated by arrival time, in O(n log n).
+ * Completes the same processes at the same times as scheduler_run with a
+ * non-premptive algorithm, but only the statistics are output.
+ * @param Scheduler the scheduler instance
+ * @param Comparator orders waiting processes, NULL for arrival order
+ * @return 0 on success, -1 on error
+ */
+int scheduler_run_analytic(Scheduler *, int (*)(void *, void *));
+
 /**
  * Adds a process to the scheduler arrivals.  Is safe to call after scheduler_run()
- * has been started.
+ * has been started, for a process in its own table (see new_process) or
+ * one whose fields were set before the run (see scheduler_new_process).
  * @param Scheduler the scheduler instance
  * @param Process the process instance
  * @return 0 on success, -1 on error
@@ -40,7 +73,19 @@ int scheduler_run(Scheduler *);
 int scheduler_add_process(Scheduler *, Process *);
 
 /**
- * Prompts and reads one or more processes from standard input.
+ * Adds processes to the scheduler arrivals at once, sorting the arrivals
+ * once if needed.  Is safe to call after scheduler_run() has been started,
+ * with the same restriction as scheduler_add_process.
+ * @param Scheduler the scheduler instance
+ * @param Process the process instances
+ * @param int the number of processes
+ * @return 0 on success, -1 on error
+ */
+int scheduler_add_processes(Scheduler *, Process **, int);
+
+/**
+ * Prompts and reads one or more processes from standard input, into the
+ * table of the scheduler, so before it runs (see scheduler_new_process).
  * @param Scheduler the scheduler instance
  * @return 0 on success, -1 on error
  */
@@ -60,5 +105,280 @@ float scheduler_avg_turnaround_time(Scheduler *);
  */
 float scheduler_avg_wait_time(Scheduler *);
 
+/**
+ * Gets the statistics of the completed processes, computed in one pass
+ * @param Scheduler the scheduler instance
+ * @param Stats set to the statistics (see stats.h)
+ * @return 0 on success, -1 on error
+ */
+int scheduler_stats(Scheduler *, Stats *);
+
+/**
+ * Gets the hot path instrumentation of the runs so far: the time in each
+ * algorithm callback, printing, sorting and statistics, the lock wait and
+ * hold times and the condition wakeups of each thread.  The loops
+ * specialized to a policy inline its callbacks, so they are not timed.
+ * @param Scheduler the scheduler instance
+ * @param Profile set to the profile (see profile.h)
+ * @return 0 on success, -1 on error or when not compiled with SCHEDULER_PROFILE
+ */
+int scheduler_profile(Scheduler *, Profile *);
+
+/**
+ * Gets the average response time, from arrival until first run
+ * @param Scheduler the scheduler instance
+ * @return the average response time, -1 on error
+ */
+float scheduler_avg_response_time(Scheduler *);
+
+/**
+ * Gets the number of processes with a deadline
+ * @param Scheduler the scheduler instance
+ * @return the number of processes, -1 on error
+ */
+int scheduler_deadlines(Scheduler *);
+
+/**
+ * Gets the number of processes that completed after their deadline
+ * @param Scheduler the scheduler instance
+ * @return the number of deadline misses, -1 on error
+ */
+int scheduler_deadline_misses(Scheduler *);
+
+/**
+ * Gets the average tardiness (ticks completed past the deadline) of
+ * the processes with a deadline
+ * @param Scheduler the scheduler instance
+ * @return the average tardiness as a floating point
+ */
+float scheduler_avg_tardiness(Scheduler *);
+
+/**
+ * Gets the maximum tardiness of the processes with a deadline
+ * @param Scheduler the scheduler instance
+ * @return the maximum tardiness, -1 on error
+ */
+int scheduler_max_tardiness(Scheduler *);
+
+/**
+ * Gets the ticks the cpu had nothing to run, from tick 0 until the last
+ * process completed
+ * @param Scheduler the scheduler instance
+ * @return the idle ticks, -1 on error
+ */
+long long scheduler_idle_ticks(Scheduler *);
+
+/**
+ * Gets the share of the ticks the cpu was servicing processes, from
+ * tick 0 until the last process completed
+ * @param Scheduler the scheduler instance
+ * @return the utilization from 0 to 1, -1 on error
+ */
+float scheduler_utilization(Scheduler *);
+
+/**
+ * Gets the processes completed per 1000 ticks
+ * @param Scheduler the scheduler instance
+ * @return the throughput as a floating point, -1 on error
+ */
+float scheduler_throughput(Scheduler *);
+
+/**
+ * Gets the number of share groups of the completed processes, processes
+ * without a group are counted in a "default" group
+ * @param Scheduler the scheduler instance
+ * @return the number of groups, 0 if no process had a group, -1 on error
+ */
+int scheduler_groups(Scheduler *);
+
+/**
+ * Gets the average turnaround time of the completed processes in a share group
+ * @param Scheduler the scheduler instance
+ * @param char* the group name
+ * @return the average turnaround time as a floating point, -1 on error
+ */
+float scheduler_group_avg_turnaround_time(Scheduler *, const char *);
+
+/**
+ * Gets the average wait time of the completed processes in a share group
+ * @param Scheduler the scheduler instance
+ * @param char* the group name
+ * @return the average wait time as a floating point, -1 on error
+ */
+float scheduler_group_avg_wait_time(Scheduler *, const char *);
+
+/**
+ * Sets if a run outputs nothing, neither the ticks nor the statistics
+ * @param Scheduler the scheduler instance
+ * @param int 1 for quiet, 0 otherwise
+ * @return 0 on success, -1 on error
+ */
+int scheduler_set_quiet(Scheduler *, int);
+
+/**
+ * Tests if a run outputs nothing
+ * @param Scheduler the scheduler instance
+ * @return 1 if quiet, 0 otherwise
+ */
+int scheduler_is_quiet(Scheduler *);
+
+/**
+ * Allocates a new process in the table of the scheduler, destroyed with
+ * the scheduler rather than with delete_process.  The table grows under
+ * the scheduler lock, but setting the fields of the process (its group
+ * and I/O bursts can grow the table too) is not locked, so processes
+ * added while the scheduler runs must come from a separate table, see
+ * new_process.
+ * @param Scheduler the scheduler instance
+ * @param char* the process name
+ * @return the process instance, NULL on error
+ */
+Process *scheduler_new_process(Scheduler *, const char *);
+
+/**
+ * Gets the table holding the processes of the scheduler
+ * @param Scheduler the scheduler instance
+ * @return the table instance
+ */
+ProcessTable *scheduler_processes(Scheduler *);
+
+/**
+ * Removes the next arrival if it has arrived, for a scheduler loop
+ * @param Scheduler the scheduler instance
+ * @param int the current tick
+ * @return the process, NULL if none has arrived
+ */
+Process *scheduler_pop_arrival(Scheduler *, int);
+
+/**
+ * Removes every arrival that has arrived, for a scheduler loop
+ * NOTE: the array is reused by the next call
+ * @param Scheduler the scheduler instance
+ * @param int the current tick
+ * @param int* set to the number of arrivals
+ * @return the arrivals in arrival order, NULL on error
+ */
+Process **scheduler_pop_arrivals(Scheduler *, int, int *);
+
+/**
+ * Gets the arrival time of the next arrival, for a scheduler loop
+ * @param Scheduler the scheduler instance
+ * @return the arrival time, -1 if there are no more arrivals
+ */
+int scheduler_next_arrival(Scheduler *);
+
+/**
+ * Removes every process done with its I/O, for a scheduler loop to hand
+ * back to the algorithm through arrive
+ * NOTE: the array is the one of scheduler_pop_arrivals
+ * @param Scheduler the scheduler instance
+ * @param int the current tick
+ * @param int* set to the number of processes
+ * @return the processes in wakeup order, NULL on error
+ */
+Process **scheduler_pop_wakeups(Scheduler *, int, int *);
+
+/**
+ * Gets the tick the next process blocked on I/O wakes, for a scheduler loop
+ * @param Scheduler the scheduler instance
+ * @return the wakeup tick, -1 if no process is blocked
+ */
+int scheduler_next_wakeup(Scheduler *);
+
+/**
+ * Gets the tick of the next arrival or wakeup, for a scheduler loop to
+ * end time slices at, so the processes blocked do not change during one
+ * @param Scheduler the scheduler instance
+ * @return the tick, -1 if there are no more arrivals or blocked processes
+ */
+int scheduler_next_event(Scheduler *);
+
+/**
+ * Blocks a process at the end of a cpu burst until its I/O is done, for
+ * a scheduler loop (see process_io_due)
+ * @param Scheduler the scheduler instance
+ * @param Process the process with I/O due
+ * @param int the tick the cpu burst ended
+ * @return the ticks blocked, -1 on error
+ */
+int scheduler_block_process(Scheduler *, Process *, int);
+
+/**
+ * Completes a process, for a scheduler loop
+ * @param Scheduler the scheduler instance
+ * @param Process the process with no service time left
+ * @param int the tick the process completed
+ * @return 0 on success, -1 on error
+ */
+int scheduler_complete_process(Scheduler *, Process *, int);
+
+/**
+ * Gives a process a time slice, for a scheduler loop.  Counts the time
+ * slice, and when the last one was given to another process, a context
+ * switch and a dispatch of the process (see process_dispatch).  The loop
+ * charges the switching cost to the cpu before the process runs.
+ * @param Scheduler the scheduler instance
+ * @param Process the process instance
+ * @param int the tick of the time slice
+ * @return the ticks of switching overhead, -1 on error
+ */
+int scheduler_dispatch_process(Scheduler *, Process *, int);
+
+/**
+ * Gets the number of time slices given to processes
+ * @param Scheduler the scheduler instance
+ * @return the number of time slices
+ */
+long long scheduler_dispatches(Scheduler *);
+
+/**
+ * Gets the number of time slices given to another process than the last
+ * @param Scheduler the scheduler instance
+ * @return the number of context switches
+ */
+long long scheduler_context_switches(Scheduler *);
+
+/**
+ * Sets the cost of switching the cpu between processes, so a context
+ * switch takes ticks from the processes.  Resuming a process that waited
+ * longer than a threshold since its last time slice adds a cache cold
+ * penalty.  A run is free of overhead by default.
+ * @param Scheduler the scheduler instance
+ * @param SwitchCost the cost (NULL for none)
+ * @return 0 on success, -1 on error
+ */
+int scheduler_set_switch_cost(Scheduler *, const SwitchCost *);
+
+/**
+ * Removes the switching cost argument, "-c ticks[,cold_after,cold_ticks]",
+ * from the arguments of a program
+ * @param int* the number of arguments, decreased by the arguments removed
+ * @param char** the arguments
+ * @param SwitchCost set to the cost, or no cost without the argument
+ * @return 0 on success, -1 if the argument is invalid
+ */
+int scheduler_switch_argument(int *, char *[], SwitchCost *);
+
+/**
+ * Gets the ticks the cpu spent switching between processes
+ * @param Scheduler the scheduler instance
+ * @return the overhead ticks
+ */
+long long scheduler_overhead_ticks(Scheduler *);
+
+/**
+ * Gets the ticks at least one process was blocked on I/O
+ * @param Scheduler the scheduler instance
+ * @return the I/O ticks
+ */
+long long scheduler_io_ticks(Scheduler *);
+
+/**
+ * Gets the share of the I/O ticks a process ran on the cpu at the same time
+ * @param Scheduler the scheduler instance
+ * @return the overlap between 0 and 1, 0 without I/O
+ */
+float scheduler_io_overlap(Scheduler *);
+
 #endif
 
@@ -0,0 +1,191 @@
+#ifndef RYJEN_OS_SCHEDULER_LOOP_H
+#define RYJEN_OS_SCHEDULER_LOOP_H
+
+#include <stdio.h>
+
+#include "queue.h"
+#include "process.h"
+
+/**
+ * Defines a single threaded scheduler loop for a policy, calling its
+ * callbacks directly instead of through an algorithm so the compiler can
+ * inline them.  Define it after the callbacks in the policy source and set
+ * it with algorithm_set_loop, scheduler_run_serial will then use it:
+ *
+ *   SCHEDULER_LOOP(__rr_loop, __rr_arrive, __rr_ready, __rr_get, __rr_put, __rr_slice)
+ *
+ * The callbacks have the signatures of the algorithm callbacks, and are
+ * passed the data argument of the algorithm.  The output is the same as
+ * the producer and consumer of scheduler_run.  The arrivals of a tick are
+ * handed to arrive one at a time, see SCHEDULER_LOOP_BATCH otherwise.
+ * @param name the function to define, int name(Scheduler *, void *)
+ * @param arrive the OnProcessArrive callback
+ * @param ready the OnProcessReady callback
+ * @param get the OnProcessGet callback
+ * @param put the OnProcessPut callback
+ * @param slice the OnProcessSlice callback (scheduler_loop_tick for none)
+ */
+#define SCHEDULER_LOOP(name, arrive, ready, get, put, slice)                  \
+static inline int name##_arrive_batch(Process **batch, int n, void *arg) {    \
+  for (int i = 0; i < n; i++) {                                               \
+    if (arrive(batch[i], arg)) {                                              \
+      return -1;                                                              \
+    }                                                                         \
+  }                                                                           \
+  return 0;                                                                   \
+}                                                                             \
+                                                                              \
+SCHEDULER_LOOP_BATCH(name, name##_arrive_batch, ready, get, put, slice)
+
+/**
+ * Defines a single threaded scheduler loop for a policy, like
+ * SCHEDULER_LOOP, handing the arrivals of a tick to the policy at once
+ * @param name the function to define, int name(Scheduler *, void *)
+ * @param arrive_batch the OnProcessArriveBatch callback
+ * @param ready the OnProcessReady callback
+ * @param get the OnProcessGet callback
+ * @param put the OnProcessPut callback
+ * @param slice the OnProcessSlice callback (scheduler_loop_tick for none)
+ */
+#define SCHEDULER_LOOP_BATCH(name, arrive_batch, ready, get, put, slice)      \
+static inline int name##_deliver(Scheduler *sched, int tick, int quiet,       \
+    void *arg) {                                                              \
+  int n = 0;                                                                  \
+                                                                              \
+  /* hand over every arrival due */                                           \
+  Process **batch = scheduler_pop_arrivals(sched, tick, &n);                  \
+                                                                              \
+  for (int i = 0; i < n && !quiet; i++) {                                     \
+    printf("Time %02d : Process %s Arrival %02d\n", tick,                     \
+        process_name(batch[i]), process_arrival_time(batch[i]));              \
+  }                                                                           \
+                                                                              \
+  if (n > 0 && arrive_batch(batch, n, arg)) {                                 \
+    return -1;                                                                \
+  }                                                                           \
+                                                                              \
+  /* then every process done with its I/O, back through arrive */             \
+  batch = scheduler_pop_wakeups(sched, tick, &n);                             \
+                                                                              \
+  for (int i = 0; i < n && !quiet; i++) {                                     \
+    printf("Time %02d : Process %s Wakeup %02d\n", tick,                      \
+        process_name(batch[i]), process_current_service_time(batch[i]));      \
+  }                                                                           \
+                                                                              \
+  return n > 0 && arrive_batch(batch, n, arg) ? -1 : 0;                       \
+}                                                                             \
+                                                                              \
+static int name(Scheduler *sched, void *arg) {                                \
+  int quiet = scheduler_is_quiet(sched);                                      \
+  int tick = 0;                                                               \
+                                                                              \
+  for (;;) {                                                                  \
+    if (name##_deliver(sched, tick, quiet, arg)) {                            \
+      return -1;                                                              \
+    }                                                                         \
+                                                                              \
+    int next = scheduler_next_event(sched);                                   \
+                                                                              \
+    if (!ready(arg)) {                                                        \
+      /* done, or idle until the next arrival or wakeup */                    \
+      if (next == -1) {                                                       \
+        return 0;                                                             \
+      }                                                                       \
+      tick = next;                                                            \
+      continue;                                                               \
+    }                                                                         \
+                                                                              \
+    Process *p = get(arg);                                                    \
+                                                                              \
+    /* nothing given this time, so ask again like the consumer */             \
+    if (p == NULL) {                                                          \
+      continue;                                                               \
+    }                                                                         \
+                                                                              \
+    /* count the time slice and the first time the process runs */          \
+    int overhead = scheduler_dispatch_process(sched, p, tick);                \
+                                                                              \
+    if (overhead == -1) {                                                     \
+      return -1;                                                              \
+    }                                                                         \
+                                                                              \
+    /* the cpu switches to the process before it runs */                      \
+    for (; overhead > 0; overhead--) {                                        \
+      if (!quiet) {                                                           \
+        printf("Time %02d : Process %s Switch %02d\n", tick,                  \
+            process_name(p), overhead);                                       \
+      }                                                                       \
+      tick++;                                                                 \
+                                                                              \
+      /* the arrivals and wakeups of each tick are handed over meanwhile */   \
+      if (name##_deliver(sched, tick, quiet, arg)) {                          \
+        return -1;                                                            \
+      }                                                                       \
+      next = scheduler_next_event(sched);                                     \
+    }                                                                         \
+                                                                              \
+    /* the time slice ends at the next event so the policy can prempt */      \
+    int ticks = slice(p, arg);                                                \
+                                                                              \
+    if (next != -1 && next - tick < ticks) {                                  \
+      ticks = next - tick;                                                    \
+    }                                                                         \
+                                                                              \
+    /* and when the cpu burst ends, so the process can block for I/O */       \
+    int burst = process_current_burst_time(p);                                \
+                                                                              \
+    if (burst > 0 && burst < ticks) {                                         \
+      ticks = burst;                                                          \
+    }                                                                         \
+                                                                              \
+    int current = 0;                                                          \
+                                                                              \
+    do {                                                                      \
+      if (!quiet) {                                                           \
+        printf("Time %02d : Process %s Service %02d\n", tick,                 \
+            process_name(p), process_current_service_time(p));                \
+      }                                                                       \
+      tick++;                                                                 \
+      current = process_run(p);                                               \
+    } while (--ticks > 0 && current > 0);                                     \
+                                                                              \
+    if (current == 0) {                                                       \
+      if (scheduler_complete_process(sched, p, tick)) {                       \
+        return -1;                                                            \
+      }                                                                       \
+    } else if (current > 0 && process_io_due(p)) {                            \
+      /* the cpu burst ended, so the process blocks until its I/O is done */  \
+      int io = scheduler_block_process(sched, p, tick);                       \
+                                                                              \
+      if (io == -1) {                                                         \
+        return -1;                                                            \
+      }                                                                       \
+      if (!quiet) {                                                           \
+        printf("Time %02d : Process %s Blocked %02d\n", tick,                 \
+            process_name(p), io);                                             \
+      }                                                                       \
+    } else if (current == PROCESS_ERROR || process_set_ready_time(p, tick)    \
+        || put(p, arg)) {                                                     \
+      return -1;                                                              \
+    }                                                                         \
+  }                                                                           \
+}
+
+// a time slice of one tick, for policies without a slice callback
+static inline int scheduler_loop_tick(Process *p, void *arg) {
+  (void) p;
+  (void) arg;
+  return 1;
+}
+
+// the arrive callback of new_queue_algorithm, for queue policies
+static inline int scheduler_loop_queue_arrive(Process *p, void *arg) {
+  return p == NULL || arg == NULL ? -1 : queue_push_back((Queue *) arg, p);
+}
+
+// the ready callback of new_queue_algorithm, for queue policies
+static inline int scheduler_loop_queue_ready(void *arg) {
+  return arg == NULL ? -1 : !queue_is_empty((Queue *) arg);
+}
+
+#endif
@@ -1,10 +1,15 @@
 #include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
 
 #include "types.h"
 #include "scheduler.h"
 #include "process.h"
 #include "queue.h"
 #include "algorithm.h"
+#include "policy.h"
+#include "loader.h"
+#include "scheduler_loop.h"
 
 static Process * __spn_get(void *arg) {
   if (arg == NULL) {
@@ -13,13 +18,13 @@ static Process * __spn_get(void *arg) {
 
   Queue *list = (Queue*) arg;
 
-  // keep the current process
-  Process *p = queue_pop_front(list);
-
-  // sort the rest for next time
-  queue_sort(list, process_compare_current_service_times);
+  // non-premptive, so a process put back mid burst keeps running, otherwise
+  // the shortest runs, including the arrivals since the last get
+  if (process_current_tick(queue_peek_front(list)) == 0) {
+    queue_sort(list, process_compare_current_service_times);
+  }
 
-  return p;
+  return queue_pop_front(list);
 }
 
 static int __spn_put(Process *p, void *arg) {
@@ -33,30 +38,76 @@ static int __spn_put(Process *p, void *arg) {
   return queue_push_front(q, p);
 }
 
-int main() {
+// non-premptive so run until complete, or an arrival
+static int __spn_slice(Process *p, void *arg) {
+  (void) arg;
+
+  return process_current_service_time(p);
+}
+
+SCHEDULER_LOOP(__spn_loop, scheduler_loop_queue_arrive, scheduler_loop_queue_ready, __spn_get, __spn_put, __spn_slice)
+
+// destroys the queue with the algorithm
+static void __spn_delete(void *arg) {
+  delete_queue((Queue *) arg);
+}
 
-  // data is a simple queue
+Algorithm *new_spn_algorithm() {
   Queue *queue = new_queue();
 
-  // create the algorithm
   Algorithm *algo = new_queue_algorithm(queue, __spn_get, __spn_put);
 
+  algorithm_set_on_delete(algo, __spn_delete);
+
+  algorithm_set_on_slice(algo, __spn_slice);
+
+  algorithm_set_loop(algo, __spn_loop);
+
+  return algo;
+}
+
+#ifndef POLICY_LIBRARY
+
+int main(int argc, char *argv[]) {
+
+  // the workload file and switch cost, taken out of the arguments
+  LoaderOptions options;
+
+  if (loader_options(&argc, argv, &options)) {
+    puts("invalid argument");
+    return 1;
+  }
+
+  // compute the schedule without simulating ticks
+  int analytic = 0;
+
+  if (argc > 1) {
+    if (strcmp(argv[1], "-a") != 0) {
+      puts("invalid argument");
+      return 1;
+    }
+    analytic = 1;
+  }
+
+  // create the algorithm
+  Algorithm *algo = new_spn_algorithm();
+
   // create the scheduler
   Scheduler *sched = new_scheduler(algo);
 
-  // read the processes
-  scheduler_read_processes(sched);
+  // set the switch cost and read the processes
+  if (loader_setup(sched, &options)) {
+    delete_scheduler(sched);
+    return 1;
+  }
 
   // run
-  int result = scheduler_run(sched);
+  int result = analytic ? scheduler_run_analytic(sched, process_compare_current_service_times) : scheduler_run(sched);
 
   // cleanup
   delete_scheduler(sched);
 
-  delete_queue(queue);
-
   return result;
 }
 
-
-
+#endif
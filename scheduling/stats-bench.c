@@ -0,0 +1,115 @@
+#define _POSIX_C_SOURCE 200809L
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include "types.h"
+#include "process.h"
+#include "stats.h"
+
+// the default number of completed processes
+#define BENCH_PROCESSES 10000000
+
+// the number of groups in the workload
+#define BENCH_GROUPS 8
+
+// runs of each kernel, the fastest is reported
+#define BENCH_REPEATS 5
+
+static const char *__bench_kernels[] = { "scalar", "sse4.1", "avx2" };
+
+static double __bench_now() {
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+
+  return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+int main(int argc, char *argv[]) {
+
+  int processes = BENCH_PROCESSES;
+
+  if (argc > 1) {
+    processes = atoi(argv[1]);
+
+    if (processes < 1) {
+      puts("invalid argument");
+      return 1;
+    }
+  }
+
+  int *ints = malloc((size_t) processes * 6 * sizeof(int));
+
+  if (ints == NULL) {
+    abort();
+  }
+
+  int *arrival = ints;
+  int *service = ints + processes;
+  int *start = ints + processes * 2;
+  int *completion = ints + processes * 3;
+  int *deadline = ints + processes * 4;
+  int *group = ints + processes * 5;
+
+  srand(1);
+
+  for (int i = 0, tick = 0; i < processes; i++) {
+    arrival[i] = i;
+    service[i] = 1 + rand() % 4;
+    start[i] = tick > i ? tick : i;
+    tick = start[i] + service[i];
+    completion[i] = tick;
+    deadline[i] = rand() % 4 == 0 ? 1 + rand() % 100 : 0;
+    group[i] = rand() % (BENCH_GROUPS + 1) - 1;
+  }
+
+  ProcessColumns columns = { arrival, service, start, completion, deadline, group, NULL, NULL, NULL, NULL, NULL, NULL, processes };
+
+  // the bytes a pass reads
+  double bytes = (double) processes * 6 * sizeof(int);
+
+  printf("%-8s %12s %10s %10s\n", "Kernel", "Processes", "ms", "GB/s");
+
+  long long turnaround = -1;
+
+  for (size_t i = 0; i < sizeof(__bench_kernels) / sizeof(__bench_kernels[0]); i++) {
+    if (stats_set_kernel(__bench_kernels[i])) {
+      printf("%-8s %12s\n", __bench_kernels[i], "unsupported");
+      continue;
+    }
+
+    double best = -1;
+
+    for (int j = 0; j < BENCH_REPEATS; j++) {
+      Stats stats;
+      StatsGroup groups[BENCH_GROUPS + 1];
+
+      stats_init(&stats);
+      stats_group_init(groups, BENCH_GROUPS + 1);
+
+      double begin = __bench_now();
+
+      stats_accumulate(&stats, groups, BENCH_GROUPS + 1, &columns);
+
+      double seconds = __bench_now() - begin;
+
+      if (best < 0 || seconds < best) {
+        best = seconds;
+      }
+
+      // every kernel must agree
+      if (turnaround != -1 && stats.turnaround != turnaround) {
+        printf("%s : the kernels disagree\n", __bench_kernels[i]);
+        return 1;
+      }
+      turnaround = stats.turnaround;
+    }
+
+    printf("%-8s %12d %10.2f %10.2f\n", __bench_kernels[i], processes, best * 1e3, bytes / best / 1e9);
+  }
+
+  free(ints);
+  return 0;
+}
@@ -0,0 +1,171 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "types.h"
+#include "process.h"
+#include "stats.h"
+
+// the number of groups in the workload, and one past them to test the groups ignored
+#define TEST_GROUPS 5
+
+// the most processes of a test
+#define TEST_PROCESSES 1031
+
+// sizes around each vector width, so every kernel runs with each tail length
+static const int __test_sizes[] = { 0, 1, 2, 3, 4, 5, 7, 8, 9, 11, 15, 16, 17, 23, 31, 33, 63, 100, 257, 1000,
+    TEST_PROCESSES };
+
+static const char *__test_kernels[] = { "sse4.1", "avx2" };
+
+// the columns of every test, filled once
+static int __test_ints[10][TEST_PROCESSES];
+
+static void __test_fill() {
+  int *arrival = __test_ints[0];
+  int *service = __test_ints[1];
+  int *start = __test_ints[2];
+  int *completion = __test_ints[3];
+  int *deadline = __test_ints[4];
+  int *group = __test_ints[5];
+  int *dispatches = __test_ints[6];
+  int *preemptions = __test_ints[7];
+  int *longest_wait = __test_ints[8];
+  int *io = __test_ints[9];
+
+  srand(1);
+
+  for (int i = 0, tick = 0; i < TEST_PROCESSES; i++) {
+    arrival[i] = i * 2 + rand() % 3;
+    service[i] = 1 + rand() % 20;
+    io[i] = rand() % 3 == 0 ? rand() % 10 : 0;
+    start[i] = (tick > arrival[i] ? tick : arrival[i]) + rand() % 5;
+    tick = start[i] + service[i] + io[i] + rand() % 50;
+    completion[i] = tick;
+    deadline[i] = rand() % 3 == 0 ? 1 + rand() % 200 : 0;
+    group[i] = rand() % (TEST_GROUPS + 2) - 1;
+    dispatches[i] = 1 + rand() % 8;
+    preemptions[i] = dispatches[i] - 1;
+    longest_wait[i] = rand() % 1000;
+  }
+}
+
+// the columns of the processes from an index, with or without the optional columns
+static ProcessColumns __test_columns(int from, int size, int optional) {
+  ProcessColumns c;
+
+  memset(&c, 0, sizeof(ProcessColumns));
+
+  c.arrival = __test_ints[0] + from;
+  c.service = __test_ints[1] + from;
+  c.start = __test_ints[2] + from;
+  c.completion = __test_ints[3] + from;
+  c.deadline = __test_ints[4] + from;
+  c.group = __test_ints[5] + from;
+  c.size = size;
+
+  if (optional) {
+    c.dispatches = __test_ints[6] + from;
+    c.preemptions = __test_ints[7] + from;
+    c.longest_wait = __test_ints[8] + from;
+    c.io = __test_ints[9] + from;
+  }
+
+  return c;
+}
+
+static int __test_accumulate(const char *kernel, const ProcessColumns *c, Stats *stats, StatsGroup *groups) {
+  stats_init(stats);
+  stats_group_init(groups, TEST_GROUPS);
+
+  return stats_set_kernel(kernel) || stats_accumulate(stats, groups, TEST_GROUPS, c);
+}
+
+// prints the first field that differs
+#define TEST_FIELD(expected, actual, field) \
+  if ((expected)->field != (actual)->field) { \
+    printf(" (%s %lld != %lld)", #field, (long long) (actual)->field, (long long) (expected)->field); \
+    return 1; \
+  }
+
+// compares every field of the statistics, 0 if they are the same
+static int __test_compare(const Stats *expected, const Stats *actual, const StatsGroup *expected_groups,
+    const StatsGroup *actual_groups) {
+  TEST_FIELD(expected, actual, count);
+  TEST_FIELD(expected, actual, turnaround);
+  TEST_FIELD(expected, actual, wait);
+  TEST_FIELD(expected, actual, response);
+  TEST_FIELD(expected, actual, min_turnaround);
+  TEST_FIELD(expected, actual, max_turnaround);
+  TEST_FIELD(expected, actual, min_wait);
+  TEST_FIELD(expected, actual, max_wait);
+  TEST_FIELD(expected, actual, min_response);
+  TEST_FIELD(expected, actual, max_response);
+  TEST_FIELD(expected, actual, deadlines);
+  TEST_FIELD(expected, actual, misses);
+  TEST_FIELD(expected, actual, tardiness);
+  TEST_FIELD(expected, actual, max_tardiness);
+  TEST_FIELD(expected, actual, service);
+  TEST_FIELD(expected, actual, last_completion);
+  TEST_FIELD(expected, actual, dispatches);
+  TEST_FIELD(expected, actual, preemptions);
+  TEST_FIELD(expected, actual, longest_wait);
+  TEST_FIELD(expected, actual, max_longest_wait);
+
+  for (int i = 0; i < STATS_BUCKETS; i++) {
+    TEST_FIELD(expected, actual, histogram[i]);
+  }
+
+  for (int i = 0; i < TEST_GROUPS; i++) {
+    TEST_FIELD(expected_groups, actual_groups, count);
+    TEST_FIELD(expected_groups, actual_groups, turnaround);
+    TEST_FIELD(expected_groups, actual_groups, wait);
+    TEST_FIELD(expected_groups, actual_groups, response);
+    TEST_FIELD(expected_groups, actual_groups, first);
+
+    expected_groups++;
+    actual_groups++;
+  }
+
+  return 0;
+}
+
+int main() {
+
+  int status = 0;
+
+  __test_fill();
+
+  for (size_t i = 0; i < sizeof(__test_kernels) / sizeof(__test_kernels[0]); i++) {
+    if (stats_set_kernel(__test_kernels[i])) {
+      printf("Testing stats %s unsupported\n", __test_kernels[i]);
+      continue;
+    }
+
+    for (size_t j = 0; j < sizeof(__test_sizes) / sizeof(__test_sizes[0]); j++) {
+      for (int optional = 0; optional <= 1; optional++) {
+        // starts off the alignment of the vectors, as the columns of a table with completed processes removed
+        int size = __test_sizes[j];
+        int from = size < TEST_PROCESSES ? (int) j % 7 : 0;
+
+        ProcessColumns c = __test_columns(from, size, optional);
+
+        Stats expected, actual;
+        StatsGroup expected_groups[TEST_GROUPS], actual_groups[TEST_GROUPS];
+
+        printf("Testing stats %s size %d %s", __test_kernels[i], size, optional ? "all columns" : "required columns");
+
+        if (__test_accumulate("scalar", &c, &expected, expected_groups)
+            || __test_accumulate(__test_kernels[i], &c, &actual, actual_groups)
+            || __test_compare(&expected, &actual, expected_groups, actual_groups)) {
+          printf(" \033[1;31mFAILED\033[0m\n");
+          status = 1;
+        } else {
+          printf(" \033[1;32mPASS\033[0m\n");
+        }
+      }
+    }
+  }
+
+  return status;
+}
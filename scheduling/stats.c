@@ -0,0 +1,503 @@
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+
+#include "types.h"
+#include "process.h"
+#include "stats.h"
+
+#if defined(__GNUC__) && defined(__x86_64__)
+#include <immintrin.h>
+#define STATS_X86
+#endif
+
+// accumulates the processes from an index up to another
+typedef void (*StatsKernel)(Stats *, StatsGroup *, int, const ProcessColumns *, int, int);
+
+void stats_init(Stats *stats) {
+  memset(stats, 0, sizeof(Stats));
+
+  stats->min_turnaround = INT_MAX;
+  stats->max_turnaround = INT_MIN;
+  stats->min_wait = INT_MAX;
+  stats->max_wait = INT_MIN;
+  stats->min_response = INT_MAX;
+  stats->max_response = INT_MIN;
+  stats->last_completion = INT_MIN;
+}
+
+void stats_group_init(StatsGroup *groups, int count) {
+  for (int i = 0; i < count; i++) {
+    groups[i].count = 0;
+    groups[i].turnaround = 0;
+    groups[i].wait = 0;
+    groups[i].response = 0;
+    groups[i].first = INT_MAX;
+  }
+}
+
+// keeps the least value
+static inline void __stats_least(int *least, int value) {
+  if (value < *least) {
+    *least = value;
+  }
+}
+
+// keeps the most value
+static inline void __stats_most(int *most, int value) {
+  if (value > *most) {
+    *most = value;
+  }
+}
+
+// the histogram bucket of a turnaround time
+static inline int __stats_bucket(int turnaround) {
+  return turnaround <= 0 ? 0 : 32 - __builtin_clz((unsigned int) turnaround);
+}
+
+// the work that does not vectorize, the histogram and the group scatter
+static inline void __stats_lane(Stats *stats, StatsGroup *groups, int count, int group, int turnaround,
+    int wait, int response, int completion) {
+  stats->histogram[__stats_bucket(turnaround)]++;
+
+  // the first group is the processes without one
+  if (groups != NULL && group >= -1 && group < count - 1) {
+    StatsGroup *g = &groups[group + 1];
+
+    g->count++;
+    g->turnaround += turnaround;
+    g->wait += wait;
+    g->response += response;
+
+    __stats_least(&g->first, completion);
+  }
+}
+
+static void __stats_scalar(Stats *stats, StatsGroup *groups, int count, const ProcessColumns *c, int from, int to) {
+  for (int i = from; i < to; i++) {
+    int turnaround = c->completion[i] - c->arrival[i];
+    int wait = turnaround - c->service[i] - (c->io == NULL ? 0 : c->io[i]);
+    int response = c->start[i] - c->arrival[i];
+
+    stats->turnaround += turnaround;
+    stats->wait += wait;
+    stats->response += response;
+
+    __stats_least(&stats->min_turnaround, turnaround);
+    __stats_most(&stats->max_turnaround, turnaround);
+    __stats_least(&stats->min_wait, wait);
+    __stats_most(&stats->max_wait, wait);
+    __stats_least(&stats->min_response, response);
+    __stats_most(&stats->max_response, response);
+
+    if (c->deadline[i] != 0) {
+      int tardiness = turnaround - c->deadline[i];
+
+      stats->deadlines++;
+
+      if (tardiness > 0) {
+        stats->misses++;
+        stats->tardiness += tardiness;
+
+        __stats_most(&stats->max_tardiness, tardiness);
+      }
+    }
+
+    stats->service += c->service[i];
+    __stats_most(&stats->last_completion, c->completion[i]);
+
+    if (c->dispatches != NULL) {
+      stats->dispatches += c->dispatches[i];
+      stats->preemptions += c->preemptions[i];
+      stats->longest_wait += c->longest_wait[i];
+      __stats_most(&stats->max_longest_wait, c->longest_wait[i]);
+    }
+
+    __stats_lane(stats, groups, count, c->group[i], turnaround, wait, response, c->completion[i]);
+  }
+
+  stats->count += to - from;
+}
+
+#ifdef STATS_X86
+
+// the sum of the lanes of 64 bit integers
+__attribute__((target("avx2")))
+static long long __stats_avx2_sum(__m256i v) {
+  __m128i sum = _mm_add_epi64(_mm256_castsi256_si128(v), _mm256_extracti128_si256(v, 1));
+
+  return _mm_cvtsi128_si64(sum) + _mm_extract_epi64(sum, 1);
+}
+
+// the least of the lanes of 32 bit integers
+__attribute__((target("avx2")))
+static int __stats_avx2_min(__m256i v) {
+  __m128i m = _mm_min_epi32(_mm256_castsi256_si128(v), _mm256_extracti128_si256(v, 1));
+
+  m = _mm_min_epi32(m, _mm_shuffle_epi32(m, _MM_SHUFFLE(1, 0, 3, 2)));
+  m = _mm_min_epi32(m, _mm_shuffle_epi32(m, _MM_SHUFFLE(2, 3, 0, 1)));
+  return _mm_cvtsi128_si32(m);
+}
+
+// the most of the lanes of 32 bit integers
+__attribute__((target("avx2")))
+static int __stats_avx2_max(__m256i v) {
+  __m128i m = _mm_max_epi32(_mm256_castsi256_si128(v), _mm256_extracti128_si256(v, 1));
+
+  m = _mm_max_epi32(m, _mm_shuffle_epi32(m, _MM_SHUFFLE(1, 0, 3, 2)));
+  m = _mm_max_epi32(m, _mm_shuffle_epi32(m, _MM_SHUFFLE(2, 3, 0, 1)));
+  return _mm_cvtsi128_si32(m);
+}
+
+// widens 8 lanes of 32 bit integers and adds them to 4 lanes of 64 bits
+__attribute__((target("avx2")))
+static inline __m256i __stats_avx2_widen_add(__m256i sum, __m256i v) {
+  sum = _mm256_add_epi64(sum, _mm256_cvtepi32_epi64(_mm256_castsi256_si128(v)));
+  return _mm256_add_epi64(sum, _mm256_cvtepi32_epi64(_mm256_extracti128_si256(v, 1)));
+}
+
+__attribute__((target("avx2")))
+static void __stats_avx2(Stats *stats, StatsGroup *groups, int count, const ProcessColumns *c, int from, int to) {
+  __m256i turnaround_sum = _mm256_setzero_si256();
+  __m256i wait_sum = _mm256_setzero_si256();
+  __m256i response_sum = _mm256_setzero_si256();
+  __m256i tardiness_sum = _mm256_setzero_si256();
+  __m256i service_sum = _mm256_setzero_si256();
+  __m256i dispatches_sum = _mm256_setzero_si256();
+  __m256i preemptions_sum = _mm256_setzero_si256();
+  __m256i longest_wait_sum = _mm256_setzero_si256();
+
+  __m256i min_turnaround = _mm256_set1_epi32(INT_MAX);
+  __m256i max_turnaround = _mm256_set1_epi32(INT_MIN);
+  __m256i min_wait = _mm256_set1_epi32(INT_MAX);
+  __m256i max_wait = _mm256_set1_epi32(INT_MIN);
+  __m256i min_response = _mm256_set1_epi32(INT_MAX);
+  __m256i max_response = _mm256_set1_epi32(INT_MIN);
+  __m256i max_tardiness = _mm256_setzero_si256();
+  __m256i last_completion = _mm256_set1_epi32(INT_MIN);
+  __m256i max_longest_wait = _mm256_setzero_si256();
+
+  __m256i zero = _mm256_setzero_si256();
+
+  long long deadlines = 0;
+  long long misses = 0;
+
+  int i = from;
+
+  for (; i + 8 <= to; i += 8) {
+    __m256i arrival = _mm256_loadu_si256((const __m256i *) (c->arrival + i));
+    __m256i completion = _mm256_loadu_si256((const __m256i *) (c->completion + i));
+    __m256i service = _mm256_loadu_si256((const __m256i *) (c->service + i));
+    __m256i start = _mm256_loadu_si256((const __m256i *) (c->start + i));
+    __m256i deadline = _mm256_loadu_si256((const __m256i *) (c->deadline + i));
+
+    __m256i turnaround = _mm256_sub_epi32(completion, arrival);
+    __m256i io = c->io == NULL ? _mm256_setzero_si256() : _mm256_loadu_si256((const __m256i *) (c->io + i));
+    __m256i wait = _mm256_sub_epi32(_mm256_sub_epi32(turnaround, service), io);
+    __m256i response = _mm256_sub_epi32(start, arrival);
+
+    turnaround_sum = __stats_avx2_widen_add(turnaround_sum, turnaround);
+    wait_sum = __stats_avx2_widen_add(wait_sum, wait);
+    response_sum = __stats_avx2_widen_add(response_sum, response);
+
+    min_turnaround = _mm256_min_epi32(min_turnaround, turnaround);
+    max_turnaround = _mm256_max_epi32(max_turnaround, turnaround);
+    min_wait = _mm256_min_epi32(min_wait, wait);
+    max_wait = _mm256_max_epi32(max_wait, wait);
+    min_response = _mm256_min_epi32(min_response, response);
+    max_response = _mm256_max_epi32(max_response, response);
+
+    // the lanes with a deadline, and of those the lanes that missed it
+    __m256i due = _mm256_xor_si256(_mm256_cmpeq_epi32(deadline, zero), _mm256_set1_epi32(-1));
+    __m256i tardiness = _mm256_sub_epi32(turnaround, deadline);
+    __m256i missed = _mm256_and_si256(due, _mm256_cmpgt_epi32(tardiness, zero));
+
+    tardiness = _mm256_and_si256(tardiness, missed);
+
+    deadlines += __builtin_popcount(_mm256_movemask_ps(_mm256_castsi256_ps(due)));
+    misses += __builtin_popcount(_mm256_movemask_ps(_mm256_castsi256_ps(missed)));
+    tardiness_sum = __stats_avx2_widen_add(tardiness_sum, tardiness);
+    max_tardiness = _mm256_max_epi32(max_tardiness, tardiness);
+
+    service_sum = __stats_avx2_widen_add(service_sum, service);
+    last_completion = _mm256_max_epi32(last_completion, completion);
+
+    if (c->dispatches != NULL) {
+      __m256i longest_wait = _mm256_loadu_si256((const __m256i *) (c->longest_wait + i));
+
+      dispatches_sum = __stats_avx2_widen_add(dispatches_sum, _mm256_loadu_si256((const __m256i *) (c->dispatches + i)));
+      preemptions_sum = __stats_avx2_widen_add(preemptions_sum, _mm256_loadu_si256((const __m256i *) (c->preemptions + i)));
+      longest_wait_sum = __stats_avx2_widen_add(longest_wait_sum, longest_wait);
+      max_longest_wait = _mm256_max_epi32(max_longest_wait, longest_wait);
+    }
+
+    int lanes[3][8];
+
+    _mm256_storeu_si256((__m256i *) lanes[0], turnaround);
+    _mm256_storeu_si256((__m256i *) lanes[1], wait);
+    _mm256_storeu_si256((__m256i *) lanes[2], response);
+
+    for (int j = 0; j < 8; j++) {
+      __stats_lane(stats, groups, count, c->group[i + j], lanes[0][j], lanes[1][j], lanes[2][j],
+          c->completion[i + j]);
+    }
+  }
+
+  if (i > from) {
+    stats->count += i - from;
+    stats->turnaround += __stats_avx2_sum(turnaround_sum);
+    stats->wait += __stats_avx2_sum(wait_sum);
+    stats->response += __stats_avx2_sum(response_sum);
+    stats->tardiness += __stats_avx2_sum(tardiness_sum);
+    stats->deadlines += deadlines;
+    stats->misses += misses;
+
+    __stats_least(&stats->min_turnaround, __stats_avx2_min(min_turnaround));
+    __stats_most(&stats->max_turnaround, __stats_avx2_max(max_turnaround));
+    __stats_least(&stats->min_wait, __stats_avx2_min(min_wait));
+    __stats_most(&stats->max_wait, __stats_avx2_max(max_wait));
+    __stats_least(&stats->min_response, __stats_avx2_min(min_response));
+    __stats_most(&stats->max_response, __stats_avx2_max(max_response));
+    __stats_most(&stats->max_tardiness, __stats_avx2_max(max_tardiness));
+
+    stats->service += __stats_avx2_sum(service_sum);
+    __stats_most(&stats->last_completion, __stats_avx2_max(last_completion));
+
+    stats->dispatches += __stats_avx2_sum(dispatches_sum);
+    stats->preemptions += __stats_avx2_sum(preemptions_sum);
+    stats->longest_wait += __stats_avx2_sum(longest_wait_sum);
+    __stats_most(&stats->max_longest_wait, __stats_avx2_max(max_longest_wait));
+  }
+
+  __stats_scalar(stats, groups, count, c, i, to);
+}
+
+// the sum of the lanes of 64 bit integers
+__attribute__((target("sse4.1")))
+static long long __stats_sse_sum(__m128i v) {
+  return _mm_cvtsi128_si64(v) + _mm_extract_epi64(v, 1);
+}
+
+// the least of the lanes of 32 bit integers
+__attribute__((target("sse4.1")))
+static int __stats_sse_min(__m128i m) {
+  m = _mm_min_epi32(m, _mm_shuffle_epi32(m, _MM_SHUFFLE(1, 0, 3, 2)));
+  m = _mm_min_epi32(m, _mm_shuffle_epi32(m, _MM_SHUFFLE(2, 3, 0, 1)));
+  return _mm_cvtsi128_si32(m);
+}
+
+// the most of the lanes of 32 bit integers
+__attribute__((target("sse4.1")))
+static int __stats_sse_max(__m128i m) {
+  m = _mm_max_epi32(m, _mm_shuffle_epi32(m, _MM_SHUFFLE(1, 0, 3, 2)));
+  m = _mm_max_epi32(m, _mm_shuffle_epi32(m, _MM_SHUFFLE(2, 3, 0, 1)));
+  return _mm_cvtsi128_si32(m);
+}
+
+// widens 4 lanes of 32 bit integers and adds them to 2 lanes of 64 bits
+__attribute__((target("sse4.1")))
+static inline __m128i __stats_sse_widen_add(__m128i sum, __m128i v) {
+  sum = _mm_add_epi64(sum, _mm_cvtepi32_epi64(v));
+  return _mm_add_epi64(sum, _mm_cvtepi32_epi64(_mm_shuffle_epi32(v, _MM_SHUFFLE(1, 0, 3, 2))));
+}
+
+__attribute__((target("sse4.1")))
+static void __stats_sse(Stats *stats, StatsGroup *groups, int count, const ProcessColumns *c, int from, int to) {
+  __m128i turnaround_sum = _mm_setzero_si128();
+  __m128i wait_sum = _mm_setzero_si128();
+  __m128i response_sum = _mm_setzero_si128();
+  __m128i tardiness_sum = _mm_setzero_si128();
+  __m128i service_sum = _mm_setzero_si128();
+  __m128i dispatches_sum = _mm_setzero_si128();
+  __m128i preemptions_sum = _mm_setzero_si128();
+  __m128i longest_wait_sum = _mm_setzero_si128();
+
+  __m128i min_turnaround = _mm_set1_epi32(INT_MAX);
+  __m128i max_turnaround = _mm_set1_epi32(INT_MIN);
+  __m128i min_wait = _mm_set1_epi32(INT_MAX);
+  __m128i max_wait = _mm_set1_epi32(INT_MIN);
+  __m128i min_response = _mm_set1_epi32(INT_MAX);
+  __m128i max_response = _mm_set1_epi32(INT_MIN);
+  __m128i max_tardiness = _mm_setzero_si128();
+  __m128i last_completion = _mm_set1_epi32(INT_MIN);
+  __m128i max_longest_wait = _mm_setzero_si128();
+
+  __m128i zero = _mm_setzero_si128();
+
+  long long deadlines = 0;
+  long long misses = 0;
+
+  int i = from;
+
+  for (; i + 4 <= to; i += 4) {
+    __m128i arrival = _mm_loadu_si128((const __m128i *) (c->arrival + i));
+    __m128i completion = _mm_loadu_si128((const __m128i *) (c->completion + i));
+    __m128i service = _mm_loadu_si128((const __m128i *) (c->service + i));
+    __m128i start = _mm_loadu_si128((const __m128i *) (c->start + i));
+    __m128i deadline = _mm_loadu_si128((const __m128i *) (c->deadline + i));
+
+    __m128i turnaround = _mm_sub_epi32(completion, arrival);
+    __m128i io = c->io == NULL ? _mm_setzero_si128() : _mm_loadu_si128((const __m128i *) (c->io + i));
+    __m128i wait = _mm_sub_epi32(_mm_sub_epi32(turnaround, service), io);
+    __m128i response = _mm_sub_epi32(start, arrival);
+
+    turnaround_sum = __stats_sse_widen_add(turnaround_sum, turnaround);
+    wait_sum = __stats_sse_widen_add(wait_sum, wait);
+    response_sum = __stats_sse_widen_add(response_sum, response);
+
+    min_turnaround = _mm_min_epi32(min_turnaround, turnaround);
+    max_turnaround = _mm_max_epi32(max_turnaround, turnaround);
+    min_wait = _mm_min_epi32(min_wait, wait);
+    max_wait = _mm_max_epi32(max_wait, wait);
+    min_response = _mm_min_epi32(min_response, response);
+    max_response = _mm_max_epi32(max_response, response);
+
+    // the lanes with a deadline, and of those the lanes that missed it
+    __m128i due = _mm_xor_si128(_mm_cmpeq_epi32(deadline, zero), _mm_set1_epi32(-1));
+    __m128i tardiness = _mm_sub_epi32(turnaround, deadline);
+    __m128i missed = _mm_and_si128(due, _mm_cmpgt_epi32(tardiness, zero));
+
+    tardiness = _mm_and_si128(tardiness, missed);
+
+    deadlines += __builtin_popcount(_mm_movemask_ps(_mm_castsi128_ps(due)));
+    misses += __builtin_popcount(_mm_movemask_ps(_mm_castsi128_ps(missed)));
+    tardiness_sum = __stats_sse_widen_add(tardiness_sum, tardiness);
+    max_tardiness = _mm_max_epi32(max_tardiness, tardiness);
+
+    service_sum = __stats_sse_widen_add(service_sum, service);
+    last_completion = _mm_max_epi32(last_completion, completion);
+
+    if (c->dispatches != NULL) {
+      __m128i longest_wait = _mm_loadu_si128((const __m128i *) (c->longest_wait + i));
+
+      dispatches_sum = __stats_sse_widen_add(dispatches_sum, _mm_loadu_si128((const __m128i *) (c->dispatches + i)));
+      preemptions_sum = __stats_sse_widen_add(preemptions_sum, _mm_loadu_si128((const __m128i *) (c->preemptions + i)));
+      longest_wait_sum = __stats_sse_widen_add(longest_wait_sum, longest_wait);
+      max_longest_wait = _mm_max_epi32(max_longest_wait, longest_wait);
+    }
+
+    int lanes[3][4];
+
+    _mm_storeu_si128((__m128i *) lanes[0], turnaround);
+    _mm_storeu_si128((__m128i *) lanes[1], wait);
+    _mm_storeu_si128((__m128i *) lanes[2], response);
+
+    for (int j = 0; j < 4; j++) {
+      __stats_lane(stats, groups, count, c->group[i + j], lanes[0][j], lanes[1][j], lanes[2][j],
+          c->completion[i + j]);
+    }
+  }
+
+  if (i > from) {
+    stats->count += i - from;
+    stats->turnaround += __stats_sse_sum(turnaround_sum);
+    stats->wait += __stats_sse_sum(wait_sum);
+    stats->response += __stats_sse_sum(response_sum);
+    stats->tardiness += __stats_sse_sum(tardiness_sum);
+    stats->deadlines += deadlines;
+    stats->misses += misses;
+
+    __stats_least(&stats->min_turnaround, __stats_sse_min(min_turnaround));
+    __stats_most(&stats->max_turnaround, __stats_sse_max(max_turnaround));
+    __stats_least(&stats->min_wait, __stats_sse_min(min_wait));
+    __stats_most(&stats->max_wait, __stats_sse_max(max_wait));
+    __stats_least(&stats->min_response, __stats_sse_min(min_response));
+    __stats_most(&stats->max_response, __stats_sse_max(max_response));
+    __stats_most(&stats->max_tardiness, __stats_sse_max(max_tardiness));
+
+    stats->service += __stats_sse_sum(service_sum);
+    __stats_most(&stats->last_completion, __stats_sse_max(last_completion));
+
+    stats->dispatches += __stats_sse_sum(dispatches_sum);
+    stats->preemptions += __stats_sse_sum(preemptions_sum);
+    stats->longest_wait += __stats_sse_sum(longest_wait_sum);
+    __stats_most(&stats->max_longest_wait, __stats_sse_max(max_longest_wait));
+  }
+
+  __stats_scalar(stats, groups, count, c, i, to);
+}
+
+#endif
+
+// the kernels from widest to narrowest
+static const struct {
+  const char *name;
+  StatsKernel kernel;
+  const char *feature;
+} __stats_kernels[] = {
+#ifdef STATS_X86
+  { "avx2", __stats_avx2, "avx2" },
+  { "sse4.1", __stats_sse, "sse4.1" },
+#endif
+  { "scalar", __stats_scalar, NULL },
+};
+
+#define STATS_KERNELS ((int) (sizeof(__stats_kernels) / sizeof(__stats_kernels[0])))
+
+// the selected kernel, -1 until the first use
+static int __stats_selected = -1;
+
+// tests if the cpu can run a kernel
+static int __stats_supported(int kernel) {
+  if (__stats_kernels[kernel].feature == NULL) {
+    return 1;
+  }
+
+#ifdef STATS_X86
+  __builtin_cpu_init();
+
+  // the builtin only takes string literals
+  if (strcmp(__stats_kernels[kernel].feature, "avx2") == 0) {
+    return __builtin_cpu_supports("avx2");
+  }
+  if (strcmp(__stats_kernels[kernel].feature, "sse4.1") == 0) {
+    return __builtin_cpu_supports("sse4.1");
+  }
+#endif
+
+  return 0;
+}
+
+// selects the widest kernel the cpu supports
+static int __stats_select() {
+  if (__stats_selected == -1) {
+    int kernel = 0;
+
+    while (!__stats_supported(kernel)) {
+      kernel++;
+    }
+
+    __stats_selected = kernel;
+  }
+
+  return __stats_selected;
+}
+
+int stats_accumulate(Stats *stats, StatsGroup *groups, int count, const ProcessColumns *columns) {
+  if (stats == NULL || columns == NULL || columns->size < 0 || (groups == NULL && count != 0)) {
+    return -1;
+  }
+
+  __stats_kernels[__stats_select()].kernel(stats, groups, count, columns, 0, columns->size);
+
+  return 0;
+}
+
+const char *stats_kernel() {
+  return __stats_kernels[__stats_select()].name;
+}
+
+int stats_set_kernel(const char *name) {
+  if (name == NULL) {
+    return -1;
+  }
+
+  for (int i = 0; i < STATS_KERNELS; i++) {
+    if (strcmp(__stats_kernels[i].name, name) == 0 && __stats_supported(i)) {
+      __stats_selected = i;
+      return 0;
+    }
+  }
+
+  return -1;
+}
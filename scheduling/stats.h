@@ -0,0 +1,111 @@
+#ifndef RYJEN_OS_STATS_H
+#define RYJEN_OS_STATS_H
+
+#include "process.h"
+
+// the number of turnaround time histogram buckets
+#define STATS_BUCKETS 32
+
+// the statistics of a share group
+typedef struct stats_group {
+  // completed processes
+  long long count;
+  // total turnaround time
+  long long turnaround;
+  // total wait time
+  long long wait;
+  // total response time
+  long long response;
+  // the earliest completion time
+  int first;
+} StatsGroup;
+
+// statistics of completed processes
+struct stats {
+  // completed processes
+  long long count;
+
+  // total turnaround time (completion - arrival)
+  long long turnaround;
+  // total wait time (turnaround - service - I/O)
+  long long wait;
+  // total response time (start - arrival)
+  long long response;
+
+  // the least and most turnaround time
+  int min_turnaround;
+  int max_turnaround;
+  // the least and most wait time
+  int min_wait;
+  int max_wait;
+  // the least and most response time
+  int min_response;
+  int max_response;
+
+  // processes with a deadline
+  long long deadlines;
+  // processes that completed after the deadline
+  long long misses;
+  // total ticks completed after the deadline
+  long long tardiness;
+  // most ticks completed after the deadline
+  int max_tardiness;
+
+  // turnaround times, bucket 0 is 0 and bucket b is 2^(b-1) to 2^b - 1
+  long long histogram[STATS_BUCKETS];
+
+  // total ticks of service
+  long long service;
+  // the latest completion time
+  int last_completion;
+
+  // total times the processes were switched to
+  long long dispatches;
+  // total premptions
+  long long preemptions;
+  // total of the longest wait of each process to run
+  long long longest_wait;
+  // the longest any process waited to run
+  int max_longest_wait;
+};
+
+/**
+ * Clears statistics to accumulate into
+ * @param Stats the statistics
+ */
+void stats_init(Stats *);
+
+/**
+ * Clears the statistics of groups to accumulate into
+ * @param StatsGroup the statistics of each group
+ * @param int the number of groups
+ */
+void stats_group_init(StatsGroup *, int);
+
+/**
+ * Accumulates the statistics of completed processes in one pass, using
+ * the widest vector kernel the cpu supports
+ * @param Stats the statistics to add to
+ * @param StatsGroup the statistics of each group to add to, indexed by
+ *        the group column plus one so the first is the processes without
+ *        a group (NULL to skip)
+ * @param int the number of groups, including the first
+ * @param ProcessColumns the columns of the completed processes
+ * @return 0 on success, -1 on error
+ */
+int stats_accumulate(Stats *, StatsGroup *, int, const ProcessColumns *);
+
+/**
+ * Gets the name of the kernel stats_accumulate uses
+ * @return "avx2", "sse4.1" or "scalar"
+ */
+const char *stats_kernel();
+
+/**
+ * Selects the kernel stats_accumulate uses, for testing and benchmarks
+ * @param char* "avx2", "sse4.1" or "scalar"
+ * @return 0 on success, -1 if the cpu does not support it
+ */
+int stats_set_kernel(const char *);
+
+#endif
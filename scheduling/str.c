@@ -5,6 +5,9 @@
 #include "process.h"
 #include "queue.h"
 #include "algorithm.h"
+#include "policy.h"
+#include "loader.h"
+#include "scheduler_loop.h"
 
 static Process *__str_get(void *arg) {
   if (arg == NULL) {
@@ -45,29 +48,64 @@ static int __str_put(Process *p, void *arg) {
   return queue_push_front(q, p);
 }
 
-int main() {
+// only an arrival can have less service time left, so run until then
+static int __str_slice(Process *p, void *arg) {
+  (void) arg;
 
-  // data is just a queue
+  return process_current_service_time(p);
+}
+
+SCHEDULER_LOOP(__str_loop, scheduler_loop_queue_arrive, scheduler_loop_queue_ready, __str_get, __str_put, __str_slice)
+
+// destroys the queue with the algorithm
+static void __str_delete(void *arg) {
+  delete_queue((Queue *) arg);
+}
+
+Algorithm *new_str_algorithm() {
   Queue *queue = new_queue();
 
-  // create the algorithm
   Algorithm *algo = new_queue_algorithm(queue, __str_get, __str_put);
 
+  algorithm_set_on_delete(algo, __str_delete);
+
+  algorithm_set_on_slice(algo, __str_slice);
+
+  algorithm_set_loop(algo, __str_loop);
+
+  return algo;
+}
+
+#ifndef POLICY_LIBRARY
+
+int main(int argc, char *argv[]) {
+
+  // the workload file and switch cost, taken out of the arguments
+  LoaderOptions options;
+
+  if (loader_options(&argc, argv, &options)) {
+    puts("invalid argument");
+    return 1;
+  }
+
+  // create the algorithm
+  Algorithm *algo = new_str_algorithm();
+
   // create the scheduler
   Scheduler *sched = new_scheduler(algo);
 
-  // read the processes
-  scheduler_read_processes(sched);
+  // set the switch cost and read the processes
+  if (loader_setup(sched, &options)) {
+    delete_scheduler(sched);
+    return 1;
+  }
 
   // run
   int result = scheduler_run(sched);
 
   delete_scheduler(sched);
 
-  delete_queue(queue);
-
   return result;
 }
 
-
-
+#endif
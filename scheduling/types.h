@@ -1,6 +1,8 @@
 #ifndef RYJEN_OS_TYPES_H
 #define RYJEN_OS_TYPES_H
 
+#include <stdint.h>
+
 // A scheduler type
 typedef struct scheduler Scheduler;
 
@@ -10,8 +12,29 @@ typedef struct queue Queue;
 // A process type
 typedef struct process Process;
 
+// A table of processes type
+typedef struct process_table ProcessTable;
+
+// A process id, the index in its table
+typedef uint32_t ProcessId;
+
+// A statistics type
+typedef struct stats Stats;
+
+// A run profile type
+typedef struct profile Profile;
+
 // An algorithm type
 typedef struct algorithm Algorithm;
 
+// An executor of live tasks type
+typedef struct executor Executor;
+
+// A coroutine type
+typedef struct coroutine Coroutine;
+
+// A pool of coroutine stacks type
+typedef struct coroutine_pool CoroutinePool;
+
 #endif
 
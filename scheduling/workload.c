@@ -0,0 +1,421 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <limits.h>
+
+#include "types.h"
+#include "workload.h"
+#include "process.h"
+
+_Static_assert(sizeof(int) == sizeof(int32_t), "workload columns are read as int");
+_Static_assert(sizeof(WorkloadHeader) == 64, "workload header is 64 bytes");
+
+// rounds a size up to the section alignment
+#define WORKLOAD_ALIGN(size) (((size) + 7) & ~(uint64_t) 7)
+
+// the byte offsets of the sections of a workload
+typedef struct workload_layout {
+  // the columns
+  uint64_t columns;
+  // the name offsets and bytes
+  uint64_t name_offsets;
+  uint64_t name_bytes;
+  // the group offsets and bytes
+  uint64_t group_offsets;
+  uint64_t group_bytes;
+  // the end of the workload
+  uint64_t size;
+} WorkloadLayout;
+
+// the number of int32 columns of a header
+static int __workload_columns(uint32_t flags) {
+  return 3 + !!(flags & WORKLOAD_PRIORITY) + !!(flags & WORKLOAD_DEADLINE) + !!(flags & WORKLOAD_GROUP);
+}
+
+// finds the sections of a header, -1 if they do not fit in 64 bits
+static int __workload_layout(const WorkloadHeader *h, WorkloadLayout *layout) {
+  // bounds every count so the sums below can not overflow
+  if (h->count > INT_MAX || h->names > INT_MAX || h->groups > INT_MAX
+      || h->name_bytes > UINT64_MAX / 4 || h->group_bytes > UINT64_MAX / 4) {
+    return -1;
+  }
+
+  layout->columns = sizeof(WorkloadHeader);
+  layout->name_offsets = layout->columns + WORKLOAD_ALIGN(h->count * 4 * __workload_columns(h->flags));
+  layout->name_bytes = layout->name_offsets + h->names * 8;
+  layout->group_offsets = layout->name_bytes + WORKLOAD_ALIGN(h->name_bytes);
+  layout->group_bytes = layout->group_offsets + h->groups * 8;
+  layout->size = layout->group_bytes + WORKLOAD_ALIGN(h->group_bytes);
+  return 0;
+}
+
+int workload_is_binary(const void *data, size_t size) {
+  return data != NULL && size >= sizeof(WorkloadHeader) && memcmp(data, WORKLOAD_MAGIC, 8) == 0;
+}
+
+// checks the ids of a column are below a count or a none value
+static int __workload_check_ids(const uint32_t *ids, int count, uint32_t limit, uint32_t none) {
+  for (int i = 0; i < count; i++) {
+    if (ids[i] >= limit && ids[i] != none) {
+      return -1;
+    }
+  }
+
+  return 0;
+}
+
+// checks the strings of a table end within its bytes
+static int __workload_check_strings(const uint64_t *offsets, int count, const char *bytes, uint64_t size) {
+  if (count > 0 && (size == 0 || bytes[size - 1] != '\0')) {
+    return -1;
+  }
+
+  for (int i = 0; i < count; i++) {
+    if (offsets[i] >= size) {
+      return -1;
+    }
+  }
+
+  return 0;
+}
+
+int workload_view(const void *data, size_t size, Workload *w) {
+  if (!workload_is_binary(data, size) || w == NULL || ((uintptr_t) data & 7) != 0) {
+    return -1;
+  }
+
+  const WorkloadHeader *h = (const WorkloadHeader *) data;
+  const char *bytes = (const char *) data;
+
+  WorkloadLayout layout;
+
+  if (h->byte_order != WORKLOAD_BYTE_ORDER || h->reserved != 0
+      || (h->flags & ~(uint32_t) (WORKLOAD_PRIORITY | WORKLOAD_DEADLINE | WORKLOAD_GROUP))
+      || __workload_layout(h, &layout) || layout.size > size) {
+    return -1;
+  }
+
+  const int *column = (const int *) (bytes + layout.columns);
+
+  w->count = (int) h->count;
+  w->arrival = column;
+  w->service = column += w->count;
+  w->priority = h->flags & WORKLOAD_PRIORITY ? column += w->count : NULL;
+  w->deadline = h->flags & WORKLOAD_DEADLINE ? column += w->count : NULL;
+  w->group = h->flags & WORKLOAD_GROUP ? column += w->count : NULL;
+  w->name = (const uint32_t *) (column + w->count);
+
+  w->names = (int) h->names;
+  w->name_offsets = (const uint64_t *) (bytes + layout.name_offsets);
+  w->name_bytes = bytes + layout.name_bytes;
+  w->name_size = (size_t) h->name_bytes;
+
+  w->groups = (int) h->groups;
+  w->group_offsets = (const uint64_t *) (bytes + layout.group_offsets);
+  w->group_bytes = bytes + layout.group_bytes;
+  w->group_size = (size_t) h->group_bytes;
+
+  if (__workload_check_strings(w->name_offsets, w->names, w->name_bytes, h->name_bytes)
+      || __workload_check_strings(w->group_offsets, w->groups, w->group_bytes, h->group_bytes)
+      || __workload_check_ids(w->name, w->count, (uint32_t) w->names, INTERN_NONE)
+      || (w->group && __workload_check_ids((const uint32_t *) w->group, w->count, (uint32_t) w->groups, UINT32_MAX))) {
+    return -1;
+  }
+
+  for (int i = 0; i < w->count; i++) {
+    if ((w->priority && (w->priority[i] < 0 || w->priority[i] >= PROCESS_PRIORITIES))
+        || (w->deadline && w->deadline[i] < 0)) {
+      return -1;
+    }
+  }
+
+  return 0;
+}
+
+// maps the ids of a column through a table, a none value maps to itself
+static void *__workload_remap(const uint32_t *ids, int count, const uint32_t *map, uint32_t none) {
+  uint32_t *column = malloc((size_t) (count > 0 ? count : 1) * sizeof(uint32_t));
+
+  if (column == NULL) {
+    abort();
+  }
+
+  for (int i = 0; i < count; i++) {
+    column[i] = ids[i] == none ? none : map[ids[i]];
+  }
+
+  return column;
+}
+
+int workload_append(ProcessTable *t, const Workload *w) {
+  if (t == NULL || w == NULL) {
+    return -1;
+  }
+
+  ProcessBatch batch = {
+    .arrival = w->arrival,
+    .service = w->service,
+    .priority = w->priority,
+    .deadline = w->deadline,
+    .group = w->group,
+    .name = w->name,
+    .size = w->count,
+  };
+
+  // the ids in the table of the names and groups, when not the same
+  uint32_t *names = NULL;
+  uint32_t *groups = NULL;
+
+  // the names of an empty table keep their ids, copied in one block
+  if (process_table_names(t) == 0) {
+    if (process_table_load_names(t, w->name_bytes, w->name_size, w->name_offsets, w->names)) {
+      return -1;
+    }
+  } else {
+    uint32_t *map = malloc((size_t) (w->names > 0 ? w->names : 1) * sizeof(uint32_t));
+
+    if (map == NULL) {
+      abort();
+    }
+
+    for (int i = 0; i < w->names; i++) {
+      map[i] = process_table_name_id(t, w->name_bytes + w->name_offsets[i]);
+    }
+
+    names = __workload_remap(w->name, w->count, map, INTERN_NONE);
+    batch.name = names;
+
+    free(map);
+  }
+
+  // groups are few, so intern them and map the column when the ids differ
+  if (w->group != NULL) {
+    uint32_t *map = malloc((size_t) (w->groups > 0 ? w->groups : 1) * sizeof(uint32_t));
+    int same = 1;
+
+    if (map == NULL) {
+      abort();
+    }
+
+    for (int i = 0; i < w->groups; i++) {
+      int id = process_table_group_id(t, w->group_bytes + w->group_offsets[i]);
+
+      if (id == -1) {
+        free(map);
+        free(names);
+        return -1;
+      }
+
+      map[i] = (uint32_t) id;
+      same &= map[i] == (uint32_t) i;
+    }
+
+    if (!same) {
+      groups = __workload_remap((const uint32_t *) w->group, w->count, map, UINT32_MAX);
+      batch.group = (const int *) groups;
+    }
+
+    free(map);
+  }
+
+  int first = process_table_append(t, &batch);
+
+  free(names);
+  free(groups);
+
+  return first;
+}
+
+// writes zeros up to the section alignment of a size
+static int __workload_pad(FILE *out, uint64_t size) {
+  static const char zeros[8] = {0};
+
+  uint64_t pad = WORKLOAD_ALIGN(size) - size;
+
+  return pad > 0 && fwrite(zeros, 1, pad, out) != pad ? -1 : 0;
+}
+
+// writes a table of strings: the offsets then the terminated strings
+static int __workload_put_strings(FILE *out, const char *(*get)(ProcessTable *, int), ProcessTable *t, int count) {
+  uint64_t offset = 0;
+
+  for (int i = 0; i < count; i++) {
+    if (fwrite(&offset, sizeof(offset), 1, out) != 1) {
+      return -1;
+    }
+    offset += strlen(get(t, i)) + 1;
+  }
+
+  for (int i = 0; i < count; i++) {
+    const char *s = get(t, i);
+    size_t size = strlen(s) + 1;
+
+    if (fwrite(s, 1, size, out) != size) {
+      return -1;
+    }
+  }
+
+  return __workload_pad(out, offset);
+}
+
+static const char *__workload_name(ProcessTable *t, int i) {
+  return process_table_name(t, (InternId) i);
+}
+
+// the bytes of a table of strings
+static uint64_t __workload_bytes(const char *(*get)(ProcessTable *, int), ProcessTable *t, int count) {
+  uint64_t size = 0;
+
+  for (int i = 0; i < count; i++) {
+    size += strlen(get(t, i)) + 1;
+  }
+
+  return size;
+}
+
+int workload_write(ProcessTable *t, FILE *out) {
+  ProcessColumns c;
+
+  if (t == NULL || out == NULL || process_table_columns(t, &c)) {
+    return -1;
+  }
+
+  // the format has no column for I/O bursts
+  for (int i = 0; i < c.size; i++) {
+    if (process_io_bursts(process_table_get(t, (ProcessId) i)) > 0) {
+      return -1;
+    }
+  }
+
+  WorkloadHeader h;
+
+  memset(&h, 0, sizeof(h));
+  memcpy(h.magic, WORKLOAD_MAGIC, 8);
+
+  h.byte_order = WORKLOAD_BYTE_ORDER;
+  h.count = (uint64_t) c.size;
+  h.names = (uint64_t) process_table_names(t);
+  h.name_bytes = __workload_bytes(__workload_name, t, (int) h.names);
+  h.groups = (uint64_t) process_table_groups(t);
+  h.group_bytes = __workload_bytes(process_table_group, t, (int) h.groups);
+
+  // only the optional columns that differ from the defaults
+  for (int i = 0; i < c.size; i++) {
+    h.flags |= c.priority[i] != PROCESS_DEFAULT_PRIORITY ? WORKLOAD_PRIORITY : 0;
+    h.flags |= c.deadline[i] != 0 ? WORKLOAD_DEADLINE : 0;
+    h.flags |= c.group[i] != -1 ? WORKLOAD_GROUP : 0;
+  }
+
+  size_t n = (size_t) c.size;
+
+  if (fwrite(&h, sizeof(h), 1, out) != 1
+      || fwrite(c.arrival, sizeof(int), n, out) != n
+      || fwrite(c.service, sizeof(int), n, out) != n
+      || ((h.flags & WORKLOAD_PRIORITY) && fwrite(c.priority, sizeof(int), n, out) != n)
+      || ((h.flags & WORKLOAD_DEADLINE) && fwrite(c.deadline, sizeof(int), n, out) != n)
+      || ((h.flags & WORKLOAD_GROUP) && fwrite(c.group, sizeof(int), n, out) != n)
+      || fwrite(c.name, sizeof(InternId), n, out) != n
+      || __workload_pad(out, h.count * 4 * __workload_columns(h.flags))
+      || __workload_put_strings(out, __workload_name, t, (int) h.names)
+      || __workload_put_strings(out, process_table_group, t, (int) h.groups)) {
+    return -1;
+  }
+
+  return 0;
+}
+
+// writes a table of strings already laid out: the offsets then the bytes
+static int __workload_put_table(FILE *out, const uint64_t *offsets, int count, const char *bytes, size_t size) {
+  return (count > 0 && fwrite(offsets, sizeof(uint64_t), (size_t) count, out) != (size_t) count)
+      || (size > 0 && fwrite(bytes, 1, size, out) != size)
+      || __workload_pad(out, size) ? -1 : 0;
+}
+
+int workload_put(const Workload *w, FILE *out) {
+  if (w == NULL || out == NULL || w->count < 0 || w->arrival == NULL || w->service == NULL || w->name == NULL) {
+    return -1;
+  }
+
+  WorkloadHeader h;
+
+  memset(&h, 0, sizeof(h));
+  memcpy(h.magic, WORKLOAD_MAGIC, 8);
+
+  h.byte_order = WORKLOAD_BYTE_ORDER;
+  h.flags = (w->priority ? WORKLOAD_PRIORITY : 0) | (w->deadline ? WORKLOAD_DEADLINE : 0)
+      | (w->group ? WORKLOAD_GROUP : 0);
+  h.count = (uint64_t) w->count;
+  h.names = (uint64_t) w->names;
+  h.name_bytes = (uint64_t) w->name_size;
+  h.groups = (uint64_t) w->groups;
+  h.group_bytes = (uint64_t) w->group_size;
+
+  size_t n = (size_t) w->count;
+
+  if (fwrite(&h, sizeof(h), 1, out) != 1
+      || (n > 0 && fwrite(w->arrival, sizeof(int), n, out) != n)
+      || (n > 0 && fwrite(w->service, sizeof(int), n, out) != n)
+      || (n > 0 && w->priority && fwrite(w->priority, sizeof(int), n, out) != n)
+      || (n > 0 && w->deadline && fwrite(w->deadline, sizeof(int), n, out) != n)
+      || (n > 0 && w->group && fwrite(w->group, sizeof(int), n, out) != n)
+      || (n > 0 && fwrite(w->name, sizeof(uint32_t), n, out) != n)
+      || __workload_pad(out, h.count * 4 * __workload_columns(h.flags))
+      || __workload_put_table(out, w->name_offsets, w->names, w->name_bytes, w->name_size)
+      || __workload_put_table(out, w->group_offsets, w->groups, w->group_bytes, w->group_size)) {
+    return -1;
+  }
+
+  return 0;
+}
+
+// writes the I/O bursts of a process like 3:5,4:2 and ends the line
+static int __workload_put_bursts(FILE *out, Process *p) {
+  for (int i = 0; i < process_io_bursts(p); i++) {
+    int cpu, io;
+
+    if (process_io_burst_at(p, i, &cpu, &io) || fprintf(out, i == 0 ? "%d:%d" : ",%d:%d", cpu, io) < 0) {
+      return -1;
+    }
+  }
+
+  return fputc('\n', out) == EOF ? -1 : 0;
+}
+
+int workload_write_text(ProcessTable *t, FILE *out) {
+  ProcessColumns c;
+
+  if (t == NULL || out == NULL || process_table_columns(t, &c)) {
+    return -1;
+  }
+
+  for (int i = 0; i < c.size; i++) {
+    const char *name = process_table_name(t, c.name[i]);
+    int written;
+
+    Process *p = process_table_get(t, (ProcessId) i);
+
+    // the optional columns only when they differ from the defaults
+    if (process_io_bursts(p) > 0) {
+      written = fprintf(out, "%s %d %d %d %d %s ", name ? name : "-", c.arrival[i], c.service[i],
+          c.priority[i], c.deadline[i], c.group[i] != -1 ? process_table_group(t, c.group[i]) : "-");
+
+      written = written < 0 ? written : __workload_put_bursts(out, p);
+    } else if (c.group[i] != -1) {
+      written = fprintf(out, "%s %d %d %d %d %s\n", name ? name : "-", c.arrival[i], c.service[i],
+          c.priority[i], c.deadline[i], process_table_group(t, c.group[i]));
+    } else if (c.deadline[i] != 0) {
+      written = fprintf(out, "%s %d %d %d %d\n", name ? name : "-", c.arrival[i], c.service[i],
+          c.priority[i], c.deadline[i]);
+    } else if (c.priority[i] != PROCESS_DEFAULT_PRIORITY) {
+      written = fprintf(out, "%s %d %d %d\n", name ? name : "-", c.arrival[i], c.service[i], c.priority[i]);
+    } else {
+      written = fprintf(out, "%s %d %d\n", name ? name : "-", c.arrival[i], c.service[i]);
+    }
+
+    if (written < 0) {
+      return -1;
+    }
+  }
+
+  return 0;
+}
@@ -0,0 +1,134 @@
+#ifndef RYJEN_OS_WORKLOAD_H
+#define RYJEN_OS_WORKLOAD_H
+
+#include <stdio.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "types.h"
+
+// the first bytes of a binary workload
+#define WORKLOAD_MAGIC "RYJENWL1"
+
+// the byte order mark, as written by the machine that wrote the workload
+#define WORKLOAD_BYTE_ORDER 0x01020304u
+
+// the optional columns of a binary workload
+#define WORKLOAD_PRIORITY (1 << 0)
+#define WORKLOAD_DEADLINE (1 << 1)
+#define WORKLOAD_GROUP    (1 << 2)
+
+/*
+ * A binary workload is the header followed by sections, each starting on
+ * an 8 byte boundary:
+ *
+ * 1. the int32 columns, count values each: arrival, service, then priority,
+ *    deadline and group (-1 for none) when flagged, then the name ids
+ *    (UINT32_MAX for none)
+ * 2. the uint64 offsets of the names, then the terminated names
+ * 3. the uint64 offsets of the groups, then the terminated groups
+ */
+typedef struct workload_header {
+  // WORKLOAD_MAGIC, not terminated
+  char magic[8];
+  // WORKLOAD_BYTE_ORDER
+  uint32_t byte_order;
+  // the optional columns present
+  uint32_t flags;
+  // the number of processes
+  uint64_t count;
+  // the number of distinct names
+  uint64_t names;
+  // the bytes of the names
+  uint64_t name_bytes;
+  // the number of distinct groups
+  uint64_t groups;
+  // the bytes of the groups
+  uint64_t group_bytes;
+  // zero
+  uint64_t reserved;
+} WorkloadHeader;
+
+// a binary workload in memory, pointing into its bytes
+typedef struct workload {
+  // the number of processes
+  int count;
+  // the columns, NULL when not present
+  const int *arrival;
+  const int *service;
+  const int *priority;
+  const int *deadline;
+  const int *group;
+  const uint32_t *name;
+  // the number of distinct names
+  int names;
+  // the offset of each name in the name bytes
+  const uint64_t *name_offsets;
+  const char *name_bytes;
+  // the bytes of the names
+  size_t name_size;
+  // the number of distinct groups
+  int groups;
+  // the offset of each group in the group bytes
+  const uint64_t *group_offsets;
+  const char *group_bytes;
+  // the bytes of the groups
+  size_t group_size;
+} Workload;
+
+/**
+ * Tests whether bytes start with a binary workload header
+ * @param void* the bytes
+ * @param size_t the number of bytes
+ * @return 1 if they do, 0 otherwise
+ */
+int workload_is_binary(const void *, size_t);
+
+/**
+ * Reads a binary workload in place, pointing its columns into the bytes
+ * NOTE: O(1), the bytes must be 8 byte aligned, as a mapped file is
+ * @param void* the bytes
+ * @param size_t the number of bytes
+ * @param Workload set to the workload
+ * @return 0 on success, -1 if the bytes are not a valid workload
+ */
+int workload_view(const void *, size_t, Workload *);
+
+/**
+ * Adds the processes of a workload to a table at once, copying the
+ * columns rather than creating the processes one at a time.  The names
+ * are copied in one block when the table has none yet.
+ * @param ProcessTable the table instance
+ * @param Workload the workload
+ * @return the id of the first process added, -1 on error
+ */
+int workload_append(ProcessTable *, const Workload *);
+
+/**
+ * Writes the processes of a table as a binary workload
+ * @param ProcessTable the table instance
+ * @param FILE the stream to write to
+ * @return 0 on success, -1 on error or if a process has I/O bursts,
+ *         which the format does not store
+ */
+int workload_write(ProcessTable *, FILE *);
+
+/**
+ * Writes the columns and strings of a workload in memory as a binary
+ * workload, without a table to intern the names in first
+ * @param Workload the workload, its optional columns NULL when not present
+ * @param FILE the stream to write to
+ * @return 0 on success, -1 on error
+ */
+int workload_put(const Workload *, FILE *);
+
+/**
+ * Writes the processes of a table in the text format read by
+ * scheduler_read_processes
+ * @param ProcessTable the table instance
+ * @param FILE the stream to write to
+ * @return 0 on success, -1 on error
+ */
+int workload_write_text(ProcessTable *, FILE *);
+
+#endif